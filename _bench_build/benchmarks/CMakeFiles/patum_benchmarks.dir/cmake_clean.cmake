@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/patum_benchmarks.dir/source/main.cpp.o"
+  "CMakeFiles/patum_benchmarks.dir/source/main.cpp.o.d"
+  "CMakeFiles/patum_benchmarks.dir/source/matching.cpp.o"
+  "CMakeFiles/patum_benchmarks.dir/source/matching.cpp.o.d"
+  "patum_benchmarks"
+  "patum_benchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/patum_benchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,20 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/benchmarks/debug/matching_debug.cpp" "benchmarks/CMakeFiles/patum_benchmarks_debug.dir/debug/matching_debug.cpp.o" "gcc" "benchmarks/CMakeFiles/patum_benchmarks_debug.dir/debug/matching_debug.cpp.o.d"
+  "/root/repo/benchmarks/source/main.cpp" "benchmarks/CMakeFiles/patum_benchmarks_debug.dir/source/main.cpp.o" "gcc" "benchmarks/CMakeFiles/patum_benchmarks_debug.dir/source/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/patum_benchmarks_debug.dir/debug/matching_debug.cpp.o"
+  "CMakeFiles/patum_benchmarks_debug.dir/debug/matching_debug.cpp.o.d"
+  "CMakeFiles/patum_benchmarks_debug.dir/source/main.cpp.o"
+  "CMakeFiles/patum_benchmarks_debug.dir/source/main.cpp.o.d"
+  "patum_benchmarks_debug"
+  "patum_benchmarks_debug.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/patum_benchmarks_debug.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
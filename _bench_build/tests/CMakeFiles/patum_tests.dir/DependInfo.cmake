@@ -0,0 +1,44 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/externals/re2-2023.3.1/re2/bitmap256.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitmap256.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitmap256.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/bitstate.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitstate.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitstate.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/compile.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/compile.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/compile.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/dfa.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/dfa.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/dfa.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/filtered_re2.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/filtered_re2.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/filtered_re2.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/mimics_pcre.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/mimics_pcre.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/mimics_pcre.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/nfa.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/nfa.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/nfa.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/onepass.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/onepass.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/onepass.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/parse.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/parse.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/parse.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/perl_groups.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/perl_groups.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/perl_groups.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/prefilter.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/prefilter_tree.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter_tree.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter_tree.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/prog.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prog.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prog.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/re2.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/re2.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/re2.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/regexp.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/regexp.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/regexp.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/set.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/set.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/set.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/simplify.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/simplify.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/simplify.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/stringpiece.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/stringpiece.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/stringpiece.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/tostring.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/tostring.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/tostring.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/unicode_casefold.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_casefold.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_casefold.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/re2/unicode_groups.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_groups.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_groups.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/util/pcre.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/pcre.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/pcre.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/util/rune.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/rune.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/rune.cc.o.d"
+  "/root/repo/tests/externals/re2-2023.3.1/util/strutil.cc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/strutil.cc.o" "gcc" "tests/CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/strutil.cc.o.d"
+  "/root/repo/tests/source/main.cpp" "tests/CMakeFiles/patum_tests.dir/source/main.cpp.o" "gcc" "tests/CMakeFiles/patum_tests.dir/source/main.cpp.o.d"
+  "/root/repo/tests/source/test_patum.cpp" "tests/CMakeFiles/patum_tests.dir/source/test_patum.cpp.o" "gcc" "tests/CMakeFiles/patum_tests.dir/source/test_patum.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,61 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitmap256.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitmap256.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitstate.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/bitstate.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/compile.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/compile.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/dfa.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/dfa.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/filtered_re2.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/filtered_re2.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/mimics_pcre.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/mimics_pcre.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/nfa.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/nfa.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/onepass.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/onepass.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/parse.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/parse.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/perl_groups.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/perl_groups.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter_tree.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prefilter_tree.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prog.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/prog.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/re2.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/re2.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/regexp.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/regexp.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/set.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/set.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/simplify.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/simplify.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/stringpiece.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/stringpiece.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/tostring.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/tostring.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_casefold.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_casefold.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_groups.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/re2/unicode_groups.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/pcre.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/pcre.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/rune.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/rune.cc.o.d"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/strutil.cc.o"
+  "CMakeFiles/patum_tests.dir/externals/re2-2023.3.1/util/strutil.cc.o.d"
+  "CMakeFiles/patum_tests.dir/source/main.cpp.o"
+  "CMakeFiles/patum_tests.dir/source/main.cpp.o.d"
+  "CMakeFiles/patum_tests.dir/source/test_patum.cpp.o"
+  "CMakeFiles/patum_tests.dir/source/test_patum.cpp.o.d"
+  "patum_tests"
+  "patum_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/patum_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,136 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+// Built without optimizations (see benchmarks/CMakeLists.txt), to track how much slower than a switch the matches
+// of a debug build are
+
+#include <nanobench.h>
+#include <snitch_all.hpp>
+
+#include <patum.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//==================================================================================================
+
+namespace nanobench = ankerl::nanobench;
+
+namespace {
+
+std::vector<int> generate_debug_data(int min, int max, std::size_t size)
+{
+    std::random_device dev;
+    std::uniform_int_distribution<int> dist(min, max);
+    nanobench::Rng gen(dev());
+
+    std::vector<int> data(size);
+
+    std::generate(data.begin(), data.end(), [&] { return dist(gen); });
+
+    return data;
+}
+
+int switch_classify(int x)
+{
+    switch (x)
+    {
+    case 0: return 1;
+    case 1: return 2;
+    case 2: return 2;
+    case 3: return 3;
+    case 4: return 3;
+    case 5: return 3;
+    default: return x < 0 ? 4 : 0;
+    }
+}
+
+int if_chain_classify(int x)
+{
+    if (x < 0) return 4;
+    if (x == 0) return 1;
+    if (x < 3) return 2;
+    if (x < 6) return 3;
+    return 0;
+}
+
+int patum_literals(int x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(lit<0>)          = 1,
+        pattern(lit_range<1, 2>) = 2,
+        pattern(lit_range<3, 5>) = 3,
+        pattern(_x < 0)          = 4,
+        pattern(_)               = 0
+    ).value_or(-1);
+}
+
+int patum_predicates(int x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(_x < 0)            = 4,
+        pattern(_x == 0)           = 1,
+        pattern(_x < 3)            = 2,
+        pattern(_x >= 3 && _x < 6) = 3,
+        pattern(_)                 = 0
+    ).value_or(-1);
+}
+
+int patum_handlers(int x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(_x < 0)            = [](int v) { return -v; },
+        pattern(_x < 3)            = [](int v) { return v + 1; },
+        pattern(_x >= 3 && _x < 6) = [](int v) { return v * 2; },
+        pattern(_)                 = [](int) { return 0; }
+    ).value_or(-1);
+}
+
+} // namespace
+
+TEST_CASE("debug_build", "[debug]")
+{
+    auto b = nanobench::Bench()
+        .title("Unoptimized Build")
+        .warmup(100)
+        .minEpochIterations(1000000)
+        .relative(true);
+
+    const auto data = generate_debug_data(-2, 8, 100000);
+    std::size_t counter = 0;
+
+    const auto run = [&](const char* name, int (*function)(int))
+    {
+        counter = 0;
+        b.run(name, [&]
+        {
+            const auto x = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = function(x);
+
+            nanobench::doNotOptimizeAway(result);
+        });
+    };
+
+    run("switch", switch_classify);
+    run("if chain", if_chain_classify);
+    run("patum literals", patum_literals);
+    run("patum predicates", patum_predicates);
+    run("patum handlers", patum_handlers);
+}
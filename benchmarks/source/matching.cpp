@@ -10,11 +10,25 @@
 #include <snitch_all.hpp>
 
 #include <patum.h>
+#include <patum/rules.h>
 
 #include <cstdint>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <optional>
 #include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
 #include <vector>
 
 //==================================================================================================
@@ -117,6 +131,19 @@ TEST_CASE("matching_performance", "[base]")
     const auto data = generate_data(0, 8, 100000);
     std::size_t counter = 0;
 
+    const auto compiled = []
+    {
+        using namespace ptm;
+
+        return compile_match
+        (
+            pattern(1) = 1,
+            pattern(2) = 20,
+            pattern(3) = 300,
+            pattern(4) = 4000
+        );
+    }();
+
     counter = 0;
     b.run("patum", [&]
     {
@@ -136,6 +163,17 @@ TEST_CASE("matching_performance", "[base]")
         nanobench::doNotOptimizeAway(result);
     });
 
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled(x).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
     counter = 0;
     b.run("if", [&]
     {
@@ -183,109 +221,174 @@ TEST_CASE("matching_performance", "[base]")
 
 //==================================================================================================
 
-TEST_CASE("tuple_destructuring", "[tuple]")
+namespace {
+
+#define BENCH_CASE(n) case (n): result = (n) * 7 + 1; break;
+#define BENCH_CASE8(n) BENCH_CASE(n) BENCH_CASE(n + 1) BENCH_CASE(n + 2) BENCH_CASE(n + 3) \
+    BENCH_CASE(n + 4) BENCH_CASE(n + 5) BENCH_CASE(n + 6) BENCH_CASE(n + 7)
+#define BENCH_CASE64(n) BENCH_CASE8(n) BENCH_CASE8(n + 8) BENCH_CASE8(n + 16) BENCH_CASE8(n + 24) \
+    BENCH_CASE8(n + 32) BENCH_CASE8(n + 40) BENCH_CASE8(n + 48) BENCH_CASE8(n + 56)
+#define BENCH_CASE512(n) BENCH_CASE64(n) BENCH_CASE64(n + 64) BENCH_CASE64(n + 128) BENCH_CASE64(n + 192) \
+    BENCH_CASE64(n + 256) BENCH_CASE64(n + 320) BENCH_CASE64(n + 384) BENCH_CASE64(n + 448)
+
+int switch_4(int x)
+{
+    int result;
+
+    switch (x)
+    {
+        BENCH_CASE(0) BENCH_CASE(1) BENCH_CASE(2) BENCH_CASE(3)
+        default: result = 0; break;
+    }
+
+    return result;
+}
+
+int switch_64(int x)
+{
+    int result;
+
+    switch (x)
+    {
+        BENCH_CASE64(0)
+        default: result = 0; break;
+    }
+
+    return result;
+}
+
+int switch_512(int x)
+{
+    int result;
+
+    switch (x)
+    {
+        BENCH_CASE512(0)
+        default: result = 0; break;
+    }
+
+    return result;
+}
+
+#undef BENCH_CASE512
+#undef BENCH_CASE64
+#undef BENCH_CASE8
+#undef BENCH_CASE
+
+template <std::size_t... I>
+int patum_values_switch(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(static_cast<int>(I)) = static_cast<int>(I) * 7 + 1)...,
+        pattern(_) = 0
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int compiled_values_switch(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    static const auto compiled = compile_match
+    (
+        (pattern(static_cast<int>(I)) = static_cast<int>(I) * 7 + 1)...,
+        pattern(_) = 0
+    );
+
+    return compiled(x).value_or(0);
+}
+
+template <std::size_t... I>
+int patum_literals_switch(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(lit<static_cast<int>(I)>) = static_cast<int>(I) * 7 + 1)...,
+        pattern(_) = 0
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int patum_constants_switch(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(lit<static_cast<int>(I)>) = val<static_cast<int>(I) * 7 + 1>)...,
+        pattern(_) = val<0>
+    ).value_or(0);
+}
+
+template <std::size_t N, class F>
+void run_literal_switch(const std::string& title, F&& switch_function)
 {
     auto b = nanobench::Bench()
-        .title("Tuple Destructuring")
+        .title(title)
         .warmup(100)
         .minEpochIterations(8000000)
         .performanceCounters(true)
         .relative(true);
 
-    const auto data = generate_tuple_data(0, 8, 100000);
+    const auto data = generate_data(-1, static_cast<int>(N + N / 8), 100000);
     std::size_t counter = 0;
 
     counter = 0;
     b.run("patum", [&]
     {
-        using namespace ptm;
-
-        const auto& x = data[counter];
+        const auto x = data[counter];
         counter = (++counter) % data.size();
 
-        auto result = match(x)
-        (
-            pattern(ds(1, _, 1)) = 1,
-            pattern(ds(2, _, 2)) = 20,
-            pattern(ds(3, _, 3)) = 300,
-            pattern(ds(4, _, 4)) = 4000
-        ).value_or(0);
+        auto result = patum_values_switch(x, std::make_index_sequence<N>{});
 
         nanobench::doNotOptimizeAway(result);
     });
 
     counter = 0;
-    b.run("if", [&]
+    b.run("patum compiled", [&]
     {
-        const auto& x = data[counter];
+        const auto x = data[counter];
         counter = (++counter) % data.size();
 
-        int result;
-
-        int a = std::get<0>(x);
-        int b = std::get<2>(x);
-
-        if (a == 1 && b == 1)
-            result = 1;
-        else if (a == 2 && b == 2)
-            result = 20;
-        else if (a == 3 && b == 3)
-            result = 300;
-        else if (a == 4 && b == 4)
-            result = 4000;
-        else
-            result = 0;
+        auto result = compiled_values_switch(x, std::make_index_sequence<N>{});
 
         nanobench::doNotOptimizeAway(result);
     });
 
     counter = 0;
-    b.run("switch", [&]
+    b.run("patum lit", [&]
     {
-        const auto& x = data[counter];
+        const auto x = data[counter];
         counter = (++counter) % data.size();
 
-        int result;
+        auto result = patum_literals_switch(x, std::make_index_sequence<N>{});
 
-        int a = std::get<0>(x);
-        int b = std::get<2>(x);
+        nanobench::doNotOptimizeAway(result);
+    });
 
-        switch (a)
-        {
-            case 1:
-                switch (b)
-                {
-                    case 1: result = 1; break;
-                    default: result = 0; break;
-                }
-                break;
+    counter = 0;
+    b.run("patum lit val", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
 
-            case 2:
-                switch (b)
-                {
-                    case 2: result = 20; break;
-                    default: result = 0; break;
-                }
-                break;
+        auto result = patum_constants_switch(x, std::make_index_sequence<N>{});
 
-            case 3:
-                switch (b)
-                {
-                    case 3: result = 300; break;
-                    default: result = 0; break;
-                }
-                break;
+        nanobench::doNotOptimizeAway(result);
+    });
 
-            case 4:
-                switch (b)
-                {
-                    case 4: result = 4000; break;
-                    default: result = 0; break;
-                }
-                break;
+    counter = 0;
+    b.run("switch", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
 
-            default: result = 0; break;
-        }
+        auto result = switch_function(x);
 
         nanobench::doNotOptimizeAway(result);
     });
@@ -293,60 +396,2722 @@ TEST_CASE("tuple_destructuring", "[tuple]")
     generate_output("html", html_boxplot, b);
 }
 
+} // namespace
+
+TEST_CASE("literal_jump_table", "[base][literal]")
+{
+    run_literal_switch<4>("Literal Switch 4", switch_4);
+    run_literal_switch<64>("Literal Switch 64", switch_64);
+    run_literal_switch<512>("Literal Switch 512", switch_512);
+}
+
 //==================================================================================================
 
-TEST_CASE("branchless", "[branching]")
+namespace {
+
+constexpr std::uint64_t sparse_key(std::size_t n)
+{
+    return (static_cast<std::uint64_t>(n) + 1) * 0x9e3779b97f4a7c15ull;
+}
+
+#define SPARSE_CASE(n) case sparse_key(n): result = (n) * 7 + 1; break;
+#define SPARSE_CASE8(n) SPARSE_CASE(n) SPARSE_CASE(n + 1) SPARSE_CASE(n + 2) SPARSE_CASE(n + 3) \
+    SPARSE_CASE(n + 4) SPARSE_CASE(n + 5) SPARSE_CASE(n + 6) SPARSE_CASE(n + 7)
+#define SPARSE_CASE32(n) SPARSE_CASE8(n) SPARSE_CASE8(n + 8) SPARSE_CASE8(n + 16) SPARSE_CASE8(n + 24)
+#define SPARSE_CASE128(n) SPARSE_CASE32(n) SPARSE_CASE32(n + 32) SPARSE_CASE32(n + 64) SPARSE_CASE32(n + 96)
+
+int sparse_switch_8(std::uint64_t x)
+{
+    int result;
+
+    switch (x)
+    {
+        SPARSE_CASE8(0)
+        default: result = 0; break;
+    }
+
+    return result;
+}
+
+int sparse_switch_32(std::uint64_t x)
+{
+    int result;
+
+    switch (x)
+    {
+        SPARSE_CASE32(0)
+        default: result = 0; break;
+    }
+
+    return result;
+}
+
+int sparse_switch_128(std::uint64_t x)
+{
+    int result;
+
+    switch (x)
+    {
+        SPARSE_CASE128(0)
+        default: result = 0; break;
+    }
+
+    return result;
+}
+
+#undef SPARSE_CASE128
+#undef SPARSE_CASE32
+#undef SPARSE_CASE8
+#undef SPARSE_CASE
+
+template <std::size_t... I>
+int patum_values_sparse(std::uint64_t x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(sparse_key(I)) = static_cast<int>(I) * 7 + 1)...,
+        pattern(_) = 0
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int compiled_values_sparse(std::uint64_t x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    static const auto compiled = compile_match
+    (
+        (pattern(sparse_key(I)) = static_cast<int>(I) * 7 + 1)...,
+        pattern(_) = 0
+    );
+
+    return compiled(x).value_or(0);
+}
+
+template <std::size_t... I>
+int patum_literals_sparse(std::uint64_t x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(lit<sparse_key(I)>) = static_cast<int>(I) * 7 + 1)...,
+        pattern(_) = 0
+    ).value_or(0);
+}
+
+template <std::size_t N, class F>
+void run_sparse_switch(const std::string& title, F&& switch_function)
 {
     auto b = nanobench::Bench()
-        .title("Branchless")
+        .title(title)
         .warmup(100)
         .minEpochIterations(8000000)
         .performanceCounters(true)
         .relative(true);
 
-    const auto data = generate_data(0, 8, 100000);
+    std::vector<std::uint64_t> data;
+    for (const auto index : generate_data(0, static_cast<int>(N + N / 8), 100000))
+        data.push_back(sparse_key(static_cast<std::size_t>(index)));
+
     std::size_t counter = 0;
 
     counter = 0;
     b.run("patum", [&]
     {
-        using namespace ptm;
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
 
-        auto x = data[counter];
+        auto result = patum_values_sparse(x, std::make_index_sequence<N>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto x = data[counter];
         counter = (++counter) % data.size();
 
-        auto result = match(x)
-        (
-            pattern(_x < 1) = 1,
-            pattern(_x < 2) = 20,
-            pattern(_x < 3) = 300,
-            pattern(_x < 4) = 4000
-        ).value_or(0);
+        auto result = compiled_values_sparse(x, std::make_index_sequence<N>{});
 
         nanobench::doNotOptimizeAway(result);
     });
 
     counter = 0;
-    b.run("if", [&]
+    b.run("patum lit", [&]
     {
-        auto x = data[counter];
+        const auto x = data[counter];
         counter = (++counter) % data.size();
 
-        int result;
+        auto result = patum_literals_sparse(x, std::make_index_sequence<N>{});
 
-        if (x < 1)
-            result = 1;
-        else if (x < 2)
-            result = 20;
-        else if (x < 3)
-            result = 300;
-        else if (x < 4)
-            result = 4000;
-        else
-            result = 0;
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("switch", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = switch_function(x);
 
         nanobench::doNotOptimizeAway(result);
     });
 
     generate_output("html", html_boxplot, b);
 }
+
+} // namespace
+
+TEST_CASE("literal_sparse_keys", "[base][literal]")
+{
+    run_sparse_switch<8>("Literal Sparse 8", sparse_switch_8);
+    run_sparse_switch<32>("Literal Sparse 32", sparse_switch_32);
+    run_sparse_switch<128>("Literal Sparse 128", sparse_switch_128);
+}
+
+//==================================================================================================
+
+namespace {
+
+constexpr int bucket_edge(std::size_t n)
+{
+    return static_cast<int>(n * (n + 7));
+}
+
+template <std::size_t... I>
+int patum_values_buckets(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(range(bucket_edge(I), bucket_edge(I + 1) - 1)) = static_cast<int>(I))...,
+        pattern(_) = -1
+    ).value_or(-1);
+}
+
+template <std::size_t... I>
+int compiled_values_buckets(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    static const auto compiled = compile_match
+    (
+        (pattern(range(bucket_edge(I), bucket_edge(I + 1) - 1)) = static_cast<int>(I))...,
+        pattern(_) = -1
+    );
+
+    return compiled(x).value_or(-1);
+}
+
+template <std::size_t... I>
+int patum_literals_buckets(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(lit_range<bucket_edge(I), bucket_edge(I + 1) - 1>) = static_cast<int>(I))...,
+        pattern(_) = -1
+    ).value_or(-1);
+}
+
+template <std::size_t... I>
+int upper_bound_buckets(int x, std::index_sequence<I...>)
+{
+    static constexpr std::array<int, sizeof...(I) + 1> edges = { bucket_edge(I)..., bucket_edge(sizeof...(I)) };
+
+    const auto position = static_cast<int>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+
+    return position == 0 || position > static_cast<int>(sizeof...(I)) ? -1 : position - 1;
+}
+
+template <std::size_t N>
+void run_buckets(const std::string& title)
+{
+    auto b = nanobench::Bench()
+        .title(title)
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_data(-10, bucket_edge(N) + 10, 100000);
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_buckets(x, std::make_index_sequence<N>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_buckets(x, std::make_index_sequence<N>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum lit_range", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_literals_buckets(x, std::make_index_sequence<N>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("upper_bound", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = upper_bound_buckets(x, std::make_index_sequence<N>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+} // namespace
+
+TEST_CASE("interval_buckets", "[base][literal]")
+{
+    run_buckets<16>("Interval Buckets 16");
+    run_buckets<256>("Interval Buckets 256");
+}
+
+//==================================================================================================
+
+namespace {
+
+constexpr std::array<std::string_view, 32> bench_keywords = {
+    "alignas", "auto", "bool", "break", "case", "catch", "char", "class",
+    "const", "constexpr", "continue", "decltype", "default", "delete", "do", "double",
+    "else", "enum", "explicit", "extern", "float", "for", "friend", "goto",
+    "if", "inline", "int", "long", "namespace", "new", "noexcept", "operator"
+};
+
+int patum_values_keywords(std::string_view x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern("alignas")   = 1,  pattern("auto")     = 2,  pattern("bool")     = 3,  pattern("break")    = 4,
+        pattern("case")      = 5,  pattern("catch")    = 6,  pattern("char")     = 7,  pattern("class")    = 8,
+        pattern("const")     = 9,  pattern("constexpr") = 10, pattern("continue") = 11, pattern("decltype") = 12,
+        pattern("default")   = 13, pattern("delete")   = 14, pattern("do")       = 15, pattern("double")   = 16,
+        pattern("else")      = 17, pattern("enum")     = 18, pattern("explicit") = 19, pattern("extern")   = 20,
+        pattern("float")     = 21, pattern("for")      = 22, pattern("friend")   = 23, pattern("goto")     = 24,
+        pattern("if")        = 25, pattern("inline")   = 26, pattern("int")      = 27, pattern("long")     = 28,
+        pattern("namespace") = 29, pattern("new")      = 30, pattern("noexcept") = 31, pattern("operator") = 32,
+        pattern(_)           = 0
+    ).value_or(0);
+}
+
+int compiled_values_keywords(std::string_view x)
+{
+    using namespace ptm;
+
+    static const auto compiled = compile_match
+    (
+        pattern("alignas")   = 1,  pattern("auto")     = 2,  pattern("bool")     = 3,  pattern("break")    = 4,
+        pattern("case")      = 5,  pattern("catch")    = 6,  pattern("char")     = 7,  pattern("class")    = 8,
+        pattern("const")     = 9,  pattern("constexpr") = 10, pattern("continue") = 11, pattern("decltype") = 12,
+        pattern("default")   = 13, pattern("delete")   = 14, pattern("do")       = 15, pattern("double")   = 16,
+        pattern("else")      = 17, pattern("enum")     = 18, pattern("explicit") = 19, pattern("extern")   = 20,
+        pattern("float")     = 21, pattern("for")      = 22, pattern("friend")   = 23, pattern("goto")     = 24,
+        pattern("if")        = 25, pattern("inline")   = 26, pattern("int")      = 27, pattern("long")     = 28,
+        pattern("namespace") = 29, pattern("new")      = 30, pattern("noexcept") = 31, pattern("operator") = 32,
+        pattern(_)           = 0
+    );
+
+    return compiled(x).value_or(0);
+}
+
+int patum_literals_keywords(std::string_view x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(lit_str<"alignas">)   = 1,  pattern(lit_str<"auto">)      = 2,  pattern(lit_str<"bool">)     = 3,
+        pattern(lit_str<"break">)     = 4,  pattern(lit_str<"case">)      = 5,  pattern(lit_str<"catch">)    = 6,
+        pattern(lit_str<"char">)      = 7,  pattern(lit_str<"class">)     = 8,  pattern(lit_str<"const">)    = 9,
+        pattern(lit_str<"constexpr">) = 10, pattern(lit_str<"continue">)  = 11, pattern(lit_str<"decltype">) = 12,
+        pattern(lit_str<"default">)   = 13, pattern(lit_str<"delete">)    = 14, pattern(lit_str<"do">)       = 15,
+        pattern(lit_str<"double">)    = 16, pattern(lit_str<"else">)      = 17, pattern(lit_str<"enum">)     = 18,
+        pattern(lit_str<"explicit">)  = 19, pattern(lit_str<"extern">)    = 20, pattern(lit_str<"float">)    = 21,
+        pattern(lit_str<"for">)       = 22, pattern(lit_str<"friend">)    = 23, pattern(lit_str<"goto">)     = 24,
+        pattern(lit_str<"if">)        = 25, pattern(lit_str<"inline">)    = 26, pattern(lit_str<"int">)      = 27,
+        pattern(lit_str<"long">)      = 28, pattern(lit_str<"namespace">) = 29, pattern(lit_str<"new">)      = 30,
+        pattern(lit_str<"noexcept">)  = 31, pattern(lit_str<"operator">)  = 32,
+        pattern(_)                    = 0
+    ).value_or(0);
+}
+
+int patum_adaptive_keywords(std::string_view x)
+{
+    using namespace ptm;
+
+    return match(adaptive, x)
+    (
+        pattern(lit_str<"alignas">)   = 1,  pattern(lit_str<"auto">)      = 2,  pattern(lit_str<"bool">)     = 3,
+        pattern(lit_str<"break">)     = 4,  pattern(lit_str<"case">)      = 5,  pattern(lit_str<"catch">)    = 6,
+        pattern(lit_str<"char">)      = 7,  pattern(lit_str<"class">)     = 8,  pattern(lit_str<"const">)    = 9,
+        pattern(lit_str<"constexpr">) = 10, pattern(lit_str<"continue">)  = 11, pattern(lit_str<"decltype">) = 12,
+        pattern(lit_str<"default">)   = 13, pattern(lit_str<"delete">)    = 14, pattern(lit_str<"do">)       = 15,
+        pattern(lit_str<"double">)    = 16, pattern(lit_str<"else">)      = 17, pattern(lit_str<"enum">)     = 18,
+        pattern(lit_str<"explicit">)  = 19, pattern(lit_str<"extern">)    = 20, pattern(lit_str<"float">)    = 21,
+        pattern(lit_str<"for">)       = 22, pattern(lit_str<"friend">)    = 23, pattern(lit_str<"goto">)     = 24,
+        pattern(lit_str<"if">)        = 25, pattern(lit_str<"inline">)    = 26, pattern(lit_str<"int">)      = 27,
+        pattern(lit_str<"long">)      = 28, pattern(lit_str<"namespace">) = 29, pattern(lit_str<"new">)      = 30,
+        pattern(lit_str<"noexcept">)  = 31, pattern(lit_str<"operator">)  = 32,
+        pattern(_)                    = 0
+    ).value_or(-1);
+}
+
+int unordered_map_keywords(std::string_view x)
+{
+    static const std::unordered_map<std::string_view, int> keywords = []
+    {
+        std::unordered_map<std::string_view, int> result;
+
+        for (std::size_t index = 0; index < bench_keywords.size(); ++index)
+            result.emplace(bench_keywords[index], static_cast<int>(index) + 1);
+
+        return result;
+    }();
+
+    const auto it = keywords.find(x);
+    return it != keywords.end() ? it->second : 0;
+}
+
+} // namespace
+
+TEST_CASE("keyword_dispatch", "[base][string]")
+{
+    auto b = nanobench::Bench()
+        .title("Keyword Dispatch 32")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    // One identifier out of eight is not a keyword
+    const std::array<std::string_view, 4> identifiers = { "value", "index", "result", "counter" };
+
+    std::vector<std::string_view> data;
+    for (const auto index : generate_data(0, 35, 100000))
+        data.push_back(index < 32 ? bench_keywords[index] : identifiers[index - 32]);
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum lit_str", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_literals_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("unordered_map", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = unordered_map_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+constexpr bool is_space_char(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+constexpr bool is_digit_char(char c) { return c >= '0' && c <= '9'; }
+constexpr bool is_alpha_char(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+constexpr bool is_operator_char(char c) { return c == '+' || c == '-' || c == '*' || c == '/' || c == '=' || c == '<' || c == '>'; }
+constexpr bool is_bracket_char(char c) { return c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || c == '}'; }
+
+int patum_values_characters(char x)
+{
+    using namespace ptm;
+
+    // Capturing the classifiers keeps the arms stateful, so they are checked in order
+    const auto space = is_space_char;
+    const auto digit = is_digit_char;
+    const auto alpha = is_alpha_char;
+    const auto op = is_operator_char;
+    const auto bracket = is_bracket_char;
+
+    return match(x)
+    (
+        pattern([&](char c) { return space(c); })   = 1,
+        pattern([&](char c) { return digit(c); })   = 2,
+        pattern([&](char c) { return alpha(c); })   = 3,
+        pattern([&](char c) { return op(c); })      = 4,
+        pattern([&](char c) { return bracket(c); }) = 5,
+        pattern(_)                                  = 0
+    ).value_or(-1);
+}
+
+int compiled_values_characters(char x)
+{
+    using namespace ptm;
+
+    // The classifiers are captured by value, the arms outlive the first call
+    static const auto compiled = [space = is_space_char, digit = is_digit_char, alpha = is_alpha_char,
+        op = is_operator_char, bracket = is_bracket_char]
+    {
+        return compile_match
+        (
+            pattern([=](char c) { return space(c); })   = 1,
+            pattern([=](char c) { return digit(c); })   = 2,
+            pattern([=](char c) { return alpha(c); })   = 3,
+            pattern([=](char c) { return op(c); })      = 4,
+            pattern([=](char c) { return bracket(c); }) = 5,
+            pattern(_)                                  = 0
+        );
+    }();
+
+    return compiled(x).value_or(-1);
+}
+
+int patum_domain_characters(char x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern([](char c) { return is_space_char(c); })    = 1,
+        pattern([](char c) { return is_digit_char(c); })    = 2,
+        pattern([](char c) { return is_alpha_char(c); })    = 3,
+        pattern([](char c) { return is_operator_char(c); }) = 4,
+        pattern([](char c) { return is_bracket_char(c); })  = 5,
+        pattern(_)                                          = 0
+    ).value_or(-1);
+}
+
+int if_chain_characters(char x)
+{
+    if (is_space_char(x))
+        return 1;
+    if (is_digit_char(x))
+        return 2;
+    if (is_alpha_char(x))
+        return 3;
+    if (is_operator_char(x))
+        return 4;
+    if (is_bracket_char(x))
+        return 5;
+    return 0;
+}
+
+} // namespace
+
+TEST_CASE("character_class", "[base][domain]")
+{
+    auto b = nanobench::Bench()
+        .title("Character Class 256")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    std::vector<char> data;
+    for (const auto value : generate_data(0, 255, 100000))
+        data.push_back(static_cast<char>(value));
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_characters(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_characters(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum domain table", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_domain_characters(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("if chain", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = if_chain_characters(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+template <std::size_t I>
+struct bench_event
+{
+    int payload = 0;
+
+    constexpr bool operator==(const bench_event&) const = default;
+};
+
+template <class Sequence>
+struct bench_event_bus;
+
+template <std::size_t... I>
+struct bench_event_bus<std::index_sequence<I...>>
+{
+    using type = std::variant<bench_event<I>...>;
+};
+
+using bench_event_sequence = std::make_index_sequence<37>;
+using bench_event_variant = typename bench_event_bus<bench_event_sequence>::type;
+
+template <std::size_t... I>
+int patum_values_events(const bench_event_variant& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    // Same checks as valued, but opaque to the dispatch so the arms are tried one after another
+    return match(x)
+    (
+        pattern([](const bench_event_variant& v)
+        {
+            return std::holds_alternative<bench_event<I>>(v) && std::get<bench_event<I>>(v).payload == static_cast<int>(I);
+        }) = static_cast<int>(I) + 1 ...,
+        pattern(_) = 0
+    ).value_or(-1);
+}
+
+template <std::size_t... I>
+int compiled_values_events(const bench_event_variant& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    // Same checks as valued, but opaque to the dispatch so the arms are tried one after another
+    static const auto compiled = compile_match
+    (
+        pattern([](const bench_event_variant& v)
+        {
+            return std::holds_alternative<bench_event<I>>(v) && std::get<bench_event<I>>(v).payload == static_cast<int>(I);
+        }) = static_cast<int>(I) + 1 ...,
+        pattern(_) = 0
+    );
+
+    return compiled(x).value_or(-1);
+}
+
+template <std::size_t... I>
+int patum_valued_events(const bench_event_variant& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(valued(bench_event<I>{ static_cast<int>(I) })) = static_cast<int>(I) + 1 ...,
+        pattern(_) = 0
+    ).value_or(-1);
+}
+
+template <std::size_t... I>
+int patum_typed_events(const bench_event_variant& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(typed<bench_event<I>>) = static_cast<int>(I) + 1 ...,
+        pattern(_) = 0
+    ).value_or(-1);
+}
+
+int visit_events(const bench_event_variant& x)
+{
+    return std::visit([]<std::size_t I>(const bench_event<I>& e) { return e.payload == static_cast<int>(I) ? static_cast<int>(I) + 1 : 0; }, x);
+}
+
+template <std::size_t... I>
+bench_event_variant make_event(std::size_t index, std::index_sequence<I...>)
+{
+    bench_event_variant result;
+    ((index == I ? (void)result.template emplace<I>(bench_event<I>{ static_cast<int>(I) }) : (void)0), ...);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("variant_dispatch", "[base][variant]")
+{
+    auto b = nanobench::Bench()
+        .title("Variant Dispatch 37")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    std::vector<bench_event_variant> data;
+    for (const auto index : generate_data(0, 36, 100000))
+        data.push_back(make_event(static_cast<std::size_t>(index), bench_event_sequence{}));
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_events(x, bench_event_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_events(x, bench_event_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum valued", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_valued_events(x, bench_event_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum typed", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_typed_events(x, bench_event_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("std::visit", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = visit_events(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+template <std::size_t I>
+struct bench_operand
+{
+};
+
+using bench_operand_sequence = std::make_index_sequence<8>;
+using bench_operand_variant = std::variant<bench_operand<0>, bench_operand<1>, bench_operand<2>, bench_operand<3>,
+    bench_operand<4>, bench_operand<5>, bench_operand<6>, bench_operand<7>>;
+
+template <std::size_t... I>
+int patum_values_operands(const bench_operand_variant& x, const bench_operand_variant& y, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    // Same checks as typed, but opaque to the dispatch so the arms are tried one after another
+    return match(x, y)
+    (
+        pattern([](const bench_operand_variant& v) { return v.index() == I; },
+                [](const bench_operand_variant& v) { return v.index() == I; }) = static_cast<int>(I) + 1 ...,
+        pattern(_, [](const bench_operand_variant& v) { return v.index() == 0; }) = 9,
+        pattern([](const bench_operand_variant& v) { return v.index() == 0; }, _) = 10,
+        pattern(_, _) = 0
+    ).value_or(-1);
+}
+
+template <std::size_t... I>
+int compiled_values_operands(const bench_operand_variant& x, const bench_operand_variant& y, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    // Same checks as typed, but opaque to the dispatch so the arms are tried one after another
+    static const auto compiled = compile_match
+    (
+        pattern([](const bench_operand_variant& v) { return v.index() == I; },
+                [](const bench_operand_variant& v) { return v.index() == I; }) = static_cast<int>(I) + 1 ...,
+        pattern(_, [](const bench_operand_variant& v) { return v.index() == 0; }) = 9,
+        pattern([](const bench_operand_variant& v) { return v.index() == 0; }, _) = 10,
+        pattern(_, _) = 0
+    );
+
+    return compiled(x, y).value_or(-1);
+}
+
+template <std::size_t... I>
+int patum_typed_operands(const bench_operand_variant& x, const bench_operand_variant& y, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x, y)
+    (
+        pattern(typed<bench_operand<I>>, typed<bench_operand<I>>) = static_cast<int>(I) + 1 ...,
+        pattern(_, typed<bench_operand<0>>) = 9,
+        pattern(typed<bench_operand<0>>, _) = 10,
+        pattern(_, _) = 0
+    ).value_or(-1);
+}
+
+int visit_operands(const bench_operand_variant& x, const bench_operand_variant& y)
+{
+    return std::visit([]<std::size_t I, std::size_t J>(const bench_operand<I>&, const bench_operand<J>&)
+    {
+        if constexpr (I == J)
+            return static_cast<int>(I) + 1;
+        else if constexpr (J == 0)
+            return 9;
+        else if constexpr (I == 0)
+            return 10;
+        else
+            return 0;
+    }, x, y);
+}
+
+template <std::size_t... I>
+bench_operand_variant make_operand(std::size_t index, std::index_sequence<I...>)
+{
+    bench_operand_variant result;
+    ((index == I ? (void)result.template emplace<I>() : (void)0), ...);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("variant_double_dispatch", "[base][variant]")
+{
+    auto b = nanobench::Bench()
+        .title("Variant Double Dispatch 8x8")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    std::vector<std::pair<bench_operand_variant, bench_operand_variant>> data;
+    for (const auto index : generate_data(0, 63, 100000))
+    {
+        data.emplace_back(make_operand(static_cast<std::size_t>(index / 8), bench_operand_sequence{}),
+            make_operand(static_cast<std::size_t>(index % 8), bench_operand_sequence{}));
+    }
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto& [x, y] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_operands(x, y, bench_operand_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& [x, y] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_operands(x, y, bench_operand_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum typed", [&]
+    {
+        const auto& [x, y] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_typed_operands(x, y, bench_operand_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("std::visit", [&]
+    {
+        const auto& [x, y] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = visit_operands(x, y);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+constexpr std::array<std::pair<std::string_view, std::string_view>, 24> bench_commands = {{
+    { "read", "user" }, { "read", "team" }, { "read", "role" }, { "read", "file" }, { "read", "node" }, { "read", "task" },
+    { "edit", "user" }, { "edit", "team" }, { "edit", "role" }, { "edit", "file" }, { "edit", "node" }, { "edit", "task" },
+    { "drop", "user" }, { "drop", "team" }, { "drop", "role" }, { "drop", "file" }, { "drop", "node" }, { "drop", "task" },
+    { "list", "user" }, { "list", "team" }, { "list", "role" }, { "list", "file" }, { "list", "node" }, { "list", "task" }
+}};
+
+template <ptm::fixed_string Verb, ptm::fixed_string Object>
+using command_row = std::tuple<std::remove_cvref_t<decltype(ptm::lit_str<Verb>)>, std::remove_cvref_t<decltype(ptm::lit_str<Object>)>>;
+
+} // namespace
+
+// Profile of the skewed commands below, as an instrumented build would record it
+PATUM_SITE_PROFILE("bench.commands", (ptm::site_signature_v<std::tuple<std::string_view, std::string_view>,
+    command_row<"read", "user">, command_row<"read", "team">, command_row<"read", "role">, command_row<"read", "file">, command_row<"read", "node">, command_row<"read", "task">,
+    command_row<"edit", "user">, command_row<"edit", "team">, command_row<"edit", "role">, command_row<"edit", "file">, command_row<"edit", "node">, command_row<"edit", "task">,
+    command_row<"drop", "user">, command_row<"drop", "team">, command_row<"drop", "role">, command_row<"drop", "file">, command_row<"drop", "node">, command_row<"drop", "task">,
+    command_row<"list", "user">, command_row<"list", "team">, command_row<"list", "role">, command_row<"list", "file">, command_row<"list", "node">, command_row<"list", "task">,
+    std::tuple<std::remove_cvref_t<decltype(ptm::_)>, std::remove_cvref_t<decltype(ptm::_)>>>),
+    417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 9417, 417, 0)
+
+namespace {
+
+template <class Policy>
+int patum_commands(Policy policy, std::string_view verb, std::string_view object)
+{
+    using namespace ptm;
+
+    return match(policy, verb, object)
+    (
+        pattern(lit_str<"read">, lit_str<"user">) = 1,  pattern(lit_str<"read">, lit_str<"team">) = 2,
+        pattern(lit_str<"read">, lit_str<"role">) = 3,  pattern(lit_str<"read">, lit_str<"file">) = 4,
+        pattern(lit_str<"read">, lit_str<"node">) = 5,  pattern(lit_str<"read">, lit_str<"task">) = 6,
+        pattern(lit_str<"edit">, lit_str<"user">) = 7,  pattern(lit_str<"edit">, lit_str<"team">) = 8,
+        pattern(lit_str<"edit">, lit_str<"role">) = 9,  pattern(lit_str<"edit">, lit_str<"file">) = 10,
+        pattern(lit_str<"edit">, lit_str<"node">) = 11, pattern(lit_str<"edit">, lit_str<"task">) = 12,
+        pattern(lit_str<"drop">, lit_str<"user">) = 13, pattern(lit_str<"drop">, lit_str<"team">) = 14,
+        pattern(lit_str<"drop">, lit_str<"role">) = 15, pattern(lit_str<"drop">, lit_str<"file">) = 16,
+        pattern(lit_str<"drop">, lit_str<"node">) = 17, pattern(lit_str<"drop">, lit_str<"task">) = 18,
+        pattern(lit_str<"list">, lit_str<"user">) = 19, pattern(lit_str<"list">, lit_str<"team">) = 20,
+        pattern(lit_str<"list">, lit_str<"role">) = 21, pattern(lit_str<"list">, lit_str<"file">) = 22,
+        pattern(lit_str<"list">, lit_str<"node">) = 23, pattern(lit_str<"list">, lit_str<"task">) = 24,
+        pattern(_, _)                             = 0
+    ).value_or(-1);
+}
+
+template <class Policy>
+int compiled_commands(Policy policy, std::string_view verb, std::string_view object)
+{
+    using namespace ptm;
+
+    static const auto compiled = compile_match
+    (
+        policy,
+        pattern(lit_str<"read">, lit_str<"user">) = 1,  pattern(lit_str<"read">, lit_str<"team">) = 2,
+        pattern(lit_str<"read">, lit_str<"role">) = 3,  pattern(lit_str<"read">, lit_str<"file">) = 4,
+        pattern(lit_str<"read">, lit_str<"node">) = 5,  pattern(lit_str<"read">, lit_str<"task">) = 6,
+        pattern(lit_str<"edit">, lit_str<"user">) = 7,  pattern(lit_str<"edit">, lit_str<"team">) = 8,
+        pattern(lit_str<"edit">, lit_str<"role">) = 9,  pattern(lit_str<"edit">, lit_str<"file">) = 10,
+        pattern(lit_str<"edit">, lit_str<"node">) = 11, pattern(lit_str<"edit">, lit_str<"task">) = 12,
+        pattern(lit_str<"drop">, lit_str<"user">) = 13, pattern(lit_str<"drop">, lit_str<"team">) = 14,
+        pattern(lit_str<"drop">, lit_str<"role">) = 15, pattern(lit_str<"drop">, lit_str<"file">) = 16,
+        pattern(lit_str<"drop">, lit_str<"node">) = 17, pattern(lit_str<"drop">, lit_str<"task">) = 18,
+        pattern(lit_str<"list">, lit_str<"user">) = 19, pattern(lit_str<"list">, lit_str<"team">) = 20,
+        pattern(lit_str<"list">, lit_str<"role">) = 21, pattern(lit_str<"list">, lit_str<"file">) = 22,
+        pattern(lit_str<"list">, lit_str<"node">) = 23, pattern(lit_str<"list">, lit_str<"task">) = 24,
+        pattern(_, _)                             = 0
+    );
+
+    return compiled(verb, object).value_or(-1);
+}
+
+} // namespace
+
+TEST_CASE("skewed_command_dispatch", "[base][string][adaptive][profile]")
+{
+    auto b = nanobench::Bench()
+        .title("Skewed Command Dispatch 24")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    // Nine subjects out of ten are the 23rd command, the others are spread over every command
+    std::vector<std::pair<std::string_view, std::string_view>> data;
+    for (const auto index : generate_data(0, 239, 100000))
+        data.push_back(index < 216 ? bench_commands[22] : bench_commands[index % 24]);
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto [verb, object] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_commands(ptm::default_policy{}, verb, object);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto [verb, object] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_commands(ptm::default_policy{}, verb, object);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum adaptive", [&]
+    {
+        const auto [verb, object] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_commands(ptm::adaptive, verb, object);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum profiled", [&]
+    {
+        const auto [verb, object] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_commands(ptm::profiled<"bench.commands">, verb, object);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+TEST_CASE("skewed_keyword_dispatch", "[base][string][adaptive]")
+{
+    auto b = nanobench::Bench()
+        .title("Skewed Keyword Dispatch 32")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    // Nine subjects out of ten are the 29th keyword, the others are spread over every keyword
+    std::vector<std::string_view> data;
+    for (const auto index : generate_data(0, 319, 100000))
+        data.push_back(index < 288 ? bench_keywords[28] : bench_keywords[index % 32]);
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum lit_str", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_literals_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum adaptive", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_adaptive_keywords(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+TEST_CASE("regex_guards", "[base][string][regex]")
+{
+    auto b = nanobench::Bench()
+        .title("Regex Guards")
+        .warmup(100)
+        .minEpochIterations(400000)
+        .performanceCounters(true)
+        .relative(true);
+
+    // Nine subjects out of ten are too short for the guarded arms, which only the length check rejects cheaply
+    std::vector<std::string> data;
+    for (const auto index : generate_data(0, 99, 10000))
+    {
+        if (index < 90)
+            data.push_back(index % 2 ? "id_" + std::to_string(index) : std::to_string(index * 7));
+        else
+            data.push_back(index % 2 ? "identifier_number_" + std::to_string(index) : std::to_string(index * 1234567891ll));
+    }
+
+    const auto identifier = ptm::sregex("[a-z_]+[0-9]*");
+    const auto number = ptm::sregex("[0-9]+");
+    const auto long_enough = ptm::speculative<ptm::predicate_cost::arithmetic>([](const std::string& x) { return x.size() > 12; });
+
+    std::size_t counter = 0;
+
+    const auto compiled = [&]
+    {
+        using namespace ptm;
+
+        return compile_match
+        (
+            pattern(identifier && long_enough) = 1,
+            pattern(number && long_enough)     = 2,
+            pattern(_)                         = 0
+        );
+    }();
+
+    counter = 0;
+    b.run("patum cost ordered", [&]
+    {
+        using namespace ptm;
+
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(x)
+        (
+            pattern(identifier && long_enough) = 1,
+            pattern(number && long_enough)     = 2,
+            pattern(_)                         = 0
+        ).value_or(-1);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled(x).value_or(-1);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum written order", [&]
+    {
+        using namespace ptm;
+
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(x)
+        (
+            pattern(ordered(identifier) && long_enough) = 1,
+            pattern(ordered(number) && long_enough)     = 2,
+            pattern(_)                                  = 0
+        ).value_or(-1);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+TEST_CASE("column_ordering", "[multi][regex]")
+{
+    auto b = nanobench::Bench()
+        .title("Column Ordering")
+        .warmup(100)
+        .minEpochIterations(400000)
+        .performanceCounters(true)
+        .relative(true);
+
+    // Only one record out of a hundred has the kind of the guarded arm, which its literal column rejects cheaply
+    std::vector<std::tuple<int, int, std::string>> data;
+    for (const auto index : generate_data(0, 99, 10000))
+        data.emplace_back(index == 0 ? 7 : index % 7, index % 3, "identifier_" + std::to_string(index));
+
+    const auto identifier = ptm::sregex("[a-z_]+[0-9]*");
+
+    std::size_t counter = 0;
+
+    const auto compiled = [&]
+    {
+        using namespace ptm;
+
+        return compile_match
+        (
+            pattern(7, _, identifier) = 1,
+            pattern(_, 1, identifier) = 2,
+            pattern(_, _, _)          = 0
+        );
+    }();
+
+    counter = 0;
+    b.run("patum selectivity ordered", [&]
+    {
+        using namespace ptm;
+
+        const auto& [kind, flags, text] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(kind, flags, text)
+        (
+            pattern(7, _, identifier) = 1,
+            pattern(_, 1, identifier) = 2,
+            pattern(_, _, _)          = 0
+        ).value_or(-1);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& [kind, flags, text] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled(kind, flags, text).value_or(-1);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum last column first", [&]
+    {
+        using namespace ptm;
+
+        const auto& [kind, flags, text] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(kind, flags, text)
+        (
+            pattern(check_order<2, 1, 0>, 7, _, identifier) = 1,
+            pattern(check_order<2, 1, 0>, _, 1, identifier) = 2,
+            pattern(_, _, _)                                = 0
+        ).value_or(-1);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+struct bench_route
+{
+    int priority;
+    std::uint32_t tenant;
+    int service;
+    int first_port;
+    int last_port;
+};
+
+constexpr std::array<std::string_view, 8> bench_services = {
+    "auth", "billing", "catalog", "checkout", "inventory", "search", "shipping", "users"
+};
+
+// Tenants are compared for equality, services are a name or any service (one rule out of five), ports a range or any
+// port (seven rules out of ten)
+std::vector<bench_route> generate_routes(std::size_t count)
+{
+    nanobench::Rng gen(42);
+
+    std::vector<bench_route> result(count);
+
+    for (auto& route : result)
+    {
+        const int first_port = static_cast<int>(gen.bounded(60000));
+
+        route.priority = static_cast<int>(gen.bounded(10));
+        route.tenant = static_cast<std::uint32_t>(gen.bounded(static_cast<std::uint32_t>(count / 4 + 1)));
+        route.service = gen.bounded(5) == 0 ? -1 : static_cast<int>(gen.bounded(8));
+        route.first_port = gen.bounded(10) < 7 ? -1 : first_port;
+        route.last_port = first_port + static_cast<int>(gen.bounded(1000));
+    }
+
+    return result;
+}
+
+auto build_routes(const std::vector<bench_route>& routes)
+{
+    ptm::rule_set_builder<std::uint32_t, std::string, int> builder;
+
+    for (std::size_t index = 0; index < routes.size(); ++index)
+    {
+        const auto& route = routes[index];
+        const auto action = static_cast<ptm::rule_action>(index);
+
+        if (route.service < 0 && route.first_port < 0)
+            builder.add(route.priority, action, route.tenant, ptm::_, ptm::_);
+        else if (route.service < 0)
+            builder.add(route.priority, action, route.tenant, ptm::_, ptm::rule_range(route.first_port, route.last_port));
+        else if (route.first_port < 0)
+            builder.add(route.priority, action, route.tenant, std::string(bench_services[route.service]), ptm::_);
+        else
+            builder.add(route.priority, action, route.tenant, std::string(bench_services[route.service]),
+                ptm::rule_range(route.first_port, route.last_port));
+    }
+
+    return builder.freeze();
+}
+
+using route_image = ptm::rule_image<std::uint32_t, std::string, int>;
+
+std::optional<ptm::rule_action> scan_routes(const std::vector<bench_route>& routes, std::uint32_t tenant, int service, int port)
+{
+    std::optional<ptm::rule_action> result;
+    int priority = 0;
+
+    for (std::size_t index = 0; index < routes.size(); ++index)
+    {
+        const auto& route = routes[index];
+
+        if (route.tenant == tenant
+            && (route.service < 0 || route.service == service)
+            && (route.first_port < 0 || (port >= route.first_port && port <= route.last_port))
+            && (not result || route.priority > priority))
+        {
+            result = static_cast<ptm::rule_action>(index);
+            priority = route.priority;
+        }
+    }
+
+    return result;
+}
+
+void run_routes(const std::string& title, std::size_t count, bool with_scan)
+{
+    auto b = nanobench::Bench()
+        .title(title)
+        .warmup(100)
+        .minEpochIterations(with_scan ? 2000 : 400000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto routes = generate_routes(count);
+    const auto rules = build_routes(routes);
+    const auto bytes = ptm::make_rule_image(rules);
+    const auto image = route_image::open(bytes);
+
+    // Nine queries out of ten target a tenant having rules
+    std::vector<std::tuple<std::uint32_t, int, int>> data;
+    for (const auto index : generate_data(0, 9999, 10000))
+    {
+        const auto& route = routes[static_cast<std::size_t>(index) * 7919 % routes.size()];
+        const auto tenant = index % 10 == 0 ? static_cast<std::uint32_t>(count) + 1 : route.tenant;
+
+        data.emplace_back(tenant, index % 8, route.first_port < 0 ? index * 13 % 60000 : route.first_port + index % 500);
+    }
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("rule_set", [&]
+    {
+        const auto& [tenant, service, port] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = rules.match(tenant, bench_services[service], port).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("rule_image", [&]
+    {
+        const auto& [tenant, service, port] = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = image->match(tenant, bench_services[service], port).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    if (with_scan)
+    {
+        counter = 0;
+        b.run("linear scan", [&]
+        {
+            const auto& [tenant, service, port] = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = scan_routes(routes, tenant, service, port).value_or(0);
+
+            nanobench::doNotOptimizeAway(result);
+        });
+    }
+
+    generate_output("html", html_boxplot, b);
+}
+
+} // namespace
+
+TEST_CASE("rule_set", "[rules]")
+{
+    run_routes("Rule Set 10k", 10000, true);
+    run_routes("Rule Set 100k", 100000, false);
+    run_routes("Rule Set 1M", 1000000, false);
+}
+
+TEST_CASE("rule_image_cold_start", "[rules]")
+{
+    auto b = nanobench::Bench()
+        .title("Rule Image Cold Start 1M")
+        .warmup(1)
+        .epochs(5)
+        .epochIterations(1)
+        .relative(true);
+
+    const auto routes = generate_routes(1000000);
+    const auto path = std::filesystem::temp_directory_path() / "patum_bench_routes.bin";
+
+    ptm::save_rule_image(build_routes(routes), path);
+
+    // From the routes to the first match, the way a process starts
+    b.run("rule_set freeze", [&]
+    {
+        const auto rules = build_routes(routes);
+
+        nanobench::doNotOptimizeAway(rules.match(routes[0].tenant, std::string_view("search"), 443));
+    });
+
+    b.run("mapped rule_image", [&]
+    {
+        const auto image = ptm::mapped_rule_image<std::uint32_t, std::string, int>::open(path);
+
+        nanobench::doNotOptimizeAway(image->match(routes[0].tenant, std::string_view("search"), 443));
+    });
+
+    std::filesystem::remove(path);
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+// Latency of every match of the reader threads, while a writer publishes rule sets back to back or not at all
+void run_reloads(bool reloading)
+{
+    using route_set = decltype(build_routes({}));
+
+    constexpr std::size_t match_count = 200000;
+    const std::size_t reader_count = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2, 5) - 1;
+
+    const auto routes = generate_routes(10000);
+    const auto rules = build_routes(routes);
+
+    ptm::rule_handle<route_set> handle(rules);
+
+    std::atomic<std::size_t> running = reader_count;
+    std::vector<std::vector<std::int64_t>> latencies(reader_count);
+    std::vector<std::thread> readers;
+
+    for (std::size_t thread = 0; thread < reader_count; ++thread)
+    {
+        readers.emplace_back([&, thread, reader = *handle.reader()]
+        {
+            auto& samples = latencies[thread];
+            samples.reserve(match_count);
+
+            for (std::size_t index = 0; index < match_count; ++index)
+            {
+                const auto& route = routes[(index + thread) * 7919 % routes.size()];
+                const auto port = route.first_port < 0 ? static_cast<int>(index % 60000) : route.first_port;
+
+                const auto start = std::chrono::steady_clock::now();
+                auto result = reader.match(route.tenant, bench_services[index % 8], port).value_or(0);
+                const auto end = std::chrono::steady_clock::now();
+
+                nanobench::doNotOptimizeAway(result);
+                samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            }
+
+            --running;
+        });
+    }
+
+    while (running.load() != 0)
+    {
+        if (reloading)
+            handle.publish(rules);
+        else
+            std::this_thread::yield();
+    }
+
+    for (auto& reader : readers)
+        reader.join();
+
+    std::vector<std::int64_t> samples;
+    for (const auto& thread_samples : latencies)
+        samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+
+    std::sort(samples.begin(), samples.end());
+
+    const auto percentile = [&](double fraction)
+    {
+        return samples[static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1))];
+    };
+
+    std::printf("| %-12s | %7zu | %8llu | %7lld | %7lld | %7lld | %9lld |\n",
+        reloading ? "reloading" : "idle", reader_count, static_cast<unsigned long long>(handle.version()),
+        static_cast<long long>(percentile(0.5)), static_cast<long long>(percentile(0.99)),
+        static_cast<long long>(percentile(0.999)), static_cast<long long>(samples.back()));
+}
+
+} // namespace
+
+TEST_CASE("rule_handle_reload", "[rules][threads]")
+{
+    std::printf("\n| %-12s | %7s | %8s | %7s | %7s | %7s | %9s | Rule Handle Reload 10k (ns)\n",
+        "writer", "readers", "versions", "p50", "p99", "p99.9", "max");
+    std::printf("|-------------:|--------:|---------:|--------:|--------:|--------:|----------:|:----------------\n");
+
+    run_reloads(false);
+    run_reloads(true);
+}
+
+//==================================================================================================
+
+namespace {
+
+struct bench_request
+{
+    std::string method;
+    int status;
+    int port;
+};
+
+} // namespace
+
+TEST_CASE("rule_script", "[rules][multi]")
+{
+    auto b = nanobench::Bench()
+        .title("Rule Script")
+        .warmup(100)
+        .minEpochIterations(400000)
+        .performanceCounters(true)
+        .relative(true);
+
+    constexpr std::array<std::string_view, 5> methods = { "GET", "PUT", "POST", "DELETE", "HEAD" };
+
+    std::vector<bench_request> data;
+    for (const auto index : generate_data(0, 9999, 10000))
+        data.push_back({ std::string(methods[index % methods.size()]), 100 + index * 7 % 500, index % 3 == 0 ? 443 : 8000 + index % 100 });
+
+    ptm::rule_fields<bench_request> fields;
+    fields.add("method", &bench_request::method)
+          .add("status", &bench_request::status)
+          .add("port", &bench_request::port);
+
+    const auto program = ptm::compile_rules(fields, R"(
+        match(method, status, port)
+
+        pattern("GET", range(200, 299), 443)             = 1
+        pattern("GET", range(300, 399))                  = 2
+        pattern(in("PUT", "POST"), _x >= 500)            = 3
+        pattern(in("PUT", "POST"), range(200, 299), 443) = 4
+        pattern("DELETE", _, _x < 8050)                  = 5
+        pattern(_, _x == 404 || _x == 410)               = 6
+        pattern("HEAD", !(_x >= 200 && _x < 300))        = 7
+        pattern(_, _, in(8080, 8081, 8082))              = 8
+        pattern(_)                                       = 0
+    )");
+
+    const auto compiled = []
+    {
+        using namespace ptm;
+
+        return compile_match
+        (
+            pattern("GET", range(200, 299), 443)             = 1u,
+            pattern("GET", range(300, 399), _)               = 2u,
+            pattern(in("PUT", "POST"), _x >= 500, _)         = 3u,
+            pattern(in("PUT", "POST"), range(200, 299), 443) = 4u,
+            pattern("DELETE", _, _x < 8050)                  = 5u,
+            pattern(_, _x == 404 || _x == 410, _)            = 6u,
+            pattern("HEAD", !(_x >= 200 && _x < 300), _)     = 7u,
+            pattern(_, _, in(8080, 8081, 8082))              = 8u,
+            pattern(_, _, _)                                 = 0u
+        );
+    }();
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("rule script", [&]
+    {
+        const auto& request = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = program->match(request).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        using namespace ptm;
+
+        const auto& request = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(request.method, request.status, request.port)
+        (
+            pattern("GET", range(200, 299), 443)             = 1u,
+            pattern("GET", range(300, 399), _)               = 2u,
+            pattern(in("PUT", "POST"), _x >= 500, _)         = 3u,
+            pattern(in("PUT", "POST"), range(200, 299), 443) = 4u,
+            pattern("DELETE", _, _x < 8050)                  = 5u,
+            pattern(_, _x == 404 || _x == 410, _)            = 6u,
+            pattern("HEAD", !(_x >= 200 && _x < 300), _)     = 7u,
+            pattern(_, _, in(8080, 8081, 8082))              = 8u,
+            pattern(_, _, _)                                 = 0u
+        ).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& request = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled(request.method, request.status, request.port).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+TEST_CASE("tuple_destructuring", "[tuple]")
+{
+    auto b = nanobench::Bench()
+        .title("Tuple Destructuring")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_tuple_data(0, 8, 100000);
+    std::size_t counter = 0;
+
+    const auto compiled = []
+    {
+        using namespace ptm;
+
+        return compile_match
+        (
+            pattern(ds(1, _, 1)) = 1,
+            pattern(ds(2, _, 2)) = 20,
+            pattern(ds(3, _, 3)) = 300,
+            pattern(ds(4, _, 4)) = 4000
+        );
+    }();
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        using namespace ptm;
+
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(x)
+        (
+            pattern(ds(1, _, 1)) = 1,
+            pattern(ds(2, _, 2)) = 20,
+            pattern(ds(3, _, 3)) = 300,
+            pattern(ds(4, _, 4)) = 4000
+        ).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled(x).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("if", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        int result;
+
+        int a = std::get<0>(x);
+        int b = std::get<2>(x);
+
+        if (a == 1 && b == 1)
+            result = 1;
+        else if (a == 2 && b == 2)
+            result = 20;
+        else if (a == 3 && b == 3)
+            result = 300;
+        else if (a == 4 && b == 4)
+            result = 4000;
+        else
+            result = 0;
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("switch", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        int result;
+
+        int a = std::get<0>(x);
+        int b = std::get<2>(x);
+
+        switch (a)
+        {
+            case 1:
+                switch (b)
+                {
+                    case 1: result = 1; break;
+                    default: result = 0; break;
+                }
+                break;
+
+            case 2:
+                switch (b)
+                {
+                    case 2: result = 20; break;
+                    default: result = 0; break;
+                }
+                break;
+
+            case 3:
+                switch (b)
+                {
+                    case 3: result = 300; break;
+                    default: result = 0; break;
+                }
+                break;
+
+            case 4:
+                switch (b)
+                {
+                    case 4: result = 4000; break;
+                    default: result = 0; break;
+                }
+                break;
+
+            default: result = 0; break;
+        }
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+namespace {
+
+#define TUPLE_CASE(a, b) case (b): return (a) * 10 + (b) + 1;
+#define TUPLE_ROW(a) case (a): switch (b) \
+    { \
+        TUPLE_CASE(a, 0) TUPLE_CASE(a, 1) TUPLE_CASE(a, 2) TUPLE_CASE(a, 3) TUPLE_CASE(a, 4) \
+        TUPLE_CASE(a, 5) TUPLE_CASE(a, 6) TUPLE_CASE(a, 7) TUPLE_CASE(a, 8) TUPLE_CASE(a, 9) \
+        default: return 0; \
+    }
+
+int switch_tuple_100(int a, int b)
+{
+    switch (a)
+    {
+        TUPLE_ROW(0) TUPLE_ROW(1) TUPLE_ROW(2) TUPLE_ROW(3) TUPLE_ROW(4)
+        TUPLE_ROW(5) TUPLE_ROW(6) TUPLE_ROW(7) TUPLE_ROW(8) TUPLE_ROW(9)
+        default: return 0;
+    }
+}
+
+#undef TUPLE_ROW
+#undef TUPLE_CASE
+
+template <std::size_t... I>
+int patum_values_tuple(const std::tuple<int, int, int>& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(ds(static_cast<int>(I / 10), _, static_cast<int>(I % 10))) = static_cast<int>(I) + 1)...,
+        pattern(_) = 0
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int compiled_values_tuple(const std::tuple<int, int, int>& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    static const auto compiled = compile_match
+    (
+        (pattern(ds(static_cast<int>(I / 10), _, static_cast<int>(I % 10))) = static_cast<int>(I) + 1)...,
+        pattern(_) = 0
+    );
+
+    return compiled(x).value_or(0);
+}
+
+template <std::size_t... I>
+int patum_literals_tuple(const std::tuple<int, int, int>& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        (pattern(ds(lit<static_cast<int>(I / 10)>, _, lit<static_cast<int>(I % 10)>)) = static_cast<int>(I) + 1)...,
+        pattern(_) = 0
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int if_tuple(const std::tuple<int, int, int>& x, std::index_sequence<I...>)
+{
+    const int a = std::get<0>(x);
+    const int b = std::get<2>(x);
+
+    int result = 0;
+
+    [[maybe_unused]] bool ignore = ((a == static_cast<int>(I / 10) && b == static_cast<int>(I % 10)
+        && (result = static_cast<int>(I) + 1, true)) || ...);
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("tuple_destructuring_100", "[tuple]")
+{
+    auto b = nanobench::Bench()
+        .title("Tuple Destructuring 100")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_tuple_data(0, 10, 100000);
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_values_tuple(x, std::make_index_sequence<100>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled_values_tuple(x, std::make_index_sequence<100>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum lit", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_literals_tuple(x, std::make_index_sequence<100>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("if", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = if_tuple(x, std::make_index_sequence<100>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("switch", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = switch_tuple_100(std::get<0>(x), std::get<2>(x));
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+TEST_CASE("branchless", "[branching]")
+{
+    auto b = nanobench::Bench()
+        .title("Branchless")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_data(0, 8, 100000);
+    std::size_t counter = 0;
+
+    const auto compiled = []
+    {
+        using namespace ptm;
+
+        return compile_match
+        (
+            pattern(_x < 1) = 1,
+            pattern(_x < 2) = 20,
+            pattern(_x < 3) = 300,
+            pattern(_x < 4) = 4000
+        );
+    }();
+
+    counter = 0;
+    b.run("patum", [&]
+    {
+        using namespace ptm;
+
+        auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(x)
+        (
+            pattern(_x < 1) = 1,
+            pattern(_x < 2) = 20,
+            pattern(_x < 3) = 300,
+            pattern(_x < 4) = 4000
+        ).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum compiled", [&]
+    {
+        auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = compiled(x).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("patum branchless", [&]
+    {
+        using namespace ptm;
+
+        auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = match(branchless, x)
+        (
+            pattern(_x < 1) = 1,
+            pattern(_x < 2) = 20,
+            pattern(_x < 3) = 300,
+            pattern(_x < 4) = 4000
+        ).value_or(0);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("if", [&]
+    {
+        auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        int result;
+
+        if (x < 1)
+            result = 1;
+        else if (x < 2)
+            result = 20;
+        else if (x < 3)
+            result = 300;
+        else if (x < 4)
+            result = 4000;
+        else
+            result = 0;
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+// Each tag covers a window of values overlapping the windows of its neighbours, so a value gets about a dozen tags
+template <std::size_t... I>
+std::uint64_t patum_tags_all(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match_all(x)
+    (
+        (pattern(lit_range<static_cast<int>(I) * 150, static_cast<int>(I) * 150 + 2000>) = I)...
+    ).to_ullong();
+}
+
+template <std::size_t... I>
+std::uint64_t patum_tags_separate(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    std::uint64_t result = 0;
+
+    ((result |= std::uint64_t(match(x)(pattern(lit_range<static_cast<int>(I) * 150, static_cast<int>(I) * 150 + 2000>) = true).value_or(false)) << I), ...);
+
+    return result;
+}
+
+template <std::size_t... I>
+std::uint64_t patum_predicate_tags_all(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match_all(x)
+    (
+        (pattern(_x >= static_cast<int>(I) * 150 && (_x & (1 << (I % 12))) != 0) = I)...
+    ).to_ullong();
+}
+
+template <std::size_t... I>
+std::uint64_t patum_predicate_tags_separate(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    std::uint64_t result = 0;
+
+    ((result |= std::uint64_t(match(x)(pattern(_x >= static_cast<int>(I) * 150 && (_x & (1 << (I % 12))) != 0) = true).value_or(false)) << I), ...);
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("match_all", "[all]")
+{
+    auto b = nanobench::Bench()
+        .title("Match All 64 Tags")
+        .warmup(100)
+        .minEpochIterations(2000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_data(-100, 64 * 150 + 2100, 100000);
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("match_all ranges", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_tags_all(x, std::make_index_sequence<64>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("64 matches ranges", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_tags_separate(x, std::make_index_sequence<64>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("match_all predicates", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_predicate_tags_all(x, std::make_index_sequence<64>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("64 matches predicates", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_predicate_tags_separate(x, std::make_index_sequence<64>{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+int if_chain_index(int x)
+{
+    if (x < 0) return 0;
+    if (x == 0) return 1;
+    if (x >= 1 && x <= 3) return 2;
+    if (x >= 40 && x <= 100) return 3;
+    if ((x & 1) == 0) return 4;
+    if (x > 1000) return 5;
+    return 6;
+}
+
+int patum_index(int x)
+{
+    using namespace ptm;
+
+    return static_cast<int>(match_index(x)
+    (
+        pattern(_x < 0),
+        pattern(0),
+        pattern(range(1, 3)),
+        pattern(range(40, 100)),
+        pattern((_x & 1) == 0),
+        pattern(_x > 1000)
+    ));
+}
+
+int patum_index_values(int x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(_x < 0)            = 0,
+        pattern(0)                 = 1,
+        pattern(range(1, 3))       = 2,
+        pattern(range(40, 100))    = 3,
+        pattern((_x & 1) == 0)     = 4,
+        pattern(_x > 1000)         = 5
+    ).value_or(6);
+}
+
+} // namespace
+
+TEST_CASE("match_index", "[index]")
+{
+    auto b = nanobench::Bench()
+        .title("Match Index")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_data(-10, 1100, 100000);
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("if chain", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = if_chain_index(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("match_index", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_index(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("match value_or", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_index_values(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+template <std::size_t... I>
+int patum_typed_events_optional(const bench_event_variant& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(typed<bench_event<I>>) = static_cast<int>(I) + 1 ...
+    ).value_or(-1);
+}
+
+template <std::size_t... I>
+int patum_typed_events_exhaustive(const bench_event_variant& x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match_exhaustive(x)
+    (
+        pattern(typed<bench_event<I>>) = static_cast<int>(I) + 1 ...
+    );
+}
+
+int visit_events_index(const bench_event_variant& x)
+{
+    return std::visit([]<std::size_t I>(const bench_event<I>&) { return static_cast<int>(I) + 1; }, x);
+}
+
+} // namespace
+
+TEST_CASE("match_exhaustive", "[exhaustive][variant]")
+{
+    auto b = nanobench::Bench()
+        .title("Match Exhaustive 37")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    std::vector<bench_event_variant> data;
+    for (const auto index : generate_data(0, 36, 100000))
+        data.push_back(make_event(static_cast<std::size_t>(index), bench_event_sequence{}));
+
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("match value_or", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_typed_events_optional(x, bench_event_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("match_exhaustive", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = patum_typed_events_exhaustive(x, bench_event_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("std::visit", [&]
+    {
+        const auto& x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = visit_events_index(x);
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+using heat_sequence = std::make_index_sequence<80>;
+
+// Handlers with enough work to spill the match across many cache lines once they are all inlined
+template <std::size_t I>
+constexpr auto heavy_handler = [](int v)
+{
+    auto h = static_cast<std::uint32_t>(v) * static_cast<std::uint32_t>(2 * I + 1);
+
+    for (std::uint32_t round = 0; round < 4; ++round)
+        h = (h ^ (h >> (round + I % 7 + 1))) * (0x9e3779b1u + static_cast<std::uint32_t>(I));
+
+    return static_cast<int>(h);
+};
+
+// The first arms are the hot ones, the others are rare and marked cold
+template <std::size_t I>
+constexpr auto heat_arm()
+{
+    using namespace ptm;
+
+    if constexpr (I < 4)
+        return pattern(lit<static_cast<int>(I)>) = heavy_handler<I>;
+    else
+        return pattern(lit<static_cast<int>(I)>).cold() = heavy_handler<I>;
+}
+
+template <std::size_t... I>
+int heavy_inlined(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(lit<static_cast<int>(I)>) = heavy_handler<I> ...,
+        pattern(_) = [](int) { return -1; }
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int heavy_outlined(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(outlined, x)
+    (
+        pattern(lit<static_cast<int>(I)>) = heavy_handler<I> ...,
+        pattern(_) = [](int) { return -1; }
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+int heavy_cold(int x, std::index_sequence<I...>)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        heat_arm<I>()...,
+        pattern(_).cold() = [](int) { return -1; }
+    ).value_or(0);
+}
+
+// Most subjects hit the four hot arms, one in twenty is spread over the rare ones
+std::vector<int> generate_heat_data(std::size_t size)
+{
+    auto data = generate_data(0, 99, size);
+
+    for (auto& x : data)
+        x = x < 95 ? x % 4 : 4 + (x * 7) % 76;
+
+    return data;
+}
+
+} // namespace
+
+TEST_CASE("outlined_handlers", "[outlined]")
+{
+    auto b = nanobench::Bench()
+        .title("Outlined Handlers 80")
+        .warmup(100)
+        .minEpochIterations(8000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const auto data = generate_heat_data(100000);
+    std::size_t counter = 0;
+
+    counter = 0;
+    b.run("inlined", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = heavy_inlined(x, heat_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("outlined", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = heavy_outlined(x, heat_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    counter = 0;
+    b.run("hot and cold", [&]
+    {
+        const auto x = data[counter];
+        counter = (++counter) % data.size();
+
+        auto result = heavy_cold(x, heat_sequence{});
+
+        nanobench::doNotOptimizeAway(result);
+    });
+
+    generate_output("html", html_boxplot, b);
+}
+
+//==================================================================================================
+
+namespace {
+
+// The linear fold in() evaluates for packs too small to be hashed
+template <class... Args>
+constexpr auto folded_in(Args... values)
+{
+    return ptm::speculative<ptm::predicate_cost::literal>([=](const auto& value_to_test) { return ((value_to_test == values) || ...); });
+}
+
+std::vector<int> generate_in_values(std::size_t size)
+{
+    std::vector<int> values(size);
+
+    for (std::size_t index = 0; index < size; ++index)
+        values[index] = static_cast<int>(index * 2);
+
+    return values;
+}
+
+std::vector<std::string> generate_in_strings(std::size_t size)
+{
+    std::vector<std::string> values(size);
+
+    for (std::size_t index = 0; index < size; ++index)
+        values[index] = "user-" + std::to_string(index * 2) + "@example.com";
+
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("in_pack", "[in]")
+{
+    using namespace ptm;
+    using namespace std::literals;
+
+    auto b = nanobench::Bench()
+        .title("In String Pack")
+        .warmup(100)
+        .minEpochIterations(4000000)
+        .performanceCounters(true)
+        .relative(true);
+
+    const std::array<std::string_view, 20> methods = {
+        "GET", "PUT", "POST", "HEAD", "PATCH", "TRACE", "DELETE", "OPTIONS", "CONNECT", "PROPFIND",
+        "PROPPATCH", "MKCOL", "COPY", "MOVE", "LOCK", "UNLOCK", "get", "put", "post", "BREW"
+    };
+
+    std::vector<std::string_view> data;
+    for (const auto index : generate_data(0, 19, 100000))
+        data.push_back(methods[static_cast<std::size_t>(index)]);
+
+    std::size_t counter = 0;
+
+    const auto run = [&](const char* name, const auto& values)
+    {
+        counter = 0;
+        b.run(name, [&]
+        {
+            const auto x = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = match(x)(pattern(values) = 1, pattern(_) = 2).value_or(0);
+
+            nanobench::doNotOptimizeAway(result);
+        });
+    };
+
+    run("fold 4", folded_in("GET"sv, "PUT"sv, "POST"sv, "HEAD"sv));
+    run("in 4", in("GET", "PUT", "POST", "HEAD"));
+    run("fold 12", folded_in("GET"sv, "PUT"sv, "POST"sv, "HEAD"sv, "PATCH"sv, "TRACE"sv, "DELETE"sv, "OPTIONS"sv,
+        "CONNECT"sv, "PROPFIND"sv, "PROPPATCH"sv, "MKCOL"sv));
+    run("in 12", in("GET", "PUT", "POST", "HEAD", "PATCH", "TRACE", "DELETE", "OPTIONS", "CONNECT", "PROPFIND", "PROPPATCH", "MKCOL"));
+    run("fold 16", folded_in("GET"sv, "PUT"sv, "POST"sv, "HEAD"sv, "PATCH"sv, "TRACE"sv, "DELETE"sv, "OPTIONS"sv,
+        "CONNECT"sv, "PROPFIND"sv, "PROPPATCH"sv, "MKCOL"sv, "COPY"sv, "MOVE"sv, "LOCK"sv, "UNLOCK"sv));
+    run("in 16", in("GET", "PUT", "POST", "HEAD", "PATCH", "TRACE", "DELETE", "OPTIONS",
+        "CONNECT", "PROPFIND", "PROPPATCH", "MKCOL", "COPY", "MOVE", "LOCK", "UNLOCK"));
+
+    generate_output("html", html_boxplot, b);
+}
+
+TEST_CASE("in_container", "[in]")
+{
+    using namespace ptm;
+
+    for (const std::size_t size : { std::size_t(4), std::size_t(64), std::size_t(4096), std::size_t(65536), std::size_t(1048576) })
+    {
+        auto b = nanobench::Bench()
+            .title("In Integers " + std::to_string(size))
+            .warmup(100)
+            .minEpochIterations(2000000)
+            .performanceCounters(true)
+            .relative(true);
+
+        const auto values = generate_in_values(size);
+        const auto data = generate_data(0, static_cast<int>(size * 2), 100000);
+
+        const auto allowed = in_set(values);
+        const std::unordered_set<int> hashed(values.begin(), values.end());
+
+        std::size_t counter = 0;
+
+        b.run("in", [&]
+        {
+            const auto x = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = match(x)(pattern(allowed) = 1, pattern(_) = 2).value_or(0);
+
+            nanobench::doNotOptimizeAway(result);
+        });
+
+        counter = 0;
+        b.run("std::unordered_set", [&]
+        {
+            const auto x = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = hashed.contains(x) ? 1 : 2;
+
+            nanobench::doNotOptimizeAway(result);
+        });
+
+        if (size <= 4096)
+        {
+            counter = 0;
+            b.run("std::ranges::find", [&]
+            {
+                const auto x = data[counter];
+                counter = (++counter) % data.size();
+
+                auto result = std::ranges::find(values, x) != values.end() ? 1 : 2;
+
+                nanobench::doNotOptimizeAway(result);
+            });
+        }
+
+        generate_output("html", html_boxplot, b);
+    }
+
+    for (const std::size_t size : { std::size_t(4), std::size_t(64), std::size_t(4096), std::size_t(65536), std::size_t(1048576) })
+    {
+        auto b = nanobench::Bench()
+            .title("In Strings " + std::to_string(size))
+            .warmup(100)
+            .minEpochIterations(2000000)
+            .performanceCounters(true)
+            .relative(true);
+
+        const auto values = generate_in_strings(size);
+
+        std::vector<std::string> data;
+        for (const auto index : generate_data(0, static_cast<int>(size * 2), 100000))
+            data.push_back("user-" + std::to_string(index) + "@example.com");
+
+        const auto allowed = in_set(values);
+        const std::unordered_set<std::string> hashed(values.begin(), values.end());
+
+        std::size_t counter = 0;
+
+        b.run("in", [&]
+        {
+            const auto& x = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = match(x)(pattern(allowed) = 1, pattern(_) = 2).value_or(0);
+
+            nanobench::doNotOptimizeAway(result);
+        });
+
+        counter = 0;
+        b.run("std::unordered_set", [&]
+        {
+            const auto& x = data[counter];
+            counter = (++counter) % data.size();
+
+            auto result = hashed.contains(x) ? 1 : 2;
+
+            nanobench::doNotOptimizeAway(result);
+        });
+
+        if (size <= 4096)
+        {
+            counter = 0;
+            b.run("std::ranges::find", [&]
+            {
+                const auto& x = data[counter];
+                counter = (++counter) % data.size();
+
+                auto result = std::ranges::find(values, x) != values.end() ? 1 : 2;
+
+                nanobench::doNotOptimizeAway(result);
+            });
+        }
+
+        generate_output("html", html_boxplot, b);
+    }
+}
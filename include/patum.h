@@ -13,11 +13,28 @@
 #include "patum/features.h"
 #include "patum/type_traits.h"
 #include "patum/tuple.h"
+#include "patum/value_set.h"
 #include "patum/struct.h"
 #include "patum/overload_set.h"
 #include "patum/predicate.h"
 #include "patum/wildcard.h"
+#include "patum/literal.h"
 #include "patum/matcher.h"
+#include "patum/outline.h"
 #include "patum/pattern.h"
+#include "patum/dispatch.h"
+#include "patum/simd.h"
+#include "patum/jump_table.h"
+#include "patum/interval_table.h"
+#include "patum/string_table.h"
+#include "patum/variant_table.h"
+#include "patum/decision_tree.h"
+#include "patum/domain_table.h"
+#include "patum/exhaustive.h"
+#include "patum/adaptive.h"
+#include "patum/profile.h"
+#include "patum/strategy.h"
 #include "patum/match_expression.h"
 #include "patum/match.h"
+#include "patum/match_all.h"
+#include "patum/compiled_match.h"
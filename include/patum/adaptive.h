@@ -0,0 +1,227 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "literal.h"
+#include "predicate.h"
+#include "variant_table.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t adaptive_hot_arms = 4;
+inline static constexpr std::size_t adaptive_max_arms = 0xffff;
+inline static constexpr std::uint32_t adaptive_period = 1024;
+
+//=================================================================================================
+
+template <class A, class B>
+consteval bool integral_less(A lhs, B rhs)
+{
+    if constexpr (std::is_signed_v<A>)
+    {
+        if (lhs < 0)
+            return not std::is_signed_v<B> || static_cast<std::intmax_t>(lhs) < static_cast<std::intmax_t>(rhs);
+    }
+
+    if constexpr (std::is_signed_v<B>)
+    {
+        if (rhs < 0)
+            return false;
+    }
+
+    return static_cast<std::uintmax_t>(lhs) < static_cast<std::uintmax_t>(rhs);
+}
+
+template <class P>
+struct literal_interval_bounds
+{
+    inline static constexpr bool valid = false;
+};
+
+template <class P>
+    requires(is_literal_v<P> && std::integral<std::remove_cvref_t<decltype(literal_value_v<P>)>>)
+struct literal_interval_bounds<P>
+{
+    inline static constexpr bool valid = true;
+
+    using value_type = std::remove_cvref_t<decltype(literal_value_v<P>)>;
+
+    inline static constexpr value_type first = literal_value_v<P>;
+    inline static constexpr value_type last = literal_value_v<P>;
+};
+
+template <class P>
+    requires is_literal_range_v<P>
+struct literal_interval_bounds<P> : literal_range_bounds<std::remove_cvref_t<P>>
+{
+    inline static constexpr bool valid = true;
+};
+
+// Two patterns are provably disjoint when no subject can match both of them. Literal values are only compared when
+// of the same type: the subject converts both of them the same way then, keeping distinct values distinct.
+template <class P, class Q>
+consteval bool are_disjoint_patterns()
+{
+    if constexpr (literal_interval_bounds<P>::valid && literal_interval_bounds<Q>::valid)
+    {
+        using lhs = literal_interval_bounds<P>;
+        using rhs = literal_interval_bounds<Q>;
+
+        if constexpr (not std::same_as<typename lhs::value_type, typename rhs::value_type>)
+            return false;
+        else
+            return integral_less(lhs::last, rhs::first) || integral_less(rhs::last, lhs::first);
+    }
+
+    else if constexpr (is_literal_v<P> && is_literal_v<Q>)
+    {
+        if constexpr (not std::same_as<decltype(literal_value_v<P>), decltype(literal_value_v<Q>)>)
+            return false;
+        else
+            return literal_value_v<P> != literal_value_v<Q>;
+    }
+
+    else if constexpr (is_literal_string_v<P> && is_literal_string_v<Q>)
+        return literal_string_value_v<P> != literal_string_value_v<Q>;
+
+    else if constexpr ((is_variant_type_v<P> || is_variant_value_v<P>) && (is_variant_type_v<Q> || is_variant_value_v<Q>))
+        return not std::same_as<variant_pattern_type_t<P>, variant_pattern_type_t<Q>>;
+
+    else
+        return false;
+}
+
+// Arms are disjoint when at least one of their columns is
+template <class Row, class Other>
+struct are_disjoint_rows;
+
+template <class... P, class... Q>
+struct are_disjoint_rows<std::tuple<P...>, std::tuple<Q...>>
+    : std::bool_constant<(false || ... || are_disjoint_patterns<std::remove_cvref_t<P>, std::remove_cvref_t<Q>>())>
+{
+};
+
+template <class Row>
+struct is_wildcard_row;
+
+template <class... P>
+struct is_wildcard_row<std::tuple<P...>> : std::bool_constant<(is_wildcard_v<P> && ...)>
+{
+};
+
+//=================================================================================================
+
+// Number of leading arms proven mutually exclusive, every arm when they all are. Only a last arm made of wildcards
+// can follow them, as it is only ever reached when none of them matches.
+template <class... Rows>
+struct disjoint_arms
+{
+    template <class Row>
+    static consteval std::array<bool, sizeof...(Rows)> disjoint_from()
+    {
+        return { are_disjoint_rows<Row, Rows>::value... };
+    }
+
+    static consteval std::size_t count_disjoint()
+    {
+        constexpr std::size_t arm_count = sizeof...(Rows);
+
+        const std::array<std::array<bool, arm_count>, arm_count> disjoint = { disjoint_from<Rows>()... };
+
+        const std::array<bool, arm_count> wildcards = { is_wildcard_row<Rows>::value... };
+
+        const std::size_t count = wildcards[arm_count - 1] ? arm_count - 1 : arm_count;
+
+        for (std::size_t arm = 0; arm < count; ++arm)
+        {
+            for (std::size_t other = arm + 1; other < count; ++other)
+            {
+                if (not disjoint[arm][other])
+                    return 0;
+            }
+        }
+
+        return count;
+    }
+
+    inline static constexpr std::size_t count = count_disjoint();
+
+    inline static constexpr bool value = count != 0 && sizeof...(Rows) <= adaptive_max_arms;
+};
+
+//=================================================================================================
+
+// Hit counters of a match site, with the arms hit most often packed into a single word so they are read atomically
+template <std::size_t ArmCount>
+struct adaptive_counters
+{
+    inline static constexpr std::uint64_t empty_slot = 0xffff;
+    inline static constexpr std::uint64_t no_hot_arms = ~std::uint64_t(0);
+
+    std::array<std::atomic<std::uint32_t>, ArmCount> hits{};
+    std::atomic<std::uint64_t> hot_arms{ no_hot_arms };
+
+    // Relaxed load and store instead of an atomic increment: a hit lost to a concurrent update only delays reordering
+    void record(std::size_t arm) noexcept
+    {
+        const auto count = hits[arm].load(std::memory_order_relaxed) + 1;
+        hits[arm].store(count, std::memory_order_relaxed);
+
+        if (count >= adaptive_period) [[unlikely]]
+            reorder();
+    }
+
+    // Promotes the arms hit most often (ties resolved in source order) and halves every counter, so the order follows
+    // shifts in the distribution of the subjects
+    void reorder() noexcept
+    {
+        std::array<std::uint32_t, adaptive_hot_arms> counts{};
+        std::uint64_t packed = no_hot_arms;
+
+        for (std::size_t arm = 0; arm < ArmCount; ++arm)
+        {
+            const auto count = hits[arm].load(std::memory_order_relaxed);
+            hits[arm].store(count / 2, std::memory_order_relaxed);
+
+            for (std::size_t slot = 0; slot < adaptive_hot_arms; ++slot)
+            {
+                if (count > counts[slot])
+                {
+                    for (std::size_t other = adaptive_hot_arms - 1; other > slot; --other)
+                        counts[other] = counts[other - 1];
+
+                    counts[slot] = count;
+
+                    const auto shift = slot * 16;
+                    const auto kept = packed & ((std::uint64_t(1) << shift) - 1);
+                    packed = kept | ((packed & ~((std::uint64_t(1) << shift) - 1)) << 16) | (std::uint64_t(arm) << shift);
+                    break;
+                }
+            }
+        }
+
+        hot_arms.store(packed, std::memory_order_relaxed);
+    }
+};
+
+template <class Site, std::size_t ArmCount>
+inline adaptive_counters<ArmCount> adaptive_site_counters{};
+
+} // namespace ptm
@@ -0,0 +1,114 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "match.h"
+#include "strategy.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+// Arms built once and matched against many subjects, as in
+//
+//   static const auto classify = compile_match(pattern(sregex("[0-9]+")) = 1, pattern(_) = 0);
+//   classify(x).value_or(-1);
+//
+// The patterns, their captured state (a regex, the values of an in) and the results are made once instead of on
+// every match, and the results are copied out instead of moved. The arms own copies of the values their patterns refer
+// to (see make_owned), so the object can outlive them.
+// Arms kept as distinct bases instead of in a std::tuple, whose recursive layout exceeds the instantiation depth of
+// the compilers with a few hundred arms. Empty arms (owned wildcards and a stateless result) are not allowed to overlap
+// the others, as GCC overwrites the arm they overlap when constructing them.
+template <std::size_t I, class M>
+struct compiled_arm
+{
+    M matcher;
+};
+
+template <class Sequence, class... M>
+struct compiled_arms;
+
+template <std::size_t... I, class... M>
+struct compiled_arms<std::index_sequence<I...>, M...> : compiled_arm<I, M>...
+{
+    template <class... U>
+        requires(sizeof...(U) == sizeof...(M) && (std::constructible_from<M, U> && ...))
+    constexpr explicit compiled_arms(U&&... matchers)
+        : compiled_arm<I, M>{ std::forward<U>(matchers) }...
+    {
+    }
+
+    template <class F>
+    constexpr decltype(auto) apply(F&& func) const
+    {
+        return std::forward<F>(func)(static_cast<const compiled_arm<I, M>&>(*this).matcher...);
+    }
+};
+
+template <class M>
+using owned_matcher_t = decltype(std::declval<M>().owned());
+
+template <class Policy, class... M>
+struct compiled_match
+{
+    inline static constexpr std::size_t capture_count = std::array<std::size_t, sizeof...(M)>{ M::capture_count... }[0];
+
+    static_assert(compatible_patterns_args<M...>(capture_count), "Patterns of a match must capture as many values");
+
+    template <class... U>
+        requires(sizeof...(U) == sizeof...(M) && (std::constructible_from<M, U> && ...))
+    constexpr explicit compiled_match(U&&... matchers)
+        : arms_(std::forward<U>(matchers)...)
+    {
+    }
+
+    template <class... E>
+        requires(sizeof...(E) == capture_count)
+    constexpr auto operator()(E&&... expressions) const
+    {
+        const std::tuple<E...> subjects(std::forward<E>(expressions)...);
+
+        return arms_.apply([&](const auto&... matchers)
+        {
+            return match_arms<Policy>(subjects, matchers...);
+        });
+    }
+
+private:
+    compiled_arms<std::index_sequence_for<M...>, M...> arms_;
+};
+
+template <class... M>
+    requires(not starts_with_policy_v<M...>
+        && compatible_patterns<std::remove_cvref_t<M>...>()
+        && sizeof...(M) != 0)
+[[nodiscard]] constexpr compiled_match<default_policy, owned_matcher_t<M>...> compile_match(M&&... matchers)
+{
+    return compiled_match<default_policy, owned_matcher_t<M>...>{ std::forward<M>(matchers).owned()... };
+}
+
+template <class Policy, class... M>
+    requires(is_match_policy_v<Policy>
+        && compatible_patterns<std::remove_cvref_t<M>...>()
+        && sizeof...(M) != 0
+        && policy_accepts_v<std::remove_cvref_t<Policy>, std::remove_cvref_t<M>...>)
+[[nodiscard]] constexpr compiled_match<std::remove_cvref_t<Policy>, owned_matcher_t<M>...> compile_match(Policy&&, M&&... matchers)
+{
+    return compiled_match<std::remove_cvref_t<Policy>, owned_matcher_t<M>...>{ std::forward<M>(matchers).owned()... };
+}
+
+} // namespace ptm
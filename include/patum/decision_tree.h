@@ -0,0 +1,391 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jump_table.h"
+#include "literal.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t decision_tree_max_columns = 64;
+inline static constexpr std::size_t decision_tree_max_nodes = 4096;
+inline static constexpr std::size_t decision_tree_max_slots = 65536;
+
+using decision_key = std::uint64_t;
+
+// Maps a column key to an unsigned value preserving the ordering of the keys inside the same column
+template <class K>
+constexpr decision_key to_decision_key(K key) noexcept
+{
+    if constexpr (std::is_signed_v<K>)
+        return static_cast<decision_key>(static_cast<std::int64_t>(key)) ^ (decision_key(1) << 63);
+    else
+        return static_cast<decision_key>(key);
+}
+
+//=================================================================================================
+
+struct decision_cell
+{
+    bool literal = false;
+    decision_key key = 0;
+};
+
+// Switch nodes move to the child selected by the key of their column, either through a dense slice of slots indexed
+// by the key offset or through a sorted slice of edges. Leaves are dense nodes without slots looping on themselves,
+// so a subject can always walk the same number of steps before reading the matched arm.
+struct decision_node
+{
+    std::uint32_t column = 0;
+    std::uint32_t first = 0;
+    std::uint32_t count = 0;
+    std::uint32_t fallback = 0;
+    std::uint32_t arm = 0;
+    bool dense = true;
+    decision_key min_key = 0;
+};
+
+struct decision_edge
+{
+    decision_key key = 0;
+    std::uint32_t target = 0;
+};
+
+//=================================================================================================
+
+template <class S, class... P>
+struct decision_column
+{
+    inline static constexpr bool has_literals = (false || ... || is_literal_v<P>);
+
+    inline static constexpr bool applicable = ((is_literal_v<P> || is_wildcard_v<P>) && ...)
+        && (not has_literals || literal_jump_table<S, P...>::applicable);
+
+    template <class Q>
+    static constexpr decision_cell cell() noexcept
+    {
+        if constexpr (is_literal_v<Q>)
+        {
+            using table_type = literal_jump_table_impl<S, P...>;
+            using common_key_type = typename table_type::common_key_type;
+            using key_type = typename table_type::key_type;
+
+            return { true, to_decision_key(static_cast<key_type>(static_cast<common_key_type>(literal_value_v<Q>))) };
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    static constexpr decision_key key(const S& subject) noexcept
+    {
+        if constexpr (has_literals)
+        {
+            using table_type = literal_jump_table_impl<S, P...>;
+            using common_key_type = typename table_type::common_key_type;
+            using key_type = typename table_type::key_type;
+
+            return to_decision_key(static_cast<key_type>(static_cast<common_key_type>(subject)));
+        }
+        else
+        {
+            return 0;
+        }
+    }
+};
+
+//=================================================================================================
+
+// Compiles a clause matrix of literal and wildcard cells into a decision tree (Maranget, "Compiling Pattern Matching
+// to Good Decision Trees"): each switch node tests a column once, sending the rows compatible with each literal to a
+// child where the column is not tested anymore, and the rows having a wildcard in the column to the default child.
+struct decision_tree_builder
+{
+    constexpr decision_tree_builder(const decision_cell* cells, std::size_t column_count, std::size_t arm_count)
+        : cells_(cells)
+        , column_count_(column_count)
+        , arm_count_(arm_count)
+    {
+        std::vector<std::uint32_t> rows(arm_count);
+
+        for (std::size_t row = 0; row < arm_count; ++row)
+            rows[row] = static_cast<std::uint32_t>(row);
+
+        build(rows, 0, 0);
+    }
+
+    constexpr const decision_cell& cell(std::uint32_t row, std::size_t column) const noexcept
+    {
+        return cells_[row * column_count_ + column];
+    }
+
+    constexpr std::uint32_t build(const std::vector<std::uint32_t>& rows, std::uint64_t tested_columns, std::size_t level)
+    {
+        const auto node_index = static_cast<std::uint32_t>(nodes.size());
+
+        nodes.push_back({ 0, 0, 0, node_index, static_cast<std::uint32_t>(arm_count_), true, 0 });
+
+        if (nodes.size() > decision_tree_max_nodes || slots.size() > decision_tree_max_slots)
+        {
+            overflow = true;
+            return node_index;
+        }
+
+        if (rows.empty())
+            return node_index;
+
+        // Test first the column that the first row needs, preferring the one most rows have a literal for
+        std::size_t column = column_count_;
+        std::size_t best_literals = 0;
+
+        for (std::size_t current = 0; current < column_count_; ++current)
+        {
+            if (((tested_columns >> current) & 1) != 0 || not cell(rows[0], current).literal)
+                continue;
+
+            std::size_t literals = 0;
+            for (const auto row : rows)
+                literals += cell(row, current).literal ? 1 : 0;
+
+            if (literals > best_literals)
+            {
+                column = current;
+                best_literals = literals;
+            }
+        }
+
+        if (column == column_count_)
+        {
+            nodes[node_index].arm = rows[0];
+            return node_index;
+        }
+
+        depth = std::max(depth, level + 1);
+
+        std::vector<decision_key> keys;
+        for (const auto row : rows)
+        {
+            if (cell(row, column).literal)
+                keys.push_back(cell(row, column).key);
+        }
+
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        const decision_key span = keys.back() - keys.front();
+        const bool dense = span < jump_table_max_span && span < keys.size() * jump_table_density_factor;
+
+        const auto first = static_cast<std::uint32_t>(dense ? slots.size() : edges.size());
+        const auto count = static_cast<std::uint32_t>(dense ? span + 1 : keys.size());
+
+        if (dense)
+            slots.resize(slots.size() + count, unassigned_slot);
+        else
+            edges.resize(edges.size() + count);
+
+        const std::uint64_t child_tested_columns = tested_columns | (std::uint64_t(1) << column);
+
+        for (std::size_t index = 0; index < keys.size() && not overflow; ++index)
+        {
+            std::vector<std::uint32_t> specialized;
+            for (const auto row : rows)
+            {
+                if (not cell(row, column).literal || cell(row, column).key == keys[index])
+                    specialized.push_back(row);
+            }
+
+            const auto target = build(specialized, child_tested_columns, level + 1);
+
+            if (dense)
+                slots[first + static_cast<std::size_t>(keys[index] - keys.front())] = target;
+            else
+                edges[first + index] = { keys[index], target };
+        }
+
+        std::vector<std::uint32_t> defaulted;
+        for (const auto row : rows)
+        {
+            if (not cell(row, column).literal)
+                defaulted.push_back(row);
+        }
+
+        const auto fallback = overflow ? node_index : build(defaulted, child_tested_columns, level + 1);
+
+        if (dense)
+        {
+            for (std::size_t index = first; index < first + count; ++index)
+                slots[index] = slots[index] == unassigned_slot ? fallback : slots[index];
+        }
+
+        nodes[node_index] = { static_cast<std::uint32_t>(column), first, count, fallback, 0, dense, keys.front() };
+
+        return node_index;
+    }
+
+    std::vector<decision_node> nodes;
+    std::vector<std::uint32_t> slots;
+    std::vector<decision_edge> edges;
+    std::size_t depth = 0;
+    bool overflow = false;
+
+private:
+    inline static constexpr std::uint32_t unassigned_slot = ~std::uint32_t(0);
+
+    const decision_cell* cells_;
+    std::size_t column_count_;
+    std::size_t arm_count_;
+};
+
+//=================================================================================================
+
+template <class Subjects, class... Rows>
+struct decision_tree_impl;
+
+template <class... S, class... Rows>
+struct decision_tree_impl<std::tuple<S...>, Rows...>
+{
+    inline static constexpr std::size_t column_count = sizeof...(S);
+    inline static constexpr std::size_t arm_count = sizeof...(Rows);
+
+    template <std::size_t C>
+    using column_type = decision_column<std::tuple_element_t<C, std::tuple<S...>>, std::tuple_element_t<C, Rows>...>;
+
+    template <std::size_t... C>
+    static consteval bool columns_applicable(std::index_sequence<C...>)
+    {
+        return (column_type<C>::applicable && ...) && (false || ... || column_type<C>::has_literals);
+    }
+
+    template <std::size_t... C>
+    static consteval auto make_cells(std::index_sequence<C...>)
+    {
+        std::array<decision_cell, column_count * arm_count> result{};
+        std::size_t index = 0;
+
+        ([&]<class Row>(std::type_identity<Row>)
+        {
+            ((result[index++] = column_type<C>::template cell<std::tuple_element_t<C, Row>>()), ...);
+        }(std::type_identity<Rows>{}), ...);
+
+        return result;
+    }
+
+    inline static constexpr auto cells = make_cells(std::make_index_sequence<column_count>{});
+
+    struct shape_type
+    {
+        std::size_t node_count;
+        std::size_t slot_count;
+        std::size_t edge_count;
+        std::size_t depth;
+        bool overflow;
+    };
+
+    inline static constexpr shape_type shape = []
+    {
+        const auto builder = decision_tree_builder(cells.data(), column_count, arm_count);
+
+        return shape_type{ builder.nodes.size(), builder.slots.size(), builder.edges.size(), builder.depth, builder.overflow };
+    }();
+
+    inline static constexpr bool applicable = []
+    {
+        if constexpr (column_count == 0 || column_count > decision_tree_max_columns || arm_count == 0)
+            return false;
+
+        else if constexpr (not columns_applicable(std::make_index_sequence<column_count>{}))
+            return false;
+
+        else
+            return not shape.overflow;
+    }();
+
+    struct tree_type
+    {
+        std::array<decision_node, shape.node_count> nodes;
+        std::array<std::uint32_t, shape.slot_count> slots;
+        std::array<decision_edge, shape.edge_count> edges;
+    };
+
+    inline static constexpr tree_type tree = []
+    {
+        const auto builder = decision_tree_builder(cells.data(), column_count, arm_count);
+
+        tree_type result{};
+        std::copy(builder.nodes.begin(), builder.nodes.end(), result.nodes.begin());
+        std::copy(builder.slots.begin(), builder.slots.end(), result.slots.begin());
+        std::copy(builder.edges.begin(), builder.edges.end(), result.edges.begin());
+
+        return result;
+    }();
+
+    template <class Tuple, std::size_t... C>
+    static constexpr std::array<decision_key, column_count> make_keys(const Tuple& subjects, std::index_sequence<C...>) noexcept
+    {
+        return { column_type<C>::key(std::get<C>(subjects))... };
+    }
+
+    static constexpr std::uint32_t dense_step(const decision_node& current, decision_key key) noexcept
+    {
+        const decision_key offset = key - current.min_key;
+
+        return offset < current.count ? tree.slots[current.first + offset] : current.fallback;
+    }
+
+    static constexpr std::uint32_t sparse_step(const decision_node& current, decision_key key) noexcept
+    {
+        std::size_t first = current.first;
+        std::size_t count = current.count;
+
+        while (count > 1)
+        {
+            const std::size_t half = count / 2;
+            first = tree.edges[first + half].key <= key ? first + half : first;
+            count -= half;
+        }
+
+        return tree.edges[first].key == key ? tree.edges[first].target : current.fallback;
+    }
+
+    template <class Tuple>
+    static constexpr std::size_t select(const Tuple& subjects) noexcept
+    {
+        const auto keys = make_keys(subjects, std::make_index_sequence<column_count>{});
+
+        std::uint32_t node = 0;
+
+        for (std::size_t step = 0; step < shape.depth; ++step)
+        {
+            const auto& current = tree.nodes[node];
+            const auto key = keys[current.column];
+
+            if constexpr (shape.edge_count == 0)
+                node = dense_step(current, key);
+            else
+                node = current.dense ? dense_step(current, key) : sparse_step(current, key);
+        }
+
+        return tree.nodes[node].arm;
+    }
+};
+
+} // namespace ptm
@@ -0,0 +1,164 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "features.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+// Turns a runtime index into a std::integral_constant using flat switches of 4, 16, 64 or 256 cases (nested
+// only past 256), so the compiler lowers them into a single jump table. Out of range indices are dispatched
+// to the last case (Count - 1).
+template <std::size_t Count>
+inline static constexpr std::size_t visit_index_width = Count <= 4 ? 4 : Count <= 16 ? 16 : Count <= 64 ? 64 : 256;
+
+template <std::size_t Count>
+inline static constexpr std::size_t visit_index_stride = []
+{
+    std::size_t stride = 1;
+
+    while (stride * 256 < Count)
+        stride *= 256;
+
+    return stride;
+}();
+
+template <std::size_t Base, std::size_t Stride, std::size_t End, std::size_t Count, class F>
+PATUM_ALWAYS_INLINE constexpr decltype(auto) visit_index_switch(std::size_t index, F& func);
+
+template <std::size_t Base, std::size_t Stride, std::size_t End, std::size_t Count, class F>
+PATUM_ALWAYS_INLINE constexpr decltype(auto) visit_index_case(std::size_t index, F& func)
+{
+    if constexpr (Base >= End)
+        return func(std::integral_constant<std::size_t, Count - 1>{});
+
+    else if constexpr (Stride == 1)
+        return func(std::integral_constant<std::size_t, Base>{});
+
+    else
+        return visit_index_switch<Base, Stride / 256, (Base + Stride < End ? Base + Stride : End), Count>(index, func);
+}
+
+#define PATUM_VISIT_INDEX_CASE(n) \
+    case (n): return visit_index_case<Base + (n) * Stride, Stride, End, Count>(index, func);
+
+#define PATUM_VISIT_INDEX_CASE4(n) \
+    PATUM_VISIT_INDEX_CASE((n) * 4 + 0) PATUM_VISIT_INDEX_CASE((n) * 4 + 1) \
+    PATUM_VISIT_INDEX_CASE((n) * 4 + 2) PATUM_VISIT_INDEX_CASE((n) * 4 + 3)
+
+#define PATUM_VISIT_INDEX_CASE16(n) \
+    PATUM_VISIT_INDEX_CASE4((n) * 4 + 0) PATUM_VISIT_INDEX_CASE4((n) * 4 + 1) \
+    PATUM_VISIT_INDEX_CASE4((n) * 4 + 2) PATUM_VISIT_INDEX_CASE4((n) * 4 + 3)
+
+#define PATUM_VISIT_INDEX_CASE64(n) \
+    PATUM_VISIT_INDEX_CASE16((n) * 4 + 0) PATUM_VISIT_INDEX_CASE16((n) * 4 + 1) \
+    PATUM_VISIT_INDEX_CASE16((n) * 4 + 2) PATUM_VISIT_INDEX_CASE16((n) * 4 + 3)
+
+#define PATUM_VISIT_INDEX_CASE256(n) \
+    PATUM_VISIT_INDEX_CASE64((n) * 4 + 0) PATUM_VISIT_INDEX_CASE64((n) * 4 + 1) \
+    PATUM_VISIT_INDEX_CASE64((n) * 4 + 2) PATUM_VISIT_INDEX_CASE64((n) * 4 + 3)
+
+template <std::size_t Base, std::size_t Stride, std::size_t End, std::size_t Count, class F>
+PATUM_ALWAYS_INLINE constexpr decltype(auto) visit_index_switch(std::size_t index, F& func)
+{
+    constexpr std::size_t width = visit_index_width<(End - Base + Stride - 1) / Stride>;
+
+    if constexpr (width == 4)
+    {
+        switch ((index - Base) / Stride)
+        {
+            PATUM_VISIT_INDEX_CASE4(0)
+            default: return func(std::integral_constant<std::size_t, Count - 1>{});
+        }
+    }
+    else if constexpr (width == 16)
+    {
+        switch ((index - Base) / Stride)
+        {
+            PATUM_VISIT_INDEX_CASE16(0)
+            default: return func(std::integral_constant<std::size_t, Count - 1>{});
+        }
+    }
+    else if constexpr (width == 64)
+    {
+        switch ((index - Base) / Stride)
+        {
+            PATUM_VISIT_INDEX_CASE64(0)
+            default: return func(std::integral_constant<std::size_t, Count - 1>{});
+        }
+    }
+    else
+    {
+        switch ((index - Base) / Stride)
+        {
+            PATUM_VISIT_INDEX_CASE256(0)
+            default: return func(std::integral_constant<std::size_t, Count - 1>{});
+        }
+    }
+}
+
+#undef PATUM_VISIT_INDEX_CASE256
+#undef PATUM_VISIT_INDEX_CASE64
+#undef PATUM_VISIT_INDEX_CASE16
+#undef PATUM_VISIT_INDEX_CASE4
+#undef PATUM_VISIT_INDEX_CASE
+
+template <std::size_t Count, class F>
+    requires(Count != 0)
+PATUM_ALWAYS_INLINE constexpr decltype(auto) visit_index(std::size_t index, F&& func)
+{
+    return visit_index_switch<0, visit_index_stride<Count>, Count, Count>(index, func);
+}
+
+//=================================================================================================
+
+// Flat (non recursive) pack of forwarding references, indexable at compile time without the deep
+// template instantiations a std::tuple needs when a match has hundreds of arms.
+template <std::size_t I, class T>
+struct forward_pack_element
+{
+    T&& value;
+};
+
+template <class Sequence, class... T>
+struct forward_pack_impl;
+
+template <std::size_t... I, class... T>
+struct forward_pack_impl<std::index_sequence<I...>, T...> : forward_pack_element<I, T>...
+{
+};
+
+template <class... T>
+using forward_pack = forward_pack_impl<std::index_sequence_for<T...>, T...>;
+
+template <std::size_t... I, class... T>
+constexpr forward_pack<T...> make_indexed_forward_pack(std::index_sequence<I...>, T&&... values) noexcept
+{
+    return { forward_pack_element<I, T>{ std::forward<T>(values) }... };
+}
+
+template <class... T>
+constexpr forward_pack<T...> make_forward_pack(T&&... values) noexcept
+{
+    return make_indexed_forward_pack(std::index_sequence_for<T...>{}, std::forward<T>(values)...);
+}
+
+template <std::size_t I, class T>
+constexpr T&& forward_pack_get(const forward_pack_element<I, T>& element) noexcept
+{
+    return std::forward<T>(element.value);
+}
+
+} // namespace ptm
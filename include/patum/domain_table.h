@@ -0,0 +1,245 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "predicate.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t domain_table_max_size = 256;
+
+//=================================================================================================
+
+// Specialize to declare the range of values a type can take, so matches on it can be resolved by a table:
+//
+//     template <>
+//     struct ptm::domain_range<color>
+//     {
+//         inline static constexpr color first = color::red;
+//         inline static constexpr color last = color::blue;
+//     };
+//
+// Subjects outside of the range are still matched, by checking the arms in order.
+template <class T>
+struct domain_range
+{
+};
+
+template <class T>
+concept declared_domain = requires
+{
+    { domain_range<T>::first } -> std::convertible_to<T>;
+    { domain_range<T>::last } -> std::convertible_to<T>;
+};
+
+template <class T>
+concept byte_domain = (std::integral<T> || std::is_enum_v<T>) && sizeof(T) == 1;
+
+//=================================================================================================
+
+// Patterns without any state can be recreated at compile time and evaluated on every value of the domain
+template <class P>
+struct stateless_pattern
+{
+    inline static constexpr bool value = std::is_empty_v<P> && std::default_initializable<P>;
+
+    static constexpr P make() noexcept
+    {
+        return P{};
+    }
+};
+
+template <class F, predicate_cost Cost>
+struct stateless_pattern<speculative_function<F, Cost>>
+{
+    inline static constexpr bool value = stateless_pattern<F>::value;
+
+    static constexpr speculative_function<F, Cost> make() noexcept
+    {
+        return { stateless_pattern<F>::make() };
+    }
+};
+
+template <class F, predicate_cost Cost>
+struct stateless_pattern<costed_function<F, Cost>>
+{
+    inline static constexpr bool value = stateless_pattern<F>::value;
+
+    static constexpr costed_function<F, Cost> make() noexcept
+    {
+        return { stateless_pattern<F>::make() };
+    }
+};
+
+template <class F>
+struct stateless_pattern<predicate<F>>
+{
+    inline static constexpr bool value = stateless_pattern<F>::value;
+
+    static constexpr predicate<F> make() noexcept
+    {
+        return predicate<F>(stateless_pattern<F>::make());
+    }
+};
+
+template <class F>
+struct stateless_pattern<wildcard<F>>
+{
+    inline static constexpr bool value = stateless_pattern<F>::value;
+
+    static constexpr wildcard<F> make() noexcept
+    {
+        return wildcard<F>(stateless_pattern<F>::make());
+    }
+};
+
+//=================================================================================================
+
+template <class S>
+struct domain_traits
+{
+    using key_type = typename std::conditional_t<std::is_enum_v<S>,
+        std::underlying_type<S>,
+        std::type_identity<std::conditional_t<std::same_as<S, bool>, unsigned char, S>>>::type;
+
+    inline static constexpr bool full = byte_domain<S> || std::same_as<S, bool>;
+
+    static constexpr key_type bound(bool lower) noexcept
+    {
+        if constexpr (std::same_as<S, bool>)
+            return lower ? 0 : 1;
+
+        else if constexpr (byte_domain<S>)
+            return lower ? std::numeric_limits<key_type>::min() : std::numeric_limits<key_type>::max();
+
+        else if constexpr (declared_domain<S>)
+            return static_cast<key_type>(lower ? S(domain_range<S>::first) : S(domain_range<S>::last));
+
+        else
+            return key_type{};
+    }
+
+    inline static constexpr key_type first = bound(true);
+    inline static constexpr key_type last = bound(false);
+
+    inline static constexpr std::size_t size = static_cast<std::size_t>(static_cast<std::make_unsigned_t<key_type>>(
+        static_cast<std::make_unsigned_t<key_type>>(last) - static_cast<std::make_unsigned_t<key_type>>(first))) + 1;
+};
+
+template <class S>
+inline static constexpr bool has_small_domain = []
+{
+    if constexpr (std::same_as<S, bool> || byte_domain<S>)
+        return true;
+
+    else if constexpr ((std::integral<S> || std::is_enum_v<S>) && declared_domain<S>)
+        return domain_traits<S>::first <= domain_traits<S>::last && domain_traits<S>::size <= domain_table_max_size;
+
+    else
+        return false;
+}();
+
+//=================================================================================================
+
+template <class S, class P>
+consteval bool evaluate_on_domain()
+{
+    using traits = domain_traits<S>;
+
+    const auto pattern = stateless_pattern<P>::make();
+
+    for (std::size_t offset = 0; offset < traits::size; ++offset)
+        (void)static_cast<bool>(evaluate_match(pattern, static_cast<S>(static_cast<typename traits::key_type>(traits::first + offset))));
+
+    return true;
+}
+
+// Evaluating the pattern on the whole domain has to be a constant expression, otherwise (a non constexpr predicate,
+// a pattern with undefined behaviour on some value) the table can't be built and the arms are checked at runtime
+template <class S, class P>
+concept domain_evaluable_pattern = stateless_pattern<P>::value
+    && requires { typename std::bool_constant<evaluate_on_domain<S, P>()>; };
+
+template <class S, class... P>
+struct literal_domain_table
+{
+    static consteval bool is_applicable()
+    {
+        if constexpr (not has_small_domain<S>)
+            return false;
+
+        else
+            return (domain_evaluable_pattern<S, P> && ...);
+    }
+
+    inline static constexpr bool applicable = is_applicable();
+};
+
+//=================================================================================================
+
+// Maps every value of a small domain to the first arm matching it, computed once at compile time
+template <class S, class... P>
+struct literal_domain_table_impl
+{
+    using traits = domain_traits<S>;
+    using key_type = typename traits::key_type;
+    using offset_type = std::make_unsigned_t<key_type>;
+
+    using index_type = std::conditional_t<(sizeof...(P) < 0xff), std::uint8_t, std::uint16_t>;
+
+    inline static constexpr std::size_t arm_count = sizeof...(P);
+
+    template <class Q>
+    static constexpr bool arm_matches(const S& subject) noexcept
+    {
+        return static_cast<bool>(evaluate_match(stateless_pattern<Q>::make(), subject));
+    }
+
+    inline static constexpr auto table = []
+    {
+        std::array<index_type, traits::size> result{};
+
+        for (std::size_t offset = 0; offset < traits::size; ++offset)
+        {
+            const auto subject = static_cast<S>(static_cast<key_type>(traits::first + offset));
+
+            std::size_t arm = 0;
+            [[maybe_unused]] const bool found = ((arm_matches<P>(subject) || (++arm, false)) || ...);
+
+            result[offset] = static_cast<index_type>(arm);
+        }
+
+        return result;
+    }();
+
+    // Subjects outside of a declared domain are not in the table, the caller is left to check the arms
+    inline static constexpr std::size_t outside_domain = arm_count + 1;
+
+    static constexpr std::size_t select(const S& subject) noexcept
+    {
+        const auto offset = static_cast<offset_type>(static_cast<offset_type>(static_cast<key_type>(subject)) - static_cast<offset_type>(traits::first));
+
+        if constexpr (traits::full)
+            return table[offset];
+        else
+            return offset < traits::size ? table[offset] : outside_domain;
+    }
+};
+
+} // namespace ptm
@@ -0,0 +1,201 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "domain_table.h"
+#include "type_traits.h"
+#include "variant_table.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t exhaustive_max_cells = 1024;
+
+//=================================================================================================
+
+// Values a subject can take, split in the classes an arm covers as a whole: the alternatives of a variant, the values of
+// a small domain, or a single class only wildcards cover for any other subject
+template <class S>
+struct subject_partition
+{
+    inline static constexpr std::size_t size = 1;
+
+    template <class P>
+    static consteval std::array<bool, size> covered() noexcept
+    {
+        return { is_wildcard_v<P> };
+    }
+};
+
+template <class S>
+    requires is_variant_v<S>
+struct subject_partition<S>
+{
+    inline static constexpr std::size_t size = std::variant_size_v<S>;
+
+    template <class P>
+    static consteval std::array<bool, size> covered() noexcept
+    {
+        return []<std::size_t... A>(std::index_sequence<A...>)
+        {
+            return std::array<bool, size>{ (classify_variant_arm<S, A, P>() == variant_arm_kind::always)... };
+        }(std::make_index_sequence<size>{});
+    }
+};
+
+// Declared domains take precedence over the whole range of byte sized enums, whose values are usually fewer
+template <class S>
+    requires(not is_variant_v<S> && has_small_domain<S>)
+struct subject_partition<S>
+{
+    using traits = domain_traits<S>;
+    using key_type = typename traits::key_type;
+    using offset_type = std::make_unsigned_t<key_type>;
+
+    static constexpr key_type bound(bool lower) noexcept
+    {
+        if constexpr (declared_domain<S>)
+            return static_cast<key_type>(lower ? S(domain_range<S>::first) : S(domain_range<S>::last));
+        else
+            return lower ? traits::first : traits::last;
+    }
+
+    inline static constexpr key_type first = bound(true);
+    inline static constexpr key_type last = bound(false);
+
+    inline static constexpr std::size_t size = static_cast<std::size_t>(static_cast<offset_type>(
+        static_cast<offset_type>(last) - static_cast<offset_type>(first))) + 1;
+
+    template <class P>
+    static consteval std::array<bool, size> covered() noexcept
+    {
+        std::array<bool, size> result{};
+
+        if constexpr (is_wildcard_v<P>)
+            result.fill(true);
+
+        else if constexpr (domain_evaluable_pattern<S, P>)
+        {
+            for (std::size_t offset = 0; offset < size; ++offset)
+            {
+                const auto subject = static_cast<S>(static_cast<key_type>(first + offset));
+
+                result[offset] = static_cast<bool>(evaluate_match(stateless_pattern<P>::make(), subject));
+            }
+        }
+
+        return result;
+    }
+};
+
+//=================================================================================================
+
+// Whether some arm matches whatever the subjects are, known without looking at them. Every combination of the classes
+// of the subjects has to be covered by an arm whose patterns all cover the class of their column, combinations too many
+// to be checked leaving only arms made of wildcards. Declared domains are taken at their word: an enum outside of its
+// ptm::domain_range isn't expected, as a variant valueless by exception isn't.
+template <class Subjects, class... Rows>
+struct exhaustive_arms
+{
+    inline static constexpr bool value = false;
+};
+
+template <class... S, class... Rows>
+struct exhaustive_arms<std::tuple<S...>, Rows...>
+{
+    inline static constexpr std::size_t subject_count = sizeof...(S);
+    inline static constexpr std::size_t arm_count = sizeof...(Rows);
+    inline static constexpr std::size_t cell_count = (subject_partition<S>::size * ... * 1);
+    inline static constexpr std::size_t class_total = (subject_partition<S>::size + ... + 0);
+
+    inline static constexpr std::array<std::size_t, subject_count> class_counts = { subject_partition<S>::size... };
+
+    template <class Row>
+    struct row_coverage;
+
+    template <class... P>
+    struct row_coverage<std::tuple<P...>>
+    {
+        inline static constexpr bool wildcards = (is_wildcard_v<P> && ...);
+
+        // Classes covered by each pattern, concatenated in the order of the subjects
+        static consteval std::array<bool, class_total> classes() noexcept
+        {
+            std::array<bool, class_total> result{};
+            std::size_t offset = 0;
+
+            const auto append = [&](const auto& covered)
+            {
+                for (const auto value : covered)
+                    result[offset++] = value;
+            };
+
+            (append(subject_partition<S>::template covered<std::remove_cvref_t<P>>()), ...);
+
+            return result;
+        }
+    };
+
+    static consteval bool cell_covered(const std::array<bool, class_total>& classes, std::size_t cell) noexcept
+    {
+        std::size_t offset = class_total;
+
+        for (std::size_t column = subject_count; column-- > 0;)
+        {
+            offset -= class_counts[column];
+
+            if (not classes[offset + cell % class_counts[column]])
+                return false;
+
+            cell /= class_counts[column];
+        }
+
+        return true;
+    }
+
+    static consteval bool is_exhaustive() noexcept
+    {
+        if constexpr ((false || ... || row_coverage<Rows>::wildcards))
+            return true;
+
+        else if constexpr (cell_count > exhaustive_max_cells)
+            return false;
+
+        else
+        {
+            const std::array<std::array<bool, class_total>, arm_count> rows = { row_coverage<Rows>::classes()... };
+
+            for (std::size_t cell = 0; cell < cell_count; ++cell)
+            {
+                bool covered = false;
+
+                for (std::size_t arm = 0; arm < arm_count && not covered; ++arm)
+                    covered = cell_covered(rows[arm], cell);
+
+                if (not covered)
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    inline static constexpr bool value = is_exhaustive();
+};
+
+} // namespace ptm
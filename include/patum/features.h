@@ -16,3 +16,69 @@
 #else
 #define PATUM_HAS_FEATURE_RE2 0
 #endif
+
+//=================================================================================================
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PATUM_ALWAYS_INLINE __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define PATUM_ALWAYS_INLINE [[msvc::forceinline]]
+#else
+#define PATUM_ALWAYS_INLINE
+#endif
+
+// Small functions only forwarding to others, inlined even in unoptimized builds and debugged as part of their caller, so
+// a debug build doesn't pay a call for every layer a pattern is evaluated through
+#if defined(__GNUC__) || defined(__clang__)
+#if __has_attribute(artificial)
+#define PATUM_FORWARDING_INLINE __attribute__((always_inline, artificial))
+#else
+#define PATUM_FORWARDING_INLINE __attribute__((always_inline))
+#endif
+#elif defined(_MSC_VER)
+#define PATUM_FORWARDING_INLINE [[msvc::forceinline]]
+#else
+#define PATUM_FORWARDING_INLINE
+#endif
+
+// Functions kept out of their callers, the cold ones being placed away from the hot code with their call paths unlikely
+#if defined(__GNUC__) || defined(__clang__)
+#define PATUM_NOINLINE __attribute__((noinline))
+#define PATUM_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define PATUM_NOINLINE __declspec(noinline)
+#define PATUM_COLD __declspec(noinline)
+#else
+#define PATUM_NOINLINE
+#define PATUM_COLD
+#endif
+
+// Labels as values, used by interpreters to jump straight to the code of the next instruction
+#if defined(__GNUC__) || defined(__clang__)
+#define PATUM_HAS_FEATURE_COMPUTED_GOTO 1
+#else
+#define PATUM_HAS_FEATURE_COMPUTED_GOTO 0
+#endif
+
+//=================================================================================================
+
+// Read only file mappings shared between processes, files are read in memory elsewhere
+#if defined(__unix__) || defined(__APPLE__)
+#define PATUM_HAS_FEATURE_MMAP 1
+#else
+#define PATUM_HAS_FEATURE_MMAP 0
+#endif
+
+//=================================================================================================
+
+#if defined(__AVX2__)
+#define PATUM_HAS_FEATURE_AVX2 1
+#else
+#define PATUM_HAS_FEATURE_AVX2 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PATUM_HAS_FEATURE_SSE2 1
+#else
+#define PATUM_HAS_FEATURE_SSE2 0
+#endif
@@ -0,0 +1,258 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "jump_table.h"
+#include "literal.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+template <class S, auto First, auto Last>
+struct jump_table_arm_type<S, predicate<literal_range<First, Last>>>
+{
+    using type = typename literal_range<First, Last>::value_type;
+};
+
+template <class S, class P>
+consteval bool is_interval_table_arm()
+{
+    if constexpr (is_literal_range_v<P>)
+        return std::integral<S> && not std::same_as<S, bool>;
+
+    else
+        return is_jump_table_arm<S, P>();
+}
+
+template <class S, class... P>
+consteval bool is_interval_table_dispatchable()
+{
+    if constexpr (not std::integral<S> || std::same_as<S, bool>)
+        return false;
+
+    else if constexpr (not (is_interval_table_arm<S, P>() && ...))
+        return false;
+
+    else if constexpr (not (false || ... || is_literal_range_v<P>))
+        return false;
+
+    else
+    {
+        // Same as for jump tables, the boundaries are only comparable when each arm compares using the common type
+        using K = common_type_fold_t<S, typename jump_table_arm_type<S, P>::type...>;
+
+        return (std::same_as<K, common_type_fold_t<S, typename jump_table_arm_type<S, P>::type>> && ...);
+    }
+}
+
+//=================================================================================================
+
+template <class S, class... P>
+struct literal_interval_table
+{
+    inline static constexpr bool applicable = is_interval_table_dispatchable<S, P...>();
+};
+
+//=================================================================================================
+
+// Resolves arms made of literal ranges (and literal values) by splitting the keys domain into segments, each one
+// assigned to the first arm covering it. Segments are looked up by their starting key, laid out in Eytzinger order
+// so the search is branchless and walks the tree from the root down in cache friendly order.
+template <class S, class... P>
+struct literal_interval_table_impl
+{
+    using key_type = common_type_fold_t<S, typename jump_table_arm_type<S, P>::type...>;
+
+    using index_type = std::conditional_t<(sizeof...(P) < 0xff), std::uint8_t, std::uint16_t>;
+
+    struct interval
+    {
+        key_type first;
+        key_type last;
+    };
+
+    inline static constexpr std::size_t arm_count = sizeof...(P);
+
+    template <class Q>
+    static constexpr interval arm_interval() noexcept
+    {
+        if constexpr (is_literal_range_v<Q>)
+            return { static_cast<key_type>(literal_range_bounds<std::remove_cvref_t<Q>>::first), static_cast<key_type>(literal_range_bounds<std::remove_cvref_t<Q>>::last) };
+
+        else if constexpr (is_literal_v<Q>)
+            return { static_cast<key_type>(literal_value_v<Q>), static_cast<key_type>(literal_value_v<Q>) };
+
+        else
+            return { std::numeric_limits<key_type>::min(), std::numeric_limits<key_type>::max() };
+    }
+
+    inline static constexpr std::array<interval, arm_count> arm_intervals = { arm_interval<P>()... };
+    inline static constexpr std::array<bool, arm_count> wildcard_arms = { is_wildcard_v<P>... };
+
+    // Arms after the first wildcard can never be selected
+    inline static constexpr std::size_t default_arm = []
+    {
+        for (std::size_t index = 0; index < arm_count; ++index)
+        {
+            if (wildcard_arms[index])
+                return index;
+        }
+
+        return arm_count;
+    }();
+
+    static constexpr std::size_t arm_at(key_type key) noexcept
+    {
+        for (std::size_t index = 0; index < default_arm; ++index)
+        {
+            if (arm_intervals[index].first <= key && key <= arm_intervals[index].last)
+                return index;
+        }
+
+        return default_arm;
+    }
+
+    // Every key where the first covering arm can change, starting from the lowest key
+    static constexpr auto collect_boundaries() noexcept
+    {
+        std::array<key_type, default_arm * 2 + 1> result{};
+        std::size_t count = 0;
+
+        result[count++] = std::numeric_limits<key_type>::min();
+
+        for (std::size_t index = 0; index < default_arm; ++index)
+        {
+            result[count++] = arm_intervals[index].first;
+
+            if (arm_intervals[index].last != std::numeric_limits<key_type>::max())
+                result[count++] = static_cast<key_type>(arm_intervals[index].last + 1);
+        }
+
+        std::sort(result.begin(), result.begin() + count);
+        count = static_cast<std::size_t>(std::unique(result.begin(), result.begin() + count) - result.begin());
+
+        return std::make_pair(result, count);
+    }
+
+    inline static constexpr std::size_t boundary_count = collect_boundaries().second;
+
+    inline static constexpr auto boundaries = []
+    {
+        const auto collected = collect_boundaries().first;
+
+        std::array<key_type, boundary_count> result{};
+        std::copy(collected.begin(), collected.begin() + boundary_count, result.begin());
+        return result;
+    }();
+
+    // Adjacent segments resolving to the same arm are merged
+    inline static constexpr std::size_t segment_count = []
+    {
+        std::size_t count = 0;
+        std::size_t last_arm = arm_count + 1;
+
+        for (const auto boundary : boundaries)
+        {
+            const auto arm = arm_at(boundary);
+
+            if (arm != last_arm)
+            {
+                last_arm = arm;
+                ++count;
+            }
+        }
+
+        return count;
+    }();
+
+    struct segment
+    {
+        key_type first;
+        index_type arm;
+    };
+
+    inline static constexpr auto segments = []
+    {
+        std::array<segment, segment_count> result{};
+        std::size_t count = 0;
+
+        for (const auto boundary : boundaries)
+        {
+            const auto arm = static_cast<index_type>(arm_at(boundary));
+
+            if (count == 0 || result[count - 1].arm != arm)
+                result[count++] = { boundary, arm };
+        }
+
+        return result;
+    }();
+
+    // Starts of the segments after the first one in Eytzinger order (1 based), each node holding the arm of the
+    // segment preceding it. Node 0 holds the arm of the last segment, reached when no start is above the key.
+    struct tree_type
+    {
+        std::array<key_type, segment_count> starts;
+        std::array<index_type, segment_count> preceding_arms;
+    };
+
+    inline static constexpr tree_type tree = []
+    {
+        tree_type result{};
+        std::size_t sorted = 1;
+
+        const auto fill = [&](auto& self, std::size_t node) -> void
+        {
+            if (node >= segment_count)
+                return;
+
+            self(self, node * 2);
+
+            result.starts[node] = segments[sorted].first;
+            result.preceding_arms[node] = segments[sorted - 1].arm;
+            ++sorted;
+
+            self(self, node * 2 + 1);
+        };
+
+        fill(fill, 1);
+
+        result.preceding_arms[0] = segments[segment_count - 1].arm;
+
+        return result;
+    }();
+
+    static constexpr std::size_t select(const S& subject) noexcept
+    {
+        const auto key = static_cast<key_type>(subject);
+
+        std::size_t node = 1;
+
+        while (node < segment_count)
+            node = node * 2 + (tree.starts[node] <= key ? 1 : 0);
+
+        // Drops the trailing right turns and the last left turn, leading to the first start above the key
+        node >>= std::countr_one(node) + 1;
+
+        return tree.preceding_arms[node];
+    }
+};
+
+} // namespace ptm
@@ -0,0 +1,289 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "literal.h"
+#include "simd.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t jump_table_max_span = 4096;
+inline static constexpr std::size_t jump_table_density_factor = 8;
+inline static constexpr std::size_t jump_table_vector_max_registers = 8;
+
+//=================================================================================================
+
+template <class S, class P>
+consteval bool is_jump_table_arm()
+{
+    if constexpr (is_wildcard_v<P>)
+        return true;
+
+    else if constexpr (not is_literal_v<P>)
+        return false;
+
+    else
+    {
+        using V = std::remove_cv_t<decltype(literal_value_v<P>)>;
+
+        if constexpr (std::is_enum_v<S> || std::is_enum_v<V>)
+            return std::same_as<S, V>;
+
+        else if constexpr (std::integral<S> && std::integral<V>)
+            return true;
+
+        else
+            return false;
+    }
+}
+
+template <class S, class P>
+struct jump_table_arm_type
+{
+    using type = S;
+};
+
+template <class S, auto V>
+struct jump_table_arm_type<S, predicate<literal<V>>>
+{
+    using type = std::remove_cv_t<decltype(V)>;
+};
+
+template <class S, class... P>
+consteval bool is_jump_table_dispatchable()
+{
+    if constexpr (not (std::integral<S> || std::is_enum_v<S>))
+        return false;
+
+    else if constexpr (not (is_jump_table_arm<S, P>() && ...))
+        return false;
+
+    else if constexpr (not (false || ... || is_literal_v<P>))
+        return false;
+
+    else
+    {
+        // Every literal arm has to be compared using the same common type as all the others, otherwise
+        // a table lookup would be able to give a different answer than a plain chain of comparisons
+        using K = common_type_fold_t<S, typename jump_table_arm_type<S, P>::type...>;
+
+        return (std::same_as<K, common_type_fold_t<S, typename jump_table_arm_type<S, P>::type>> && ...);
+    }
+}
+
+//=================================================================================================
+
+template <class S, class... P>
+struct literal_jump_table
+{
+    inline static constexpr bool applicable = is_jump_table_dispatchable<S, P...>();
+};
+
+//=================================================================================================
+
+template <class S, class... P>
+struct literal_jump_table_impl
+{
+    using common_key_type = common_type_fold_t<S, typename jump_table_arm_type<S, P>::type...>;
+
+    using key_type = typename std::conditional_t<std::is_enum_v<common_key_type>,
+        std::underlying_type<common_key_type>,
+        std::conditional_t<std::same_as<common_key_type, bool>,
+            std::type_identity<unsigned char>,
+            std::type_identity<common_key_type>>>::type;
+
+    using offset_type = std::make_unsigned_t<key_type>;
+
+    using index_type = std::conditional_t<(sizeof...(P) < 0xff), std::uint8_t, std::uint16_t>;
+
+    struct entry
+    {
+        key_type key;
+        index_type arm;
+    };
+
+    inline static constexpr std::size_t arm_count = sizeof...(P);
+
+    template <class Q>
+    static constexpr key_type arm_key() noexcept
+    {
+        if constexpr (is_literal_v<Q>)
+            return static_cast<key_type>(static_cast<common_key_type>(literal_value_v<Q>));
+        else
+            return key_type{};
+    }
+
+    inline static constexpr std::array<bool, arm_count> literal_arms = { is_literal_v<P>... };
+    inline static constexpr std::array<key_type, arm_count> arm_keys = { arm_key<P>()... };
+
+    inline static constexpr std::size_t default_arm = []
+    {
+        for (std::size_t index = 0; index < arm_count; ++index)
+        {
+            if (not literal_arms[index])
+                return index;
+        }
+
+        return arm_count;
+    }();
+
+    inline static constexpr auto sorted_arms = []
+    {
+        std::array<entry, arm_count> result{};
+
+        for (std::size_t index = 0; index < arm_count; ++index)
+            result[index] = { arm_keys[index], static_cast<index_type>(index) };
+
+        std::sort(result.begin(), result.end(), [](const entry& lhs, const entry& rhs)
+        {
+            return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.arm < rhs.arm);
+        });
+
+        return result;
+    }();
+
+    inline static constexpr std::size_t entry_count = []
+    {
+        std::size_t count = 0;
+        key_type last_key{};
+
+        for (const auto& current : sorted_arms)
+        {
+            if (current.arm >= default_arm)
+                continue;
+
+            if (count == 0 || last_key != current.key)
+            {
+                last_key = current.key;
+                ++count;
+            }
+        }
+
+        return count;
+    }();
+
+    // Sorted and unique literal keys, each one pointing to the first arm (in source order) using it
+    inline static constexpr auto entries = []
+    {
+        std::array<entry, entry_count> result{};
+        std::size_t count = 0;
+
+        for (const auto& current : sorted_arms)
+        {
+            if (current.arm >= default_arm)
+                continue;
+
+            if (count == 0 || result[count - 1].key != current.key)
+                result[count++] = current;
+        }
+
+        return result;
+    }();
+
+    inline static constexpr std::size_t span = entry_count == 0
+        ? 0
+        : static_cast<std::size_t>(static_cast<offset_type>(static_cast<offset_type>(entries[entry_count - 1].key) - static_cast<offset_type>(entries[0].key))) + 1;
+
+    inline static constexpr bool dense = entry_count != 0
+        && span <= jump_table_max_span
+        && span <= entry_count * jump_table_density_factor;
+
+    inline static constexpr auto dense_table = []
+    {
+        std::array<index_type, dense ? span : 1> result{};
+
+        result.fill(static_cast<index_type>(default_arm));
+
+        if constexpr (dense)
+        {
+            for (std::size_t index = 0; index < entry_count; ++index)
+                result[static_cast<offset_type>(static_cast<offset_type>(entries[index].key) - static_cast<offset_type>(entries[0].key))] = entries[index].arm;
+        }
+
+        return result;
+    }();
+
+    // Sparse keys fitting in a few vector registers are compared all at once instead of binary searched
+    inline static constexpr bool vectorized = not dense
+        && entry_count != 0
+        && entry_count * sizeof(key_type) <= jump_table_vector_max_registers * simd_register_bytes
+        && entry_count < std::numeric_limits<offset_type>::max();
+
+    inline static constexpr std::size_t vector_key_count = vectorized ? entry_count : 0;
+
+    inline static constexpr auto vector_keys = []
+    {
+        std::array<key_type, vector_key_count> keys{};
+
+        for (std::size_t index = 0; index < vector_key_count; ++index)
+            keys[index] = entries[index].key;
+
+        return simd_key_set<key_type, vector_key_count>::make(keys.data());
+    }();
+
+    // Default arm for a subject not found in the keys, followed by the arm of each vector key
+    inline static constexpr auto vector_arms = []
+    {
+        std::array<index_type, vector_key_count + 1> result{};
+
+        result[0] = static_cast<index_type>(default_arm);
+
+        for (std::size_t index = 0; index < vector_key_count; ++index)
+            result[index + 1] = entries[index].arm;
+
+        return result;
+    }();
+
+    static constexpr std::size_t select(const S& subject) noexcept
+    {
+        const auto key = static_cast<key_type>(static_cast<common_key_type>(subject));
+
+        if constexpr (entry_count == 0)
+        {
+            return default_arm;
+        }
+        else if constexpr (dense)
+        {
+            const auto offset = static_cast<offset_type>(static_cast<offset_type>(key) - static_cast<offset_type>(entries[0].key));
+
+            return offset < span ? dense_table[offset] : default_arm;
+        }
+        else if constexpr (vectorized)
+        {
+            return vector_arms[vector_keys.find(key)];
+        }
+        else
+        {
+            std::size_t first = 0;
+            std::size_t count = entry_count;
+
+            while (count > 1)
+            {
+                const std::size_t half = count / 2;
+                first = entries[first + half].key <= key ? first + half : first;
+                count -= half;
+            }
+
+            return entries[first].key == key ? entries[first].arm : default_arm;
+        }
+    }
+};
+
+} // namespace ptm
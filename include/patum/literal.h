@@ -0,0 +1,255 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#include "concepts.h"
+#include "predicate.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+template <auto V>
+struct literal
+{
+    using value_type = decltype(V);
+
+    inline static constexpr value_type value = V;
+
+    template <class U>
+        requires std::equality_comparable_with<value_type, U>
+    PATUM_FORWARDING_INLINE constexpr bool operator()(const U& value_to_test) const
+    {
+        return value_to_test == V;
+    }
+};
+
+//=================================================================================================
+
+template <auto V>
+inline static constexpr auto lit = predicate(literal<V>{});
+
+//=================================================================================================
+
+template <class T>
+struct is_literal : std::false_type
+{
+};
+
+template <auto V>
+struct is_literal<predicate<literal<V>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_literal_v = is_literal<std::remove_cvref_t<T>>::value;
+
+template <auto V>
+struct is_speculatable<predicate<literal<V>>> : std::true_type
+{
+};
+
+template <auto V>
+struct predicate_cost_of<predicate<literal<V>>> : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
+
+//=================================================================================================
+
+template <class T>
+struct literal_value;
+
+template <auto V>
+struct literal_value<predicate<literal<V>>>
+{
+    inline static constexpr auto value = V;
+};
+
+template <class T>
+inline static constexpr auto literal_value_v = literal_value<std::remove_cvref_t<T>>::value;
+
+//=================================================================================================
+
+// Result known at compile time, as in pattern(lit<1>) = val<10>. Arms selected through a table and yielding these
+// are read from a single static table of results, instead of one gathered from the arms on every match.
+template <auto V>
+struct constant_result
+{
+    using value_type = decltype(V);
+
+    inline static constexpr value_type value = V;
+
+    PATUM_FORWARDING_INLINE constexpr value_type operator()() const noexcept
+    {
+        return V;
+    }
+};
+
+template <auto V>
+inline static constexpr constant_result<V> val{};
+
+template <class T>
+struct is_constant_result : std::false_type
+{
+};
+
+template <auto V>
+struct is_constant_result<constant_result<V>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_constant_result_v = is_constant_result<std::remove_cvref_t<T>>::value;
+
+//=================================================================================================
+
+// Compile time inclusive range, the literal counterpart of range(first, last)
+template <auto First, auto Last>
+    requires(std::integral<decltype(First)> && std::integral<decltype(Last)>)
+struct literal_range
+{
+    using value_type = std::common_type_t<decltype(First), decltype(Last)>;
+
+    inline static constexpr value_type first = First;
+    inline static constexpr value_type last = Last;
+
+    static_assert(first <= last, "Range first value must not be greater than its last value");
+
+    template <class U>
+        requires std::totally_ordered_with<value_type, U>
+    PATUM_FORWARDING_INLINE constexpr bool operator()(const U& value_to_test) const
+    {
+        return value_to_test >= first and value_to_test <= last;
+    }
+};
+
+template <auto First, auto Last>
+inline static constexpr auto lit_range = predicate(literal_range<First, Last>{});
+
+//=================================================================================================
+
+template <class T>
+struct is_literal_range : std::false_type
+{
+};
+
+template <auto First, auto Last>
+struct is_literal_range<predicate<literal_range<First, Last>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_literal_range_v = is_literal_range<std::remove_cvref_t<T>>::value;
+
+template <auto First, auto Last>
+struct is_speculatable<predicate<literal_range<First, Last>>> : std::true_type
+{
+};
+
+template <auto First, auto Last>
+struct predicate_cost_of<predicate<literal_range<First, Last>>> : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
+
+template <class T>
+struct literal_range_bounds;
+
+template <auto First, auto Last>
+struct literal_range_bounds<predicate<literal_range<First, Last>>>
+{
+    using value_type = typename literal_range<First, Last>::value_type;
+
+    inline static constexpr value_type first = First;
+    inline static constexpr value_type last = Last;
+};
+
+//=================================================================================================
+
+// Structural string usable as a template argument, so string literals can be known at compile time
+template <std::size_t N>
+struct fixed_string
+{
+    constexpr fixed_string(const char (&text)[N]) noexcept
+    {
+        for (std::size_t index = 0; index < N; ++index)
+            data[index] = text[index];
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return N - 1;
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+        return { data, N - 1 };
+    }
+
+    char data[N] = {};
+};
+
+template <fixed_string S>
+struct literal_string
+{
+    inline static constexpr std::string_view value = S.view();
+
+    template <class U>
+        requires StringLike<U>
+    PATUM_FORWARDING_INLINE constexpr bool operator()(const U& value_to_test) const
+    {
+        return std::string_view(value_to_test) == value;
+    }
+};
+
+template <fixed_string S>
+inline static constexpr auto lit_str = predicate(literal_string<S>{});
+
+//=================================================================================================
+
+template <class T>
+struct is_literal_string : std::false_type
+{
+};
+
+template <fixed_string S>
+struct is_literal_string<predicate<literal_string<S>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_literal_string_v = is_literal_string<std::remove_cvref_t<T>>::value;
+
+template <fixed_string S>
+struct is_speculatable<predicate<literal_string<S>>> : std::true_type
+{
+};
+
+template <fixed_string S>
+struct predicate_cost_of<predicate<literal_string<S>>> : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
+
+template <class T>
+struct literal_string_value;
+
+template <fixed_string S>
+struct literal_string_value<predicate<literal_string<S>>>
+{
+    inline static constexpr std::string_view value = literal_string<S>::value;
+};
+
+template <class T>
+inline static constexpr std::string_view literal_string_value_v = literal_string_value<std::remove_cvref_t<T>>::value;
+
+} // namespace ptm
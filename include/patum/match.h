@@ -9,10 +9,21 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 #include <optional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
+#include "dispatch.h"
+#include "exhaustive.h"
+#include "expect.h"
+#include "features.h"
 #include "match_expression.h"
+#include "outline.h"
+#include "strategy.h"
+#include "pattern.h"
+#include "type_traits.h"
 
 namespace ptm {
 
@@ -32,77 +43,325 @@ constexpr bool compatible_patterns_args(std::size_t count) noexcept
 
 //=================================================================================================
 
-template <class M, class E>
-constexpr auto match_expressions(const M& matcher, const E& expressions)
+// Same as std::apply, without the layers of calls unoptimized builds would go through for every arm
+template <class F, class E>
+PATUM_FORWARDING_INLINE constexpr decltype(auto) apply_expressions(F&& function, E&& expressions)
 {
-    return std::apply([&](const auto&... ex)
+    return [&]<std::size_t... I>(std::index_sequence<I...>) PATUM_ALWAYS_INLINE -> decltype(auto)
     {
-        return matcher.check(ex...);
-    }, expressions);
+        return std::forward<F>(function)(std::get<I>(std::forward<E>(expressions))...);
+    }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<E>>>{});
+}
+
+template <class M, class E>
+PATUM_FORWARDING_INLINE constexpr bool match_expressions(const M& matcher, const E& expressions)
+{
+    return matcher.check_tuple(expressions);
 }
 
 template <class M, class E>
-constexpr auto test_expressions(const M& matcher, E&& expressions)
+PATUM_FORWARDING_INLINE constexpr auto test_expressions(const M& matcher, E&& expressions)
 {
-    return std::apply([&]<class... E2>(E2&&... ex)
+    return apply_expressions([&]<class... E2>(E2&&... ex) PATUM_ALWAYS_INLINE
     {
         return matcher.get(std::forward<E2>(ex)...);
     }, std::forward<E>(expressions));
 }
 
-template <class R, class M, class E>
-constexpr void invoke_result_expressions(std::optional<R>& result, M&& matcher, E&& expressions)
+// Handlers called out of line under ptm::outlined, unless their arm tells where they go
+template <class Policy, class M>
+inline static constexpr bool outlined_arm_v = std::same_as<Policy, outlined_policy>
+    && is_callable_v<typename matcher_traits<std::remove_cvref_t<M>>::result_type>
+    && not is_constant_result_v<typename matcher_traits<std::remove_cvref_t<M>>::result_type>
+    && arm_heat_v<typename matcher_traits<std::remove_cvref_t<M>>::result_type> == arm_heat::automatic;
+
+template <class Policy, class M, class... U>
+PATUM_ALWAYS_INLINE constexpr decltype(auto) get_arm(M&& matcher, U&&... values_to_test)
+{
+    if constexpr (outlined_arm_v<Policy, M>)
+        return get_outlined(std::forward<M>(matcher), std::forward<U>(values_to_test)...);
+    else
+        return std::forward<M>(matcher).get(std::forward<U>(values_to_test)...);
+}
+
+template <class Policy = default_policy, class R, class M, class E>
+PATUM_FORWARDING_INLINE constexpr void invoke_result_expressions(std::optional<R>& result, M&& matcher, E&& expressions)
 {
-    std::apply([&, m = std::forward<M>(matcher)]<class... E2>(E2&&... ex) mutable
+    apply_expressions([&]<class... E2>(E2&&... ex) PATUM_ALWAYS_INLINE
     {
-        if constexpr (std::same_as<decltype(m.get(std::forward<E2>(ex)...)), void>)
-            std::move(m).get(std::forward<E2>(ex)...);
+        if constexpr (std::same_as<decltype(std::forward<M>(matcher).get(std::forward<E2>(ex)...)), void>)
+            get_arm<Policy>(std::forward<M>(matcher), std::forward<E2>(ex)...);
         else
-            result.emplace(std::move(m).get(std::forward<E2>(ex)...));
+            result.emplace(get_arm<Policy>(std::forward<M>(matcher), std::forward<E2>(ex)...));
     }, std::forward<E>(expressions));
 }
 
-template <class M, class E>
-constexpr void invoke_expressions(M&& matcher, E&& expressions)
+template <class Policy = default_policy, class M, class E>
+PATUM_FORWARDING_INLINE constexpr void invoke_expressions(M&& matcher, E&& expressions)
 {
-    std::apply([m = std::forward<M>(matcher)]<class... E2>(E2&&... ex) mutable
+    apply_expressions([&]<class... E2>(E2&&... ex) PATUM_ALWAYS_INLINE
     {
-        std::move(m).get(std::forward<E2>(ex)...);
+        get_arm<Policy>(std::forward<M>(matcher), std::forward<E2>(ex)...);
     }, std::forward<E>(expressions));
 }
 
+inline static constexpr std::size_t result_values_max_arms = 128;
+
+template <class R, class... M>
+inline static constexpr bool has_result_values = sizeof...(M) <= result_values_max_arms
+    && not std::same_as<R, not_found_t>
+    && std::is_trivially_copyable_v<R>
+    && not is_callable_v<R>
+    && (std::same_as<std::remove_cvref_t<typename matcher_traits<std::remove_cvref_t<M>>::result_type>, R> && ...);
+
+template <class M>
+using matcher_result_t = typename matcher_traits<std::remove_cvref_t<M>>::result_type;
+
+template <class R, class... M>
+inline static constexpr bool has_constant_results = not std::same_as<R, not_found_t>
+    && std::is_trivially_copyable_v<R>
+    && (is_constant_result_v<matcher_result_t<M>> && ...);
+
+// Results of arms yielding ptm::val, shared by every match over the same arms whatever their count
+template <class R, class... M>
+inline static constexpr R constant_results[] = { static_cast<R>(std::remove_cvref_t<matcher_result_t<M>>::value)... };
+
+template <class R, class Policy, class E, class... M>
+PATUM_ALWAYS_INLINE constexpr auto invoke_selected_expressions(std::size_t index, E&& expressions, M&&... matchers)
+{
+    if constexpr (has_constant_results<R, M...>)
+    {
+        return index < sizeof...(M) ? std::optional<R>(constant_results<R, M...>[index]) : std::nullopt;
+    }
+    else if constexpr (has_result_values<R, M...> && std::same_as<Policy, branchless_policy>)
+    {
+        // The no match case is part of the table too, so a frequent miss doesn't become a mispredicted branch
+        const std::optional<R> values[] = { test_expressions(matchers, expressions)..., std::nullopt };
+
+        return values[index];
+    }
+    else if constexpr (has_result_values<R, M...>)
+    {
+        // Arms yielding plain values are looked up in a table instead of being jumped to, like a compiler does
+        // for a switch returning constants, which avoids the indirect branch on unpredictable subjects
+        const R values[] = { test_expressions(matchers, expressions)... };
+
+        return index < sizeof...(M) ? std::optional<R>(values[index]) : std::nullopt;
+    }
+    else if constexpr (std::same_as<R, not_found_t>)
+    {
+        auto arms = make_forward_pack(std::forward<M>(matchers)...);
+
+        visit_index<sizeof...(M) + 1>(index, [&]<std::size_t I>(std::integral_constant<std::size_t, I>) PATUM_ALWAYS_INLINE
+        {
+            if constexpr (I < sizeof...(M))
+                invoke_expressions<Policy>(forward_pack_get<I>(arms), std::forward<E>(expressions));
+        });
+    }
+    else
+    {
+        auto arms = make_forward_pack(std::forward<M>(matchers)...);
+        std::optional<R> result;
+
+        visit_index<sizeof...(M) + 1>(index, [&]<std::size_t I>(std::integral_constant<std::size_t, I>) PATUM_ALWAYS_INLINE
+        {
+            if constexpr (I < sizeof...(M))
+                invoke_result_expressions<Policy>(result, forward_pack_get<I>(arms), std::forward<E>(expressions));
+        });
+
+        return result;
+    }
+}
+
 //=================================================================================================
 
-template <class... E>
-struct match_helper
+// Selects and invokes the arm matching the expressions. Matchers passed as rvalues have their results moved out, the
+// ones passed as lvalues are left untouched so they can be invoked again (see ptm::compiled_match).
+template <class Policy, class... E, class... M>
+constexpr auto match_arms(const std::tuple<E...>& expressions, M&&... matchers)
+{
+    using ReturnType = non_void_common_type_t<decltype(test_expressions(matchers, expressions))...>;
+    using Strategy = match_strategy_t<Policy, type_list<E...>, type_list<std::remove_cvref_t<M>...>>;
+
+    if constexpr (not std::same_as<Strategy, linear_strategy>)
+    {
+        return invoke_selected_expressions<ReturnType, Policy>(Strategy::select(expressions, matchers...),
+            expressions, std::forward<M>(matchers)...);
+    }
+    else if constexpr (std::same_as<ReturnType, not_found_t>)
+    {
+        [[maybe_unused]] auto ignore = ((match_expressions(matchers, expressions)
+            && (void(invoke_expressions<Policy>(std::forward<M>(matchers), expressions)), 1)) || ...);
+    }
+    else
+    {
+        std::optional<ReturnType> result;
+
+        [[maybe_unused]] auto ignore = ((match_expressions(matchers, expressions)
+            && (void(invoke_result_expressions<Policy>(result, std::forward<M>(matchers), expressions)), 1)) || ...);
+
+        return result;
+    }
+}
+
+// Index of the arm matching the expressions, or the number of arms when none does
+template <class Policy, class... E, class... M>
+constexpr std::size_t select_arm(const std::tuple<E...>& expressions, const M&... matchers)
 {
-    constexpr explicit match_helper(E&&... expressions)
-        : expressions_(std::forward_as_tuple(expressions...))
+    using Strategy = match_strategy_t<Policy, type_list<E...>, type_list<std::remove_cvref_t<M>...>>;
+
+    if constexpr (not std::same_as<Strategy, linear_strategy>)
+    {
+        return Strategy::select(expressions, matchers...);
+    }
+    else
+    {
+        return [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            std::size_t index = sizeof...(M);
+
+            [[maybe_unused]] auto ignore = ((check_expressions(matchers, expressions) && (void(index = I), true)) || ...);
+
+            return index;
+        }(std::index_sequence_for<M...>{});
+    }
+}
+
+//=================================================================================================
+
+template <class Policy, class... E>
+struct basic_match_helper
+{
+    PATUM_FORWARDING_INLINE constexpr explicit basic_match_helper(E&&... expressions)
+        : expressions_(std::forward<E>(expressions)...)
     {
     }
 
     template <class... M>
         requires(compatible_patterns<M...>()
             && compatible_patterns_args<M...>(sizeof...(E))
-            && sizeof...(M) != 0)
+            && sizeof...(M) != 0
+            && policy_accepts_v<Policy, std::remove_cvref_t<M>...>)
     constexpr auto operator()(M&&... matchers) const
     {
-        using ReturnType = non_void_common_type_t<decltype(test_expressions(matchers, expressions_))...>;
+        return match_arms<Policy>(expressions_, std::forward<M>(matchers)...);
+    }
+
+private:
+    std::tuple<E...> expressions_;
+};
+
+template <class... E>
+using match_helper = basic_match_helper<default_policy, E...>;
+
+template <class... Args>
+inline static constexpr bool starts_with_policy_v = false;
 
-        if constexpr (std::same_as<ReturnType, not_found_t>)
+template <class T, class... Args>
+inline static constexpr bool starts_with_policy_v<T, Args...> = is_match_policy_v<T>;
+
+template <class... Args>
+    requires(not starts_with_policy_v<Args...>)
+[[nodiscard]] PATUM_FORWARDING_INLINE constexpr match_helper<Args...> match(Args&&... args)
+{
+    return match_helper<Args...>{ std::forward<Args>(args)... };
+}
+
+template <class Policy, class... Args>
+    requires is_match_policy_v<Policy>
+[[nodiscard]] constexpr basic_match_helper<std::remove_cvref_t<Policy>, Args...> match(Policy&&, Args&&... args)
+{
+    return basic_match_helper<std::remove_cvref_t<Policy>, Args...>{ std::forward<Args>(args)... };
+}
+
+//=================================================================================================
+
+// Index of the arm matching the expressions, the last one being taken without a check as no other can match there
+template <class Policy, class... E, class... M>
+constexpr std::size_t select_exhaustive_arm(const std::tuple<E...>& expressions, const M&... matchers)
+{
+    using Strategy = match_strategy_t<Policy, type_list<E...>, type_list<std::remove_cvref_t<M>...>>;
+
+    if constexpr (not std::same_as<Strategy, linear_strategy>)
+    {
+        const std::size_t index = Strategy::select(expressions, matchers...);
+
+        expect(index < sizeof...(M));
+        return index;
+    }
+    else
+    {
+        return [&]<std::size_t... I>(std::index_sequence<I...>)
         {
-            [[maybe_unused]] auto ignore = ((match_expressions(matchers, expressions_)
-                && (void(invoke_expressions(std::forward<M>(matchers), expressions_)), 1)) || ...);
-        }
-        else
+            std::size_t index = sizeof...(M) - 1;
+
+            [[maybe_unused]] auto ignore = (((I + 1 < sizeof...(M)) && check_expressions(matchers, expressions)
+                && (void(index = I), true)) || ...);
+
+            return index;
+        }(std::index_sequence_for<M...>{});
+    }
+}
+
+// Selects and invokes the arm matching the expressions, which some arm always does, so the result is returned as is
+// instead of through a std::optional. Subjects no arm can match break the precondition and are handed to the last arm.
+template <class Policy, class... E, class... M>
+constexpr auto match_exhaustive_arms(const std::tuple<E...>& expressions, M&&... matchers)
+{
+    using ReturnType = non_void_common_type_t<decltype(test_expressions(matchers, expressions))...>;
+
+    const std::size_t index = select_exhaustive_arm<Policy>(expressions, matchers...);
+
+    if constexpr (has_constant_results<ReturnType, M...>)
+    {
+        return constant_results<ReturnType, M...>[index < sizeof...(M) ? index : sizeof...(M) - 1];
+    }
+    else if constexpr (has_result_values<ReturnType, M...>)
+    {
+        const ReturnType values[] = { test_expressions(matchers, expressions)... };
+
+        return values[index < sizeof...(M) ? index : sizeof...(M) - 1];
+    }
+    else
+    {
+        auto arms = make_forward_pack(std::forward<M>(matchers)...);
+
+        return visit_index<sizeof...(M)>(index, [&]<std::size_t I>(std::integral_constant<std::size_t, I>) PATUM_ALWAYS_INLINE
         {
-            std::optional<ReturnType> result;
+            if constexpr (std::same_as<ReturnType, not_found_t>)
+                invoke_expressions<Policy>(forward_pack_get<I>(arms), expressions);
+            else
+                return apply_expressions([&](const auto&... ex) PATUM_ALWAYS_INLINE -> ReturnType { return get_arm<Policy>(forward_pack_get<I>(arms), ex...); }, expressions);
+        });
+    }
+}
 
-            [[maybe_unused]] auto ignore = ((match_expressions(matchers, expressions_)
-                && (void(invoke_result_expressions(result, std::forward<M>(matchers), expressions_)), 1)) || ...);
+// Matches whose arms cover every value of the subjects, as in match_exhaustive(shape)(pattern(typed<circle>) = 1,
+// pattern(typed<box>) = 2), returning the result of the matching arm without the std::optional of match. Arms that
+// can't be proven to cover the subjects (see ptm::exhaustive_arms) are rejected at compile time.
+template <class Policy, class... E>
+struct basic_match_exhaustive_helper
+{
+    constexpr explicit basic_match_exhaustive_helper(E&&... expressions)
+        : expressions_(std::forward<E>(expressions)...)
+    {
+    }
+
+    template <class... M>
+        requires(compatible_patterns<M...>()
+            && compatible_patterns_args<M...>(sizeof...(E))
+            && sizeof...(M) != 0
+            && policy_accepts_v<Policy, std::remove_cvref_t<M>...>)
+    constexpr auto operator()(M&&... matchers) const
+    {
+        static_assert(exhaustive_arms<std::tuple<std::remove_cvref_t<E>...>, matcher_pattern_types_t<M>...>::value,
+            "The arms of the match don't cover every value of the subjects");
 
-            return result;
-        }
+        static_assert(std::same_as<non_void_common_type_t<decltype(test_expressions(matchers, expressions_))...>, not_found_t>
+            || (not std::is_void_v<decltype(test_expressions(matchers, expressions_))> && ...),
+            "Every arm of an exhaustive match yielding a result has to yield one");
+
+        return match_exhaustive_arms<Policy>(expressions_, std::forward<M>(matchers)...);
     }
 
 private:
@@ -110,9 +369,58 @@ private:
 };
 
 template <class... Args>
-[[nodiscard]] constexpr match_helper<Args...> match(Args&&... args)
+    requires(not starts_with_policy_v<Args...>)
+[[nodiscard]] constexpr basic_match_exhaustive_helper<default_policy, Args...> match_exhaustive(Args&&... args)
 {
-    return match_helper<Args...>{ std::forward<Args>(args)... };
+    return basic_match_exhaustive_helper<default_policy, Args...>{ std::forward<Args>(args)... };
+}
+
+template <class Policy, class... Args>
+    requires is_match_policy_v<Policy>
+[[nodiscard]] constexpr basic_match_exhaustive_helper<std::remove_cvref_t<Policy>, Args...> match_exhaustive(Policy&&, Args&&... args)
+{
+    return basic_match_exhaustive_helper<std::remove_cvref_t<Policy>, Args...>{ std::forward<Args>(args)... };
+}
+
+//=================================================================================================
+
+// Arms made of patterns only, as in match_index(x)(pattern(1), pattern(_x > 5)), selected like the arms of match but
+// returning the index of the matching arm, or the number of arms when none matches. Without results to deduce, store
+// and invoke, a chain of arms reduces to the comparisons returning the index.
+template <class Policy, class... E>
+struct basic_match_index_helper
+{
+    constexpr explicit basic_match_index_helper(E&&... expressions)
+        : expressions_(std::forward<E>(expressions)...)
+    {
+    }
+
+    template <class... P>
+        requires((is_match_pattern_v<P> && ...)
+            && compatible_patterns_args<index_matcher_t<P>...>(sizeof...(E))
+            && sizeof...(P) != 0
+            && policy_accepts_v<Policy, index_matcher_t<P>...>)
+    constexpr std::size_t operator()(P&&... patterns) const
+    {
+        return select_arm<Policy>(expressions_, std::remove_cvref_t<P>(std::forward<P>(patterns)).as_index_arm()...);
+    }
+
+private:
+    std::tuple<E...> expressions_;
+};
+
+template <class... Args>
+    requires(not starts_with_policy_v<Args...>)
+[[nodiscard]] constexpr basic_match_index_helper<default_policy, Args...> match_index(Args&&... args)
+{
+    return basic_match_index_helper<default_policy, Args...>{ std::forward<Args>(args)... };
+}
+
+template <class Policy, class... Args>
+    requires is_match_policy_v<Policy>
+[[nodiscard]] constexpr basic_match_index_helper<std::remove_cvref_t<Policy>, Args...> match_index(Policy&&, Args&&... args)
+{
+    return basic_match_index_helper<std::remove_cvref_t<Policy>, Args...>{ std::forward<Args>(args)... };
 }
 
 } // namespace ptm
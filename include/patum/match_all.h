@@ -0,0 +1,312 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "literal.h"
+#include "match.h"
+#include "matcher.h"
+#include "predicate.h"
+#include "simd.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t match_all_bounds_min_arms = 4;
+
+//=================================================================================================
+
+// Set of the arms matching the subjects, one bit per arm in source order
+template <std::size_t N>
+class arm_mask
+{
+public:
+    inline static constexpr std::size_t word_count = (N + 63) / 64;
+
+    constexpr arm_mask() noexcept = default;
+
+    constexpr explicit arm_mask(const std::array<std::uint64_t, word_count>& words) noexcept
+        : words_(words)
+    {
+    }
+
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    constexpr bool test(std::size_t arm) const noexcept
+    {
+        return (words_[arm / 64] >> (arm % 64)) & 1;
+    }
+
+    constexpr void set(std::size_t arm) noexcept
+    {
+        words_[arm / 64] |= std::uint64_t(1) << (arm % 64);
+    }
+
+    constexpr std::size_t count() const noexcept
+    {
+        std::size_t result = 0;
+
+        for (const auto word : words_)
+            result += static_cast<std::size_t>(std::popcount(word));
+
+        return result;
+    }
+
+    constexpr bool any() const noexcept
+    {
+        for (const auto word : words_)
+        {
+            if (word != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    constexpr bool none() const noexcept
+    {
+        return not any();
+    }
+
+    // First matching arm, size() when none matches: the arm match would have selected
+    constexpr std::size_t first() const noexcept
+    {
+        for (std::size_t word = 0; word < word_count; ++word)
+        {
+            if (words_[word] != 0)
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(words_[word]));
+        }
+
+        return N;
+    }
+
+    // Calls the function with the index of every matching arm, in order
+    template <class F>
+    constexpr void for_each(F&& function) const
+    {
+        for (std::size_t word = 0; word < word_count; ++word)
+        {
+            for (auto bits = words_[word]; bits != 0; bits &= bits - 1)
+                function(word * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+        }
+    }
+
+    constexpr std::uint64_t word(std::size_t index) const noexcept
+    {
+        return words_[index];
+    }
+
+    constexpr std::uint64_t to_ullong() const noexcept
+        requires(N <= 64)
+    {
+        return words_[0];
+    }
+
+    constexpr bool operator==(const arm_mask&) const noexcept = default;
+
+private:
+    std::array<std::uint64_t, word_count> words_{};
+};
+
+//=================================================================================================
+
+// Arms checked through constant bounds: literal values and ranges compared in the type of the subject, and wildcards
+template <class S, class Pattern>
+consteval bool is_bounds_arm()
+{
+    using P = std::remove_cvref_t<Pattern>;
+
+    if constexpr (not std::integral<S> || std::same_as<S, bool>)
+        return false;
+
+    else if constexpr (is_wildcard_v<P>)
+        return true;
+
+    else if constexpr (is_literal_range_v<P>)
+        return std::same_as<std::common_type_t<S, typename literal_range_bounds<P>::value_type>, S>;
+
+    else if constexpr (is_literal_v<P>)
+    {
+        using V = std::remove_cv_t<decltype(literal_value_v<P>)>;
+
+        if constexpr (std::integral<V> && not std::same_as<V, bool>)
+            return std::same_as<std::common_type_t<S, V>, S>;
+        else
+            return false;
+    }
+
+    else
+        return false;
+}
+
+// Bounds of the arms of a single subject, the other arms getting an empty interval, tested all at once in vector
+// registers (see ptm::simd_interval_set)
+template <class S, class... P>
+struct arm_bounds_table
+{
+    inline static constexpr std::size_t arm_count = sizeof...(P);
+    inline static constexpr std::size_t word_count = (arm_count + 63) / 64;
+
+    inline static constexpr std::array<bool, arm_count> bounded = { is_bounds_arm<S, P>()... };
+
+    inline static constexpr std::size_t bounded_count = (std::size_t(0) + ... + std::size_t(is_bounds_arm<S, P>()));
+
+    inline static constexpr bool applicable = bounded_count >= match_all_bounds_min_arms;
+
+    template <class Pattern>
+    static consteval std::pair<S, S> arm_bounds() noexcept
+    {
+        using Q = std::remove_cvref_t<Pattern>;
+
+        if constexpr (not is_bounds_arm<S, Q>())
+            return { std::numeric_limits<S>::max(), std::numeric_limits<S>::min() };
+
+        else if constexpr (is_wildcard_v<Q>)
+            return { std::numeric_limits<S>::min(), std::numeric_limits<S>::max() };
+
+        else if constexpr (is_literal_range_v<Q>)
+            return { static_cast<S>(literal_range_bounds<Q>::first), static_cast<S>(literal_range_bounds<Q>::last) };
+
+        else
+            return { static_cast<S>(literal_value_v<Q>), static_cast<S>(literal_value_v<Q>) };
+    }
+
+    inline static constexpr auto intervals = []
+    {
+        constexpr std::array<std::pair<S, S>, arm_count> bounds = { arm_bounds<P>()... };
+        std::array<S, arm_count> firsts{};
+        std::array<S, arm_count> lasts{};
+
+        for (std::size_t arm = 0; arm < arm_count; ++arm)
+        {
+            firsts[arm] = bounds[arm].first;
+            lasts[arm] = bounds[arm].second;
+        }
+
+        return simd_interval_set<S, arm_count>::make(firsts.data(), lasts.data());
+    }();
+
+    static constexpr std::array<std::uint64_t, word_count> select(S value) noexcept
+    {
+        return intervals.contains(value);
+    }
+};
+
+template <class Subjects, class... M>
+struct match_all_bounds
+{
+    inline static constexpr bool applicable = false;
+    inline static constexpr std::array<bool, sizeof...(M)> bounded{};
+};
+
+template <class S, class... M>
+    requires(std::integral<S> && not std::same_as<S, bool>)
+struct match_all_bounds<type_list<S>, M...> : arm_bounds_table<S, single_pattern_t<M>...>
+{
+};
+
+//=================================================================================================
+
+// Evaluates every arm once and sets the bits of the matching ones. Speculatable arms evaluate all their patterns so the
+// checks of neighbouring arms don't turn into a chain of branches, the others short circuit as in match.
+template <class... E, class... M>
+constexpr auto match_all_arms(const std::tuple<E...>& expressions, const M&... matchers)
+{
+    using bounds_type = match_all_bounds<type_list<std::remove_cvref_t<E>...>, M...>;
+
+    constexpr bool use_bounds = bounds_type::applicable;
+
+    return [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        std::array<std::uint64_t, arm_mask<sizeof...(M)>::word_count> words{};
+
+        if constexpr (use_bounds)
+            words = bounds_type::select(std::get<0>(expressions));
+
+        const auto check_arm = [&]<std::size_t Arm>(std::integral_constant<std::size_t, Arm>, const auto& matcher)
+        {
+            if constexpr (use_bounds && bounds_type::bounded[Arm])
+                return;
+
+            else if constexpr (speculatable_patterns<matcher_pattern_types_t<decltype(matcher)>>::value)
+                words[Arm / 64] |= std::uint64_t(std::apply([&](const auto&... ex) { return matcher.check_all(ex...); }, expressions)) << (Arm % 64);
+
+            else
+                words[Arm / 64] |= std::uint64_t(check_expressions(matcher, expressions)) << (Arm % 64);
+        };
+
+        (check_arm(std::integral_constant<std::size_t, I>{}, matchers), ...);
+
+        return arm_mask<sizeof...(M)>(words);
+    }(std::index_sequence_for<M...>{});
+}
+
+//=================================================================================================
+
+template <class... E>
+struct match_all_helper
+{
+    constexpr explicit match_all_helper(E&&... expressions)
+        : expressions_(std::forward_as_tuple(expressions...))
+    {
+    }
+
+    // Arms matching the subjects, their results are left alone
+    template <class... M>
+        requires(compatible_patterns<M...>()
+            && compatible_patterns_args<M...>(sizeof...(E))
+            && sizeof...(M) != 0)
+    constexpr arm_mask<sizeof...(M)> operator()(const M&... matchers) const
+    {
+        return match_all_arms(expressions_, matchers...);
+    }
+
+    // Also invokes the handlers of the matching arms in order, their results are discarded. Subjects are passed to
+    // every handler as lvalues, so none of them is moved from before the next handler sees it.
+    template <class... M>
+        requires(compatible_patterns<M...>()
+            && compatible_patterns_args<M...>(sizeof...(E))
+            && sizeof...(M) != 0)
+    constexpr arm_mask<sizeof...(M)> invoke(M&&... matchers) const
+    {
+        const auto mask = match_all_arms(expressions_, matchers...);
+
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            ((mask.test(I) ? void(invoke_expressions(std::forward<M>(matchers), expressions_)) : void()), ...);
+        }(std::index_sequence_for<M...>{});
+
+        return mask;
+    }
+
+private:
+    std::tuple<E...> expressions_;
+};
+
+template <class... Args>
+[[nodiscard]] constexpr match_all_helper<Args...> match_all(Args&&... args)
+{
+    return match_all_helper<Args...>{ std::forward<Args>(args)... };
+}
+
+} // namespace ptm
@@ -8,40 +8,149 @@
 
 #pragma once
 
+#include <array>
 #include <concepts>
+#include <cstddef>
 #include <type_traits>
 #include <tuple>
 #include <utility>
 
+#include "predicate.h"
 #include "tuple.h"
 #include "reference.h"
+#include "type_traits.h"
+#include "wildcard.h"
 
 namespace ptm {
 
 //=================================================================================================
 
-template <class T, class... Args>
-struct matcher
+// Columns of an arm to check first, in this order, as in pattern(check_order<2, 0>, a, b, c). The columns left out
+// are checked after them in the order chosen by the library.
+template <std::size_t... I>
+struct column_order
+{
+};
+
+template <std::size_t... I>
+inline static constexpr column_order<I...> check_order{};
+
+template <class T>
+struct is_column_order : std::false_type
+{
+};
+
+template <std::size_t... I>
+struct is_column_order<column_order<I...>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_column_order_v = is_column_order<std::remove_cvref_t<T>>::value;
+
+// Order the columns of an arm are checked in: the hinted columns first, then the others from the cheapest pattern
+// to the most expensive (literals first, ties in source order). Wildcards match anything and are not checked.
+template <class Order, class... P>
+struct column_check_order;
+
+template <std::size_t... I, class... P>
+struct column_check_order<column_order<I...>, P...>
+{
+    inline static constexpr std::size_t column_count = sizeof...(P);
+
+    static consteval bool is_valid_hint()
+    {
+        const std::array<std::size_t, sizeof...(I)> hinted = { I... };
+
+        for (std::size_t index = 0; index < hinted.size(); ++index)
+        {
+            if (hinted[index] >= column_count)
+                return false;
+
+            for (std::size_t other = 0; other < index; ++other)
+            {
+                if (hinted[other] == hinted[index])
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(is_valid_hint(), "Column order hints must name distinct columns of the pattern");
+
+    inline static constexpr std::array<bool, column_count> wildcards = { is_wildcard_v<P>... };
+    inline static constexpr std::array<predicate_cost, column_count> costs = { predicate_cost_of<std::remove_cvref_t<P>>::value... };
+
+    inline static constexpr std::size_t checked_count = []
+    {
+        std::size_t result = 0;
+
+        for (std::size_t column = 0; column < column_count; ++column)
+            result += wildcards[column] ? 0 : 1;
+
+        return result + ((wildcards[I] ? 1 : 0) + ... + 0);
+    }();
+
+    inline static constexpr std::array<std::size_t, checked_count> columns = []
+    {
+        std::array<std::size_t, checked_count> result{};
+        std::array<bool, column_count> taken{};
+        std::size_t count = 0;
+
+        ((result[count++] = I, taken[I] = true), ...);
+
+        for (std::size_t cost = 0; cost <= static_cast<std::size_t>(predicate_cost::regex); ++cost)
+        {
+            for (std::size_t column = 0; column < column_count; ++column)
+            {
+                if (not taken[column] && not wildcards[column] && static_cast<std::size_t>(costs[column]) == cost)
+                    result[count++] = column;
+            }
+        }
+
+        return result;
+    }();
+};
+
+//=================================================================================================
+
+template <class Order, class T, class... Args>
+struct basic_matcher
 {
     inline static constexpr std::size_t capture_count = sizeof...(Args);
 
-    constexpr matcher(T&& result, std::tuple<Args...> args)
+    PATUM_FORWARDING_INLINE constexpr basic_matcher(T&& result, std::tuple<Args...> args)
         : result_(std::move(result))
         , args_(std::move(args))
     {
     }
 
     template <class... U>
-    constexpr bool check(const U&... values_to_test) const
+    PATUM_FORWARDING_INLINE constexpr bool check(const U&... values_to_test) const
     {
-        return tuple_unpacker<sizeof...(U)>::apply([](const auto& x, const auto& y)
+        return check_columns(std::make_index_sequence<check_order_type::checked_count>{}, std::forward_as_tuple(values_to_test...));
+    }
+
+    // Same as check, reading the values from the tuple of subjects of a match instead of unpacking it first
+    template <class... U>
+    PATUM_FORWARDING_INLINE constexpr bool check_tuple(const std::tuple<U...>& values_to_test) const
+    {
+        return check_columns(std::make_index_sequence<check_order_type::checked_count>{}, values_to_test);
+    }
+
+    // Same as check, but evaluates every pattern without short circuiting (see ptm::branchless)
+    template <class... U>
+    PATUM_FORWARDING_INLINE constexpr bool check_all(const U&... values_to_test) const
+    {
+        return std::apply([&](const auto&... args)
         {
-            return evaluate_match(x, y);
-        }, args_, std::forward_as_tuple(values_to_test...));
+            return (true & ... & static_cast<bool>(evaluate_match(args, values_to_test)));
+        }, args_);
     }
 
     template <class... U>
-    constexpr decltype(auto) get(U&&... values_to_test) &
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) get(U&&... values_to_test) &
     {
         if constexpr (std::is_invocable_v<T>)
             return result_();
@@ -63,7 +172,7 @@ struct matcher
     }
 
     template <class... U>
-    constexpr decltype(auto) get(U&&... values_to_test) &&
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) get(U&&... values_to_test) &&
     {
         if constexpr (std::is_invocable_v<T>)
             return result_();
@@ -85,7 +194,7 @@ struct matcher
     }
 
     template <class... U>
-    constexpr decltype(auto) get(U&&... values_to_test) const &
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) get(U&&... values_to_test) const &
     {
         if constexpr (std::is_invocable_v<const T>)
             return result_();
@@ -107,7 +216,7 @@ struct matcher
     }
 
     template <class... U>
-    constexpr decltype(auto) get(U&&... values_to_test) const &&
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) get(U&&... values_to_test) const &&
     {
         if constexpr (std::is_invocable_v<const T>)
             return result_();
@@ -128,9 +237,56 @@ struct matcher
             return std::move(result_);
     }
 
+    // Same arm with patterns owning the values they refer to, to be kept past the match building it
+    constexpr auto owned() const &
+    {
+        return std::apply([this](const auto&... args)
+        {
+            return basic_matcher<Order, T, owned_pattern_t<std::remove_cvref_t<Args>>...>(T(result_),
+                std::tuple<owned_pattern_t<std::remove_cvref_t<Args>>...>(make_owned(args)...));
+        }, args_);
+    }
+
+    constexpr auto owned() &&
+    {
+        return std::apply([this](const auto&... args)
+        {
+            return basic_matcher<Order, T, owned_pattern_t<std::remove_cvref_t<Args>>...>(std::forward<T>(result_),
+                std::tuple<owned_pattern_t<std::remove_cvref_t<Args>>...>(make_owned(args)...));
+        }, args_);
+    }
+
 private:
+    using check_order_type = column_check_order<Order, std::remove_cvref_t<Args>...>;
+
+    template <std::size_t... I, class Values>
+    PATUM_FORWARDING_INLINE constexpr bool check_columns(std::index_sequence<I...>, const Values& values) const
+    {
+        return (true && ... && evaluate_match(std::get<check_order_type::columns[I]>(args_), std::get<check_order_type::columns[I]>(values)));
+    }
+
     [[no_unique_address]] T result_;
     [[no_unique_address]] std::tuple<Args...> args_;
 };
 
+template <class T, class... Args>
+using matcher = basic_matcher<column_order<>, T, Args...>;
+
+//=================================================================================================
+
+template <class M>
+struct matcher_traits;
+
+template <class Order, class T, class... Args>
+struct matcher_traits<basic_matcher<Order, T, Args...>>
+{
+    using result_type = T;
+    using pattern_types = std::tuple<std::remove_cvref_t<Args>...>;
+
+    inline static constexpr std::size_t capture_count = sizeof...(Args);
+};
+
+template <class M>
+using matcher_pattern_types_t = typename matcher_traits<std::remove_cvref_t<M>>::pattern_types;
+
 } // namespace ptm
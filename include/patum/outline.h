@@ -0,0 +1,104 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+#include "features.h"
+#include "type_traits.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+// Where the handler of an arm is laid out: hot handlers are inlined in the match even under ptm::outlined, cold ones
+// (errors, rare cases) are called out of line from a section away from the hot code, the compiler taking the branches
+// leading to them as unlikely
+enum class arm_heat
+{
+    automatic,
+    hot,
+    cold
+};
+
+//=================================================================================================
+
+// Handler of an arm annotated with its heat, as in pattern(_).cold() = [] { ... }
+template <class F, arm_heat Heat>
+struct arm_handler;
+
+template <class F>
+struct arm_handler<F, arm_heat::hot>
+{
+    template <class... A>
+        requires std::invocable<F&, A...>
+    PATUM_ALWAYS_INLINE constexpr decltype(auto) operator()(A&&... args)
+    {
+        return function(std::forward<A>(args)...);
+    }
+
+    template <class... A>
+        requires std::invocable<const F&, A...>
+    PATUM_ALWAYS_INLINE constexpr decltype(auto) operator()(A&&... args) const
+    {
+        return function(std::forward<A>(args)...);
+    }
+
+    F function;
+};
+
+template <class F>
+struct arm_handler<F, arm_heat::cold>
+{
+    template <class... A>
+        requires std::invocable<F&, A...>
+    PATUM_COLD constexpr decltype(auto) operator()(A&&... args)
+    {
+        return function(std::forward<A>(args)...);
+    }
+
+    template <class... A>
+        requires std::invocable<const F&, A...>
+    PATUM_COLD constexpr decltype(auto) operator()(A&&... args) const
+    {
+        return function(std::forward<A>(args)...);
+    }
+
+    F function;
+};
+
+template <class T>
+struct arm_heat_of : std::integral_constant<arm_heat, arm_heat::automatic>
+{
+};
+
+template <class F, arm_heat Heat>
+struct arm_heat_of<arm_handler<F, Heat>> : std::integral_constant<arm_heat, Heat>
+{
+};
+
+template <class T>
+inline static constexpr arm_heat arm_heat_v = arm_heat_of<std::remove_cvref_t<T>>::value;
+
+// Results that are values have no body to move around, they are stored as they are
+template <class T, arm_heat Heat>
+using arm_result_t = std::conditional_t<is_callable_v<T> && Heat != arm_heat::automatic, arm_handler<T, Heat>, T>;
+
+//=================================================================================================
+
+// Calls the handler of an arm from a function of its own, so its body stays out of the code checking the arms
+template <class M, class... U>
+PATUM_NOINLINE constexpr decltype(auto) get_outlined(M&& matcher, U&&... values_to_test)
+{
+    return std::forward<M>(matcher).get(std::forward<U>(values_to_test)...);
+}
+
+} // namespace ptm
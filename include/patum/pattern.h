@@ -8,35 +8,108 @@
 
 #pragma once
 
+#include <cstddef>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
+#include "outline.h"
+
 namespace ptm {
 
 //=================================================================================================
 
-template <class... Args>
-struct match_pattern
+// Result of the arms of ptm::match_index, which only tell which arm matched
+struct index_arm
 {
-    constexpr explicit match_pattern(Args&&... args)
+};
+
+//=================================================================================================
+
+// Patterns of an arm whose handler is laid out as told by Heat (see ptm::arm_heat)
+template <arm_heat Heat, class Order, class... Args>
+struct basic_heat_pattern
+{
+    constexpr explicit basic_heat_pattern(std::tuple<Args...> args)
+        : args_(std::move(args))
+    {
+    }
+
+    template <class T>
+    constexpr basic_matcher<Order, arm_result_t<T, Heat>, Args...> operator=(T&& result) const &&
+    {
+        return { arm_result_t<T, Heat>{ std::forward<T>(result) }, std::move(args_) };
+    }
+
+private:
+    [[no_unique_address]] std::tuple<Args...> args_;
+};
+
+template <class Order, class... Args>
+struct basic_match_pattern
+{
+    PATUM_FORWARDING_INLINE constexpr explicit basic_match_pattern(Args&&... args)
         : args_(std::forward_as_tuple(args...))
     {
     }
 
     template <class T>
-    constexpr matcher<T, Args...> operator=(T&& result) const &&
+    PATUM_FORWARDING_INLINE constexpr basic_matcher<Order, T, Args...> operator=(T&& result) const &&
     {
         return { std::forward<T>(result), std::move(args_) };
     }
 
+    // Handler run often enough to stay inlined in the match, whatever the policy
+    constexpr basic_heat_pattern<arm_heat::hot, Order, Args...> hot() &&
+    {
+        return basic_heat_pattern<arm_heat::hot, Order, Args...>{ std::move(args_) };
+    }
+
+    // Handler of a rare case, such as an error, moved out of the match with the branch leading to it taken as unlikely
+    constexpr basic_heat_pattern<arm_heat::cold, Order, Args...> cold() &&
+    {
+        return basic_heat_pattern<arm_heat::cold, Order, Args...>{ std::move(args_) };
+    }
+
+    constexpr basic_matcher<Order, index_arm, Args...> as_index_arm() &&
+    {
+        return { index_arm{}, std::move(args_) };
+    }
+
 private:
     [[no_unique_address]] std::tuple<Args...> args_;
 };
 
 template <class... Args>
-[[nodiscard]] constexpr match_pattern<Args...> pattern(Args&&... args)
+using match_pattern = basic_match_pattern<column_order<>, Args...>;
+
+template <class T>
+struct is_match_pattern : std::false_type
+{
+};
+
+template <class Order, class... Args>
+struct is_match_pattern<basic_match_pattern<Order, Args...>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_match_pattern_v = is_match_pattern<std::remove_cvref_t<T>>::value;
+
+template <class P>
+using index_matcher_t = decltype(std::declval<std::remove_cvref_t<P>>().as_index_arm());
+
+template <class... Args>
+    requires(not (is_column_order_v<Args> || ...))
+[[nodiscard]] PATUM_FORWARDING_INLINE constexpr match_pattern<Args...> pattern(Args&&... args)
 {
     return match_pattern<Args...>{ std::forward<Args>(args)... };
 }
 
+template <std::size_t... I, class... Args>
+[[nodiscard]] constexpr basic_match_pattern<column_order<I...>, Args...> pattern(column_order<I...>, Args&&... args)
+{
+    return basic_match_pattern<column_order<I...>, Args...>{ std::forward<Args>(args)... };
+}
+
 } // namespace ptm
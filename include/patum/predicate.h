@@ -8,25 +8,30 @@
 
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <iterator>
+#include <memory>
 #include <ranges>
 #include <regex>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <variant>
 
 #include "concepts.h"
 #include "features.h"
+#include "struct.h"
 #include "type_traits.h"
 #include "tuple.h"
+#include "value_set.h"
 
 namespace ptm {
 
 //=================================================================================================
 
 template <class T, class U>
-constexpr bool evaluate_match(const T& lhs, const U& rhs)
+PATUM_FORWARDING_INLINE constexpr bool evaluate_match(const T& lhs, const U& rhs)
 {
     if constexpr (requires { { lhs(rhs) } -> std::convertible_to<bool>; })
         return lhs(rhs);
@@ -43,16 +48,21 @@ constexpr bool evaluate_match(const T& lhs, const U& rhs)
 template <class F>
 struct predicate
 {
-    constexpr predicate(F&& func)
+    PATUM_FORWARDING_INLINE constexpr predicate(F&& func)
         : func_(std::move(func))
     {
     }
 
-    constexpr auto operator()(const auto& v) const
+    PATUM_FORWARDING_INLINE constexpr auto operator()(const auto& v) const
     {
         return func_(v);
     }
 
+    constexpr const F& function() const noexcept
+    {
+        return func_;
+    }
+
 protected:
     [[no_unique_address]] F func_;
 };
@@ -74,373 +84,746 @@ inline static constexpr bool is_predicate_v = is_predicate<T>::value;
 
 //=================================================================================================
 
-inline static constexpr auto _u = predicate([](const auto& u) { return u; });
-inline static constexpr auto _v = predicate([](const auto& v) { return v; });
-inline static constexpr auto _w = predicate([](const auto& w) { return w; });
-inline static constexpr auto _x = predicate([](const auto& x) { return x; });
-inline static constexpr auto _y = predicate([](const auto& y) { return y; });
-inline static constexpr auto _z = predicate([](const auto& z) { return z; });
+// Rough cost of evaluating a pattern, from the cheapest to the most expensive. Conjunctions and disjunctions of
+// speculatable patterns evaluate the cheaper operand first (see operator&& and operator||).
+enum class predicate_cost
+{
+    literal,    // Compares the subject with a value
+    arithmetic, // A few arithmetic or logic operations
+    call,       // An opaque function
+    container,  // Walks a container
+    regex       // Runs a regular expression
+};
+
+//=================================================================================================
+
+// Callable known to have no side effects and no undefined behaviour for any subject it accepts, so it can be
+// evaluated speculatively even when a previous arm would have matched (see ptm::branchless)
+template <class F, predicate_cost Cost = predicate_cost::call>
+struct speculative_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) operator()(const U& value_to_test) const
+    {
+        return func(value_to_test);
+    }
+
+    [[no_unique_address]] F func;
+};
+
+// Callable with no side effects but not safe to evaluate for every subject (it may allocate, throw or rely on a guard),
+// so it is never evaluated speculatively. Its cost is known, and being free of side effects it can be left unevaluated
+// when a cheaper speculatable operand of && or || decides the result.
+template <class F, predicate_cost Cost>
+struct costed_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) operator()(const U& value_to_test) const
+    {
+        return func(value_to_test);
+    }
+
+    [[no_unique_address]] F func;
+};
+
+template <predicate_cost Cost = predicate_cost::call, class F>
+PATUM_FORWARDING_INLINE constexpr auto speculative(F&& func)
+{
+    return predicate(speculative_function<std::decay_t<F>, Cost>{ std::forward<F>(func) });
+}
+
+template <predicate_cost Cost, class F>
+PATUM_FORWARDING_INLINE constexpr auto with_cost(F&& func)
+{
+    return predicate(costed_function<std::decay_t<F>, Cost>{ std::forward<F>(func) });
+}
+
+template <bool Speculatable, predicate_cost Cost, class F>
+PATUM_FORWARDING_INLINE constexpr auto make_predicate(F&& func)
+{
+    if constexpr (Speculatable)
+        return speculative<Cost>(std::forward<F>(func));
+    else
+        return with_cost<Cost>(std::forward<F>(func));
+}
+
+//=================================================================================================
+
+// Plain values are compared with == (or as strings), function pointers are excluded as they are called instead
+template <class T>
+struct is_speculatable : std::bool_constant<std::is_arithmetic_v<T>
+    || std::is_enum_v<T>
+    || (std::is_pointer_v<T> && not std::is_function_v<std::remove_pointer_t<T>>)
+    || StringLike<T>>
+{
+};
+
+template <class F>
+struct is_speculatable<predicate<F>> : std::false_type
+{
+};
+
+template <class F, predicate_cost Cost>
+struct is_speculatable<predicate<speculative_function<F, Cost>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_speculatable_v = is_speculatable<std::remove_cvref_t<T>>::value;
+
+template <class... T>
+inline static constexpr bool all_speculatable_v = (is_speculatable_v<T> && ...);
+
+// Patterns whose evaluation can be skipped without changing anything but the time spent
+template <class T>
+struct is_side_effect_free : is_speculatable<T>
+{
+};
+
+template <class F, predicate_cost Cost>
+struct is_side_effect_free<predicate<costed_function<F, Cost>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_side_effect_free_v = is_side_effect_free<std::remove_cvref_t<T>>::value;
+
+template <class... T>
+inline static constexpr bool all_side_effect_free_v = (is_side_effect_free_v<T> && ...);
+
+//=================================================================================================
+
+// Plain values are compared, opaque predicates are assumed to do some work
+template <class T>
+struct predicate_cost_of : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
+
+template <class F>
+struct predicate_cost_of<predicate<F>> : std::integral_constant<predicate_cost, predicate_cost::call>
+{
+};
+
+template <class F, predicate_cost Cost>
+struct predicate_cost_of<predicate<speculative_function<F, Cost>>> : std::integral_constant<predicate_cost, Cost>
+{
+};
+
+template <class F, predicate_cost Cost>
+struct predicate_cost_of<predicate<costed_function<F, Cost>>> : std::integral_constant<predicate_cost, Cost>
+{
+};
+
+// Cost of the most expensive of the patterns
+template <class... T>
+inline static constexpr predicate_cost predicate_cost_v = []
+{
+    predicate_cost result = predicate_cost::literal;
+
+    ((result = std::max(result, predicate_cost_of<std::remove_cvref_t<T>>::value)), ...);
+
+    return result;
+}();
+
+// Predicate combining operands, speculatable (or free of side effects) when all of them are and as expensive as the
+// most expensive one
+template <class... Operands, class F>
+PATUM_FORWARDING_INLINE constexpr auto make_predicate_of(F&& func)
+{
+    if constexpr (all_speculatable_v<Operands...>)
+        return speculative<predicate_cost_v<Operands...>>(std::forward<F>(func));
+    else if constexpr (all_side_effect_free_v<Operands...>)
+        return with_cost<predicate_cost_v<Operands...>>(std::forward<F>(func));
+    else
+        return predicate(std::forward<F>(func));
+}
+
+//=================================================================================================
+
+// Keeps a predicate where it is written among the operands of && and ||, for guards protecting the evaluation of
+// the other operand
+template <class F>
+struct ordered_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr decltype(auto) operator()(const U& value_to_test) const
+    {
+        return pred(value_to_test);
+    }
+
+    predicate<F> pred;
+};
+
+template <class F>
+constexpr auto ordered(const predicate<F>& m)
+{
+    return predicate(ordered_function<F>{ m });
+}
+
+template <class F>
+struct is_speculatable<predicate<ordered_function<F>>> : is_speculatable<predicate<F>>
+{
+};
+
+template <class F>
+struct is_side_effect_free<predicate<ordered_function<F>>> : is_side_effect_free<predicate<F>>
+{
+};
+
+template <class F>
+struct predicate_cost_of<predicate<ordered_function<F>>> : predicate_cost_of<predicate<F>>
+{
+};
+
+template <class T>
+struct is_ordered : std::false_type
+{
+};
+
+template <class F>
+struct is_ordered<predicate<ordered_function<F>>> : std::true_type
+{
+};
+
+template <class... T>
+inline static constexpr bool any_ordered_v = (is_ordered<std::remove_cvref_t<T>>::value || ...);
+
+//=================================================================================================
+
+inline static constexpr auto _u = speculative<predicate_cost::literal>([](const auto& u) PATUM_ALWAYS_INLINE { return u; });
+inline static constexpr auto _v = speculative<predicate_cost::literal>([](const auto& v) PATUM_ALWAYS_INLINE { return v; });
+inline static constexpr auto _w = speculative<predicate_cost::literal>([](const auto& w) PATUM_ALWAYS_INLINE { return w; });
+inline static constexpr auto _x = speculative<predicate_cost::literal>([](const auto& x) PATUM_ALWAYS_INLINE { return x; });
+inline static constexpr auto _y = speculative<predicate_cost::literal>([](const auto& y) PATUM_ALWAYS_INLINE { return y; });
+inline static constexpr auto _z = speculative<predicate_cost::literal>([](const auto& z) PATUM_ALWAYS_INLINE { return z; });
+
+//=================================================================================================
+
+#define PATUM_DEFINE_BINARY_OPERATION(name, op) \
+    struct name \
+    { \
+        template <class L, class R> \
+        PATUM_FORWARDING_INLINE constexpr auto operator()(const L& lhs, const R& rhs) const \
+        { \
+            return lhs op rhs; \
+        } \
+    };
+
+#define PATUM_DEFINE_UNARY_OPERATION(name, op) \
+    struct name \
+    { \
+        template <class T> \
+        PATUM_FORWARDING_INLINE constexpr auto operator()(const T& value) const \
+        { \
+            return op value; \
+        } \
+    };
+
+PATUM_DEFINE_BINARY_OPERATION(equal_operation, ==)
+PATUM_DEFINE_BINARY_OPERATION(not_equal_operation, !=)
+PATUM_DEFINE_BINARY_OPERATION(less_equal_operation, <=)
+PATUM_DEFINE_BINARY_OPERATION(greater_equal_operation, >=)
+PATUM_DEFINE_BINARY_OPERATION(less_operation, <)
+PATUM_DEFINE_BINARY_OPERATION(greater_operation, >)
+PATUM_DEFINE_BINARY_OPERATION(plus_operation, +)
+PATUM_DEFINE_BINARY_OPERATION(minus_operation, -)
+PATUM_DEFINE_BINARY_OPERATION(multiplies_operation, *)
+PATUM_DEFINE_BINARY_OPERATION(divides_operation, /)
+PATUM_DEFINE_BINARY_OPERATION(modulus_operation, %)
+PATUM_DEFINE_BINARY_OPERATION(bit_and_operation, &)
+PATUM_DEFINE_BINARY_OPERATION(bit_or_operation, |)
+PATUM_DEFINE_BINARY_OPERATION(bit_xor_operation, ^)
+PATUM_DEFINE_BINARY_OPERATION(shift_right_operation, >>)
+PATUM_DEFINE_BINARY_OPERATION(shift_left_operation, <<)
+
+PATUM_DEFINE_UNARY_OPERATION(logical_not_operation, !)
+PATUM_DEFINE_UNARY_OPERATION(unary_plus_operation, +)
+PATUM_DEFINE_UNARY_OPERATION(negate_operation, -)
+PATUM_DEFINE_UNARY_OPERATION(bit_not_operation, ~)
+
+#undef PATUM_DEFINE_BINARY_OPERATION
+#undef PATUM_DEFINE_UNARY_OPERATION
+
+// Operations between a placeholder and a value refer to the value, as patterns are evaluated within the match building
+// them: T is a reference. Patterns kept past it, by ptm::compile_match, own a copy instead (see make_owned).
+template <class Op, class F, class T>
+struct right_operand_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr auto operator()(const U& value_to_test) const
+    {
+        return Op{}(pred(value_to_test), operand);
+    }
+
+    predicate<F> pred;
+    T operand;
+};
+
+template <class Op, class T, class F>
+struct left_operand_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr auto operator()(const U& value_to_test) const
+    {
+        return Op{}(operand, pred(value_to_test));
+    }
+
+    T operand;
+    predicate<F> pred;
+};
+
+template <class Op, class F, class F2>
+struct operands_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr auto operator()(const U& value_to_test) const
+    {
+        return Op{}(lhs(value_to_test), rhs(value_to_test));
+    }
+
+    predicate<F> lhs;
+    predicate<F2> rhs;
+};
+
+template <class Op, class F>
+struct unary_operand_function
+{
+    template <class U>
+    PATUM_FORWARDING_INLINE constexpr auto operator()(const U& value_to_test) const
+    {
+        return Op{}(pred(value_to_test));
+    }
+
+    predicate<F> pred;
+};
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator==(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator==(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) == t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<equal_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator==(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator==(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t == m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<equal_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator==(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator==(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) == m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<equal_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator!=(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator!=(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) != t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<not_equal_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator!=(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator!=(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t != m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<not_equal_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator!=(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator!=(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) != m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<not_equal_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator<=(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator<=(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) <= t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<less_equal_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator<=(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator<=(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t <= m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<less_equal_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator<=(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator<=(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) <= m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<less_equal_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator>=(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator>=(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) >= t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<greater_equal_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator>=(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator>=(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t >= m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<greater_equal_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator>=(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator>=(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) >= m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<greater_equal_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator<(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator<(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) < t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<less_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator<(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator<(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t < m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<less_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator<(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator<(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) < m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<less_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator>(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator>(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) > t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<greater_operation, F, const T&>{ m, t });
 }
 
 template<class F, class T>
-constexpr auto operator>(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator>(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t > m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<greater_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator>(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator>(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) > m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<greater_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F>
-constexpr auto operator!(const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator!(const predicate<F>& m)
 {
-    return predicate([m](const auto& x) { return !m(x); });
+    return make_predicate_of<predicate<F>>(unary_operand_function<logical_not_operation, F>{ m });
 }
 
 //=================================================================================================
 
+// Cheap speculatable operands are both evaluated, so combining them does not introduce a branch. More expensive ones
+// are short circuited starting from the cheaper: a speculatable right operand can be evaluated when the left one would
+// have decided the result, and a left operand free of side effects can be skipped, which only changes the time spent.
+// Other operands are evaluated in the order written.
+enum class operands_order
+{
+    both,
+    written,
+    swapped
+};
+
+template <class L, class R>
+inline static constexpr operands_order operands_order_v = []
+{
+    if constexpr (any_ordered_v<L, R>)
+        return operands_order::written;
+
+    else if constexpr (all_speculatable_v<L, R> && predicate_cost_v<L, R> <= predicate_cost::call)
+        return operands_order::both;
+
+    else if constexpr (is_speculatable_v<R> && is_side_effect_free_v<L> && predicate_cost_v<R> < predicate_cost_v<L>)
+        return operands_order::swapped;
+
+    else
+        return operands_order::written;
+}();
+
+template <class F, class F2>
+struct conjunction_function
+{
+    template <class U>
+    constexpr bool operator()(const U& value_to_test) const
+    {
+        constexpr auto order = operands_order_v<predicate<F>, predicate<F2>>;
+
+        if constexpr (order == operands_order::both)
+            return static_cast<bool>(static_cast<bool>(lhs(value_to_test)) & static_cast<bool>(rhs(value_to_test)));
+        else if constexpr (order == operands_order::swapped)
+            return rhs(value_to_test) && lhs(value_to_test);
+        else
+            return lhs(value_to_test) && rhs(value_to_test);
+    }
+
+    predicate<F> lhs;
+    predicate<F2> rhs;
+};
+
+template <class F, class F2>
+struct disjunction_function
+{
+    template <class U>
+    constexpr bool operator()(const U& value_to_test) const
+    {
+        constexpr auto order = operands_order_v<predicate<F>, predicate<F2>>;
+
+        if constexpr (order == operands_order::both)
+            return static_cast<bool>(static_cast<bool>(lhs(value_to_test)) | static_cast<bool>(rhs(value_to_test)));
+        else if constexpr (order == operands_order::swapped)
+            return rhs(value_to_test) || lhs(value_to_test);
+        else
+            return lhs(value_to_test) || rhs(value_to_test);
+    }
+
+    predicate<F> lhs;
+    predicate<F2> rhs;
+};
+
 template <class F, class F2>
-constexpr auto operator&&(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator&&(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) && m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(conjunction_function<F, F2>{ m, m2 });
 }
 
 template <class F, class F2>
-constexpr auto operator||(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator||(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) || m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(disjunction_function<F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F>
-constexpr auto operator+(const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator+(const predicate<F>& m)
 {
-    return predicate([m](const auto& x) { return +m(x); });
+    return predicate(unary_operand_function<unary_plus_operation, F>{ m });
 }
 
 template <class F, class T>
-constexpr auto operator+(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator+(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) + t; });
+    return predicate(right_operand_function<plus_operation, F, const T&>{ m, t });
 }
 
 template<class F, class T>
-constexpr auto operator+(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator+(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t + m(x); });
+    return predicate(left_operand_function<plus_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator+(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator+(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) + m2(x); });
+    return predicate(operands_function<plus_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F>
-constexpr auto operator-(const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator-(const predicate<F>& m)
 {
-    return predicate([m](const auto& x) { return -m(x); });
+    return predicate(unary_operand_function<negate_operation, F>{ m });
 }
 
 template <class F, class T>
-constexpr auto operator-(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator-(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) - t; });
+    return predicate(right_operand_function<minus_operation, F, const T&>{ m, t });
 }
 
 template<class F, class T>
-constexpr auto operator-(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator-(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t - m(x); });
+    return predicate(left_operand_function<minus_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator-(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator-(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) - m2(x); });
+    return predicate(operands_function<minus_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator*(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator*(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) * t; });
+    return predicate(right_operand_function<multiplies_operation, F, const T&>{ m, t });
 }
 
 template<class F, class T>
-constexpr auto operator*(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator*(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t * m(x); });
+    return predicate(left_operand_function<multiplies_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator*(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator*(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) * m2(x); });
+    return predicate(operands_function<multiplies_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator/(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator/(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) / t; });
+    return predicate(right_operand_function<divides_operation, F, const T&>{ m, t });
 }
 
 template<class F, class T>
-constexpr auto operator/(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator/(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t / m(x); });
+    return predicate(left_operand_function<divides_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator/(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator/(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) / m2(x); });
+    return predicate(operands_function<divides_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F>
-constexpr auto operator~(const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator~(const predicate<F>& m)
 {
-    return predicate([m](const auto& x) { return ~m(x); });
+    return make_predicate_of<predicate<F>>(unary_operand_function<bit_not_operation, F>{ m });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator%(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator%(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) % t; });
+    return predicate(right_operand_function<modulus_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator%(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator%(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t % m(x); });
+    return predicate(left_operand_function<modulus_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator%(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator%(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) % m2(x); });
+    return predicate(operands_function<modulus_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator&(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator&(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) & t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<bit_and_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator&(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator&(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t & m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<bit_and_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator&(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator&(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) & m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<bit_and_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator|(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator|(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) | t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<bit_or_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator|(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator|(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t | m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<bit_or_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator|(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator|(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) | m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<bit_or_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator^(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator^(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) ^ t; });
+    return make_predicate_of<predicate<F>, T>(right_operand_function<bit_xor_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator^(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator^(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t ^ m(x); });
+    return make_predicate_of<predicate<F>, T>(left_operand_function<bit_xor_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator^(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator^(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) ^ m2(x); });
+    return make_predicate_of<predicate<F>, predicate<F2>>(operands_function<bit_xor_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator>>(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator>>(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) >> t; });
+    return predicate(right_operand_function<shift_right_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator>>(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator>>(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t << m(x); });
+    return predicate(left_operand_function<shift_right_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator>>(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator>>(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) >> m2(x); });
+    return predicate(operands_function<shift_right_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
 
 template <class F, class T>
-constexpr auto operator<<(const predicate<F>& m, const T& t)
+PATUM_FORWARDING_INLINE constexpr auto operator<<(const predicate<F>& m, const T& t)
 {
-    return predicate([m, &t](const auto& x) { return m(x) >> t; });
+    return predicate(right_operand_function<shift_left_operation, F, const T&>{ m, t });
 }
 
 template <class F, class T>
-constexpr auto operator<<(const T& t, const predicate<F>& m)
+PATUM_FORWARDING_INLINE constexpr auto operator<<(const T& t, const predicate<F>& m)
 {
-    return predicate([m, &t](const auto& x) { return t << m(x); });
+    return predicate(left_operand_function<shift_left_operation, const T&, F>{ t, m });
 }
 
 template <class F, class F2>
-constexpr auto operator<<(const predicate<F>& m, const predicate<F2>& m2)
+PATUM_FORWARDING_INLINE constexpr auto operator<<(const predicate<F>& m, const predicate<F2>& m2)
 {
-    return predicate([m, m2](const auto& x) { return m(x) << m2(x); });
+    return predicate(operands_function<shift_left_operation, F, F2>{ m, m2 });
 }
 
 //=================================================================================================
@@ -450,7 +833,7 @@ constexpr auto range(T first, T last) noexcept
 {
     expect(first < last);
 
-    return predicate([first, last]<class U>(const U& value_to_test)
+    return speculative<predicate_cost::arithmetic>([first, last]<class U>(const U& value_to_test) PATUM_ALWAYS_INLINE
         requires std::equality_comparable_with<T, U>
     {
         return value_to_test >= first and value_to_test <= last;
@@ -459,13 +842,62 @@ constexpr auto range(T first, T last) noexcept
 
 //=================================================================================================
 
+// Values referred to like the operands of the operators, owned by the patterns kept past the match (see make_owned)
 template <class... Args>
-constexpr auto in(Args&&... values) noexcept
+struct value_list_function
 {
-    return predicate([&values...]<class U>(const U& value_to_test)
+    template <class U>
         requires all_equality_comparable_with<U, Args...>
+    PATUM_FORWARDING_INLINE constexpr bool operator()(const U& value_to_test) const
+    {
+        return contains(value_to_test, std::index_sequence_for<Args...>{});
+    }
+
+    std::tuple<Args...> values;
+
+private:
+    template <class U, std::size_t... I>
+    PATUM_FORWARDING_INLINE constexpr bool contains(const U& value_to_test, std::index_sequence<I...>) const
     {
-        return (false || ... || evaluate_match(std::forward<Args>(values), value_to_test));
+        return (false || ... || evaluate_match(std::get<I>(values), value_to_test));
+    }
+};
+
+// Large packs of string literals or views are hashed into a string_value_array
+template <class... Args>
+constexpr auto in(Args&&... values) noexcept
+{
+    if constexpr (sizeof...(Args) >= value_set_min_hashed
+        && ((std::same_as<std::decay_t<Args>, const char*> || std::same_as<std::decay_t<Args>, std::string_view>) && ...))
+    {
+        return make_predicate_of<Args...>([set = string_value_array<sizeof...(Args)>(values...)]<class U>(const U& value_to_test) PATUM_ALWAYS_INLINE
+            requires StringLike<U>
+        {
+            return set.contains(std::string_view(value_to_test));
+        });
+    }
+    else
+    {
+        return make_predicate_of<Args...>(value_list_function<const std::remove_reference_t<Args>&...>{ std::tuple<const std::remove_reference_t<Args>&...>(values...) });
+    }
+}
+
+// Values of a runtime container, copied into a value_set shared by the copies of the predicate. Named apart from in(),
+// where a single container is a value the subject is compared with.
+template <std::ranges::input_range R>
+    requires(not StringLike<std::remove_cvref_t<R>>)
+auto in_set(R&& values)
+{
+    using value_type = std::ranges::range_value_t<R>;
+    using set_type = value_set<value_type>;
+
+    return speculative<predicate_cost::container>([set = std::make_shared<const set_type>(values)]<class U>(const U& value_to_test) PATUM_ALWAYS_INLINE
+        requires std::equality_comparable_with<U, value_type> || (StringLike<U> && StringLike<value_type>)
+    {
+        if constexpr (set_type::template indexable<U>)
+            return set->contains(value_to_test);
+        else
+            return std::ranges::any_of(set->values(), [&](const value_type& value) { return evaluate_match(value, value_to_test); });
     });
 }
 
@@ -498,43 +930,144 @@ inline static constexpr auto none = predicate([]<class U>(const U& value_to_test
 
 //=================================================================================================
 
+// Matches a variant currently holding an alternative of type T equal to the value
 template <class T>
-constexpr auto valued(T&& value) noexcept
+struct variant_value
 {
-    return predicate([value = std::forward<T>(value)]<class U>(const U& value_to_test)
-        requires std::equality_comparable<T> and requires(const U u)
-            {
-                { std::holds_alternative<T>(u) } -> std::convertible_to<bool>;
-                { std::get<T>(u) } -> std::same_as<const T&>;
-            }
+    template <class U>
+        requires is_variant_v<U> and std::equality_comparable<T>
+    constexpr bool operator()(const U& value_to_test) const
     {
-        return std::holds_alternative<T>(value_to_test) && evaluate_match(value, std::get<T>(value_to_test));
-    });
+        return holds(value_to_test, std::make_index_sequence<std::variant_size_v<U>>{});
+    }
+
+    T value;
+
+private:
+    template <class U, std::size_t... I>
+    constexpr bool holds(const U& value_to_test, std::index_sequence<I...>) const
+    {
+        return (false || ... || holds_at<I>(value_to_test));
+    }
+
+    template <std::size_t I, class U>
+    constexpr bool holds_at(const U& value_to_test) const
+    {
+        if constexpr (std::is_same_v<T, std::variant_alternative_t<I, U>>)
+            return value_to_test.index() == I && evaluate_match(value, *std::get_if<I>(&value_to_test));
+        else
+            return false;
+    }
+};
+
+template <class T>
+constexpr auto valued(T&& value) noexcept
+{
+    return predicate(variant_value<std::remove_cvref_t<T>>{ std::forward<T>(value) });
 }
 
+// Matches a variant currently holding an alternative of type T, if T is one of its alternatives
 template <class T>
-inline static constexpr auto typed = predicate([]<class U>([[maybe_unused]] const U& value_to_test)
-    requires is_variant_v<U> and requires{ is_variant_holding<T, U>(); }
+struct variant_type
 {
-    return is_variant_holding<T, U>();
-});
+    template <class U>
+        requires is_variant_v<U>
+    constexpr bool operator()(const U& value_to_test) const
+    {
+        return holds(value_to_test, std::make_index_sequence<std::variant_size_v<U>>{});
+    }
+
+private:
+    template <class U, std::size_t... I>
+    static constexpr bool holds(const U& value_to_test, std::index_sequence<I...>)
+    {
+        return (false || ... || (std::is_same_v<T, std::variant_alternative_t<I, U>> && value_to_test.index() == I));
+    }
+};
+
+template <class T>
+inline static constexpr auto typed = predicate(variant_type<T>{});
 
 //=================================================================================================
 
 template <class T>
-inline static constexpr auto is = predicate([]<class U>([[maybe_unused]] const U& value_to_test)
+struct is_variant_value : std::false_type
 {
-    return std::same_as<std::remove_cvref_t<T>, std::remove_cvref_t<U>>;
-});
+};
+
+template <class T>
+struct is_variant_value<predicate<variant_value<T>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_variant_value_v = is_variant_value<std::remove_cvref_t<T>>::value;
+
+template <class T>
+struct predicate_cost_of<predicate<variant_value<T>>> : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
+
+template <class T>
+struct is_variant_type : std::false_type
+{
+};
+
+template <class T>
+struct is_variant_type<predicate<variant_type<T>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_variant_type_v = is_variant_type<std::remove_cvref_t<T>>::value;
+
+template <class T>
+struct predicate_cost_of<predicate<variant_type<T>>> : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
+
+//=================================================================================================
+
+template <class T>
+struct same_type
+{
+    template <class U>
+    constexpr bool operator()([[maybe_unused]] const U& value_to_test) const
+    {
+        return std::same_as<std::remove_cvref_t<T>, std::remove_cvref_t<U>>;
+    }
+};
+
+template <class T>
+inline static constexpr auto is = predicate(same_type<T>{});
+
+template <class T>
+struct is_same_type : std::false_type
+{
+};
+
+template <class T>
+struct is_same_type<predicate<same_type<T>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_same_type_v = is_same_type<std::remove_cvref_t<T>>::value;
+
+template <class T>
+struct predicate_cost_of<predicate<same_type<T>>> : std::integral_constant<predicate_cost, predicate_cost::literal>
+{
+};
 
 //=================================================================================================
 
 template <class... Args>
-constexpr auto ds(Args&&... values) noexcept
+struct destructure
 {
-    using T = std::tuple<Args...>;
+    using pattern_types = std::tuple<std::remove_cvref_t<Args>...>;
 
-    return predicate([value = std::forward_as_tuple(values...)]<class U>(const U& value_to_test)
+    template <class U>
+    constexpr bool operator()(const U& value_to_test) const
     {
         if constexpr (std::is_aggregate_v<U> && member_count_v<U> >= sizeof...(Args))
         {
@@ -542,7 +1075,7 @@ constexpr auto ds(Args&&... values) noexcept
                 requires requires{ { evaluate_match(x, y) } -> std::same_as<bool>; }
             {
                 return evaluate_match(x, y);
-            }, value, to_tuple_t<member_count_v<U>>{}(value_to_test));
+            }, values, to_tuple_t<member_count_v<U>>{}(value_to_test));
         }
         else if constexpr (std::tuple_size_v<U> >= sizeof...(Args))
         {
@@ -550,20 +1083,41 @@ constexpr auto ds(Args&&... values) noexcept
                 requires requires{ { evaluate_match(x, y) } -> std::same_as<bool>; }
             {
                 return evaluate_match(x, y);
-            }, value, value_to_test);
+            }, values, value_to_test);
         }
         else
         {
-            static_assert(always_false_v<T, U>, "Impossible to evaluate destructure matching between T and U");
+            static_assert(always_false_v<std::tuple<Args...>, U>, "Impossible to evaluate destructure matching between T and U");
         }
-    });
+    }
+
+    std::tuple<Args...> values;
+};
+
+template <class... Args>
+constexpr auto ds(Args&&... values) noexcept
+{
+    return predicate(destructure<std::remove_reference_t<Args>&...>{ std::forward_as_tuple(values...) });
 }
 
+template <class T>
+struct is_destructure : std::false_type
+{
+};
+
+template <class... Args>
+struct is_destructure<predicate<destructure<Args...>>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_destructure_v = is_destructure<std::remove_cvref_t<T>>::value;
+
 //=================================================================================================
 
 constexpr auto sized(std::size_t count) noexcept
 {
-    return predicate([count]<class U>(const U& value_to_test)
+    return with_cost<predicate_cost::arithmetic>([count]<class U>(const U& value_to_test)
         requires requires(const U u) { { std::size(u) } -> std::equality_comparable_with<std::size_t>; }
     {
         return std::size(value_to_test) == count;
@@ -573,7 +1127,7 @@ constexpr auto sized(std::size_t count) noexcept
 template <class F>
 constexpr auto size(const predicate<F>& m) noexcept
 {
-    return predicate([m]<class U>(const U& value_to_test)
+    return make_predicate_of<predicate<F>, decltype(sized(0))>([m]<class U>(const U& value_to_test)
         requires requires(const U u) { { std::size(m(u)) } -> std::equality_comparable_with<std::size_t>; }
     {
         return std::size(m(value_to_test));
@@ -584,7 +1138,7 @@ constexpr auto size(const predicate<F>& m) noexcept
 
 constexpr auto ssized(std::ptrdiff_t count) noexcept
 {
-    return predicate([count]<class U>(const U& value_to_test)
+    return with_cost<predicate_cost::arithmetic>([count]<class U>(const U& value_to_test)
         requires requires(const U u) { { std::ssize(u) } -> std::equality_comparable_with<std::ptrdiff_t>; }
     {
         return std::ssize(value_to_test) == count;
@@ -594,7 +1148,7 @@ constexpr auto ssized(std::ptrdiff_t count) noexcept
 template <class F>
 constexpr auto ssize(const predicate<F>& m) noexcept
 {
-    return predicate([m]<class U>(const U& value_to_test)
+    return make_predicate_of<predicate<F>, decltype(ssized(0))>([m]<class U>(const U& value_to_test)
         requires requires(const U u) { { std::ssize(m(u)) } -> std::equality_comparable_with<std::ptrdiff_t>; }
     {
         return std::ssize(m(value_to_test));
@@ -605,7 +1159,7 @@ constexpr auto ssize(const predicate<F>& m) noexcept
 
 constexpr auto begin() noexcept
 {
-    return predicate([]<class U>(const U& value_to_test)
+    return with_cost<predicate_cost::literal>([]<class U>(const U& value_to_test)
         requires std::ranges::input_range<U>
     {
         return std::ranges::begin(value_to_test);
@@ -614,7 +1168,7 @@ constexpr auto begin() noexcept
 
 constexpr auto end() noexcept
 {
-    return predicate([]<class U>(const U& value_to_test)
+    return with_cost<predicate_cost::literal>([]<class U>(const U& value_to_test)
         requires std::ranges::input_range<U>
     {
         return std::ranges::end(value_to_test);
@@ -649,10 +1203,11 @@ constexpr auto prev(const predicate<F>& m, std::ptrdiff_t count = 1) noexcept
 
 //=================================================================================================
 
+// Only speculatable without a projection, as any function given as one may not be safe to call on every element
 template <class T, class Proj = std::identity>
 constexpr auto find(T&& value, Proj proj = {}) noexcept
 {
-    return predicate([value = std::forward<T>(value), proj = std::forward<Proj>(proj)]<class U>(const U& value_to_test)
+    return make_predicate<std::same_as<Proj, std::identity>, predicate_cost::container>([value = std::forward<T>(value), proj = std::forward<Proj>(proj)]<class U>(const U& value_to_test)
         requires std::ranges::input_range<U>
     {
         return std::ranges::find(value_to_test, std::move(value), std::move(proj));
@@ -664,7 +1219,7 @@ constexpr auto find(T&& value, Proj proj = {}) noexcept
 template <StringLike T>
 auto sregex(T&& r) noexcept
 {
-    return predicate([r = std::regex(r)]<class U>(const U& value_to_test) // TODO - avoid costly instantiation
+    return with_cost<predicate_cost::regex>([r = std::regex(r)]<class U>(const U& value_to_test) // TODO - avoid costly instantiation
         requires StringLike<U>
     {
         std::smatch base_match;
@@ -686,7 +1241,7 @@ template <StringLike T>
 auto regex(T&& r) noexcept
 {
 #if PATUM_HAS_FEATURE_RE2
-    return predicate([r = std::string_view(r)]<class U>(const U& value_to_test)
+    return with_cost<predicate_cost::regex>([r = std::string_view(r)]<class U>(const U& value_to_test)
         requires StringLike<U>
     {
         std::string_view str = value_to_test;
@@ -697,4 +1252,118 @@ auto regex(T&& r) noexcept
 #endif
 }
 
+//=================================================================================================
+
+// Copy of a pattern owning the values referred to by its operators, in() and ds(), for patterns kept past the match
+// building them (see ptm::compile_match). Character arrays, which can't be told apart from string literals, are copied
+// in strings compared the same way; pointers are copied as they are and must outlive the copy.
+template <class T>
+constexpr auto make_owned(const T& pattern)
+{
+    if constexpr (std::is_array_v<T>)
+    {
+        static_assert(StringLike<T>, "Array patterns are compared by address, only character arrays are kept past the match");
+
+        return std::string(pattern);
+    }
+    else
+    {
+        return T(pattern);
+    }
+}
+
+template <class P>
+using owned_pattern_t = decltype(make_owned(std::declval<const P&>()));
+
+template <class F>
+constexpr F make_owned_function(const F& func)
+{
+    return func;
+}
+
+template <class F>
+using owned_function_t = decltype(make_owned_function(std::declval<const F&>()));
+
+template <class F>
+constexpr auto make_owned(const predicate<F>& pattern)
+{
+    return predicate<owned_function_t<F>>(make_owned_function(pattern.function()));
+}
+
+template <class F, predicate_cost Cost>
+constexpr auto make_owned_function(const speculative_function<F, Cost>& func)
+{
+    return speculative_function<owned_function_t<F>, Cost>{ make_owned_function(func.func) };
+}
+
+template <class F, predicate_cost Cost>
+constexpr auto make_owned_function(const costed_function<F, Cost>& func)
+{
+    return costed_function<owned_function_t<F>, Cost>{ make_owned_function(func.func) };
+}
+
+template <class F>
+constexpr auto make_owned_function(const ordered_function<F>& func)
+{
+    return ordered_function<owned_function_t<F>>{ make_owned(func.pred) };
+}
+
+template <class Op, class F, class T>
+constexpr auto make_owned_function(const right_operand_function<Op, F, T>& func)
+{
+    return right_operand_function<Op, owned_function_t<F>, owned_pattern_t<std::remove_cvref_t<T>>>{ make_owned(func.pred), make_owned(func.operand) };
+}
+
+template <class Op, class T, class F>
+constexpr auto make_owned_function(const left_operand_function<Op, T, F>& func)
+{
+    return left_operand_function<Op, owned_pattern_t<std::remove_cvref_t<T>>, owned_function_t<F>>{ make_owned(func.operand), make_owned(func.pred) };
+}
+
+template <class Op, class F, class F2>
+constexpr auto make_owned_function(const operands_function<Op, F, F2>& func)
+{
+    return operands_function<Op, owned_function_t<F>, owned_function_t<F2>>{ make_owned(func.lhs), make_owned(func.rhs) };
+}
+
+template <class Op, class F>
+constexpr auto make_owned_function(const unary_operand_function<Op, F>& func)
+{
+    return unary_operand_function<Op, owned_function_t<F>>{ make_owned(func.pred) };
+}
+
+template <class F, class F2>
+constexpr auto make_owned_function(const conjunction_function<F, F2>& func)
+{
+    return conjunction_function<owned_function_t<F>, owned_function_t<F2>>{ make_owned(func.lhs), make_owned(func.rhs) };
+}
+
+template <class F, class F2>
+constexpr auto make_owned_function(const disjunction_function<F, F2>& func)
+{
+    return disjunction_function<owned_function_t<F>, owned_function_t<F2>>{ make_owned(func.lhs), make_owned(func.rhs) };
+}
+
+template <class... Args>
+constexpr auto make_owned_function(const value_list_function<Args...>& func)
+{
+    return std::apply([](const auto&... values)
+    {
+        using owned_type = value_list_function<owned_pattern_t<std::remove_cvref_t<Args>>...>;
+
+        return owned_type{ std::tuple<owned_pattern_t<std::remove_cvref_t<Args>>...>(make_owned(values)...) };
+    }, func.values);
+}
+
+template <class... Args>
+constexpr auto make_owned_function(const destructure<Args...>& func)
+{
+    return std::apply([](const auto&... values)
+    {
+        using owned_type = destructure<owned_pattern_t<std::remove_cvref_t<Args>>...>;
+
+        return owned_type{ std::tuple<owned_pattern_t<std::remove_cvref_t<Args>>...>(make_owned(values)...) };
+    }, func.values);
+}
+
 } // namespace ptm
@@ -0,0 +1,211 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "adaptive.h"
+#include "literal.h"
+#include "string_table.h"
+
+//=================================================================================================
+
+// Instrumented builds record the hits of every arm of the sites matched with ptm::profiled<"name"> and write them at
+// exit to the file named by the PATUM_PROFILE_OUTPUT environment variable (patum_profile.h by default). Later builds
+// pass that file back through PATUM_PROFILE_HEADER, as in -DPATUM_PROFILE_HEADER='"patum_profile.h"'.
+#ifndef PATUM_PROFILE_RECORD
+#define PATUM_PROFILE_RECORD 0
+#endif
+
+// Declares the hits recorded for a site, one per arm in source order. Generated headers are made of these only.
+#define PATUM_SITE_PROFILE(site, site_signature, ...) \
+    template <> \
+    struct ptm::site_profile<site> \
+    { \
+        inline static constexpr std::uint64_t signature = site_signature; \
+        inline static constexpr auto hits = std::to_array<std::uint64_t>({ __VA_ARGS__ }); \
+    };
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t profile_max_hot_arms = 2;
+inline static constexpr std::uint64_t profile_hot_percent = 90;
+inline static constexpr std::uint64_t profile_likely_percent = 50;
+
+//=================================================================================================
+
+// Hits recorded for a named site, specialized by the generated profile header
+template <fixed_string Site>
+struct site_profile
+{
+};
+
+//=================================================================================================
+
+template <class Subjects, class... Rows>
+consteval std::string_view site_type_names()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+// Identifies what a site matches (the types of its subjects and patterns), so a profile recorded before the site was
+// edited no longer applies to it
+template <class Subjects, class... Rows>
+inline static constexpr std::uint64_t site_signature_v = string_table_hash(site_type_names<Subjects, Rows...>()) ^ sizeof...(Rows);
+
+//=================================================================================================
+
+enum class profile_dispatch
+{
+    unprofiled,    // No profile for the site, or a stale one: the site is matched as without the policy
+    fallback,      // Hits spread over too many arms to beat the strategy selected without the policy
+    likely_chain,  // Arms checked in source order, the hottest one hinted as likely to match
+    ordered_chain, // Disjoint arms checked from the hottest to the coldest
+    hot_first      // The few disjoint arms taking most of the hits checked before the table
+};
+
+template <fixed_string Site, class Subjects, class... Rows>
+struct profile_plan
+{
+    inline static constexpr std::size_t arm_count = sizeof...(Rows);
+    inline static constexpr std::size_t disjoint_count = disjoint_arms<Rows...>::count;
+    inline static constexpr std::uint64_t signature = site_signature_v<Subjects, Rows...>;
+
+    static consteval std::array<std::uint64_t, arm_count> profile_hits()
+    {
+        std::array<std::uint64_t, arm_count> result{};
+
+        if constexpr (requires { site_profile<Site>::signature; site_profile<Site>::hits; })
+        {
+            if constexpr (site_profile<Site>::hits.size() == arm_count)
+            {
+                if (site_profile<Site>::signature == signature)
+                {
+                    for (std::size_t arm = 0; arm < arm_count; ++arm)
+                        result[arm] = site_profile<Site>::hits[arm];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    inline static constexpr std::array<std::uint64_t, arm_count> hits = profile_hits();
+
+    inline static constexpr std::uint64_t total = []
+    {
+        std::uint64_t result = 0;
+
+        for (const auto count : hits)
+            result += count;
+
+        return result;
+    }();
+
+    inline static constexpr bool valid = total != 0;
+
+    // Disjoint arms from the hottest to the coldest (ties kept in source order), followed by the others in source order
+    inline static constexpr std::array<std::size_t, arm_count> order = []
+    {
+        std::array<std::size_t, arm_count> result{};
+
+        for (std::size_t arm = 0; arm < arm_count; ++arm)
+            result[arm] = arm;
+
+        for (std::size_t arm = 1; arm < disjoint_count; ++arm)
+        {
+            for (std::size_t index = arm; index > 0 && hits[result[index - 1]] < hits[result[index]]; --index)
+                std::swap(result[index - 1], result[index]);
+        }
+
+        return result;
+    }();
+
+    static constexpr bool has_share(std::uint64_t count, std::uint64_t percent) noexcept
+    {
+        return count * 100 >= total * percent;
+    }
+
+    inline static constexpr std::size_t hottest_arm = []
+    {
+        std::size_t result = 0;
+
+        for (std::size_t arm = 1; arm < arm_count; ++arm)
+        {
+            if (hits[arm] > hits[result])
+                result = arm;
+        }
+
+        return result;
+    }();
+
+    // Fewest hottest disjoint arms taking most of the hits, none when more than a couple are needed
+    inline static constexpr std::size_t hot_count = []
+    {
+        std::uint64_t count = 0;
+
+        for (std::size_t index = 0; valid && index < profile_max_hot_arms && index < disjoint_count; ++index)
+        {
+            count += hits[order[index]];
+
+            if (has_share(count, profile_hot_percent))
+                return index + 1;
+        }
+
+        return std::size_t(0);
+    }();
+
+    inline static constexpr bool reorderable = disjoint_count > 1;
+
+    static consteval profile_dispatch select_dispatch(bool chained)
+    {
+        if (not valid)
+            return profile_dispatch::unprofiled;
+
+        else if (chained)
+            return reorderable ? profile_dispatch::ordered_chain : profile_dispatch::likely_chain;
+
+        else
+            return hot_count != 0 ? profile_dispatch::hot_first : profile_dispatch::fallback;
+    }
+
+    // Arm whose check is hinted as likely to succeed, arm_count for none
+    static consteval std::size_t select_likely_arm(profile_dispatch dispatch)
+    {
+        if (dispatch == profile_dispatch::unprofiled || dispatch == profile_dispatch::fallback)
+            return arm_count;
+
+        const std::size_t arm = dispatch == profile_dispatch::likely_chain ? hottest_arm : order[0];
+
+        return has_share(hits[arm], profile_likely_percent) ? arm : arm_count;
+    }
+};
+
+} // namespace ptm
+
+//=================================================================================================
+
+// Only instrumented builds pay for the registry writing the recorded hits
+#if PATUM_PROFILE_RECORD
+#include "profile_record.h"
+#endif
+
+#if defined(PATUM_PROFILE_HEADER)
+#include PATUM_PROFILE_HEADER
+#endif
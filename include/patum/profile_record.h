@@ -0,0 +1,134 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "literal.h"
+#include "profile.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+struct site_record
+{
+    std::string_view name;
+    std::uint64_t signature;
+    const std::atomic<std::uint64_t>* hits;
+    std::size_t arm_count;
+};
+
+// Sites recorded by this process, written as a header of PATUM_SITE_PROFILE declarations
+class profile_registry
+{
+public:
+    static profile_registry& instance()
+    {
+        static profile_registry registry;
+        return registry;
+    }
+
+    void add(const site_record& record)
+    {
+        const std::lock_guard lock(mutex_);
+        records_.push_back(record);
+    }
+
+    void write(std::ostream& stream) const
+    {
+        const std::lock_guard lock(mutex_);
+
+        stream << "// patum site profile, generated by an instrumented build: pass it back through PATUM_PROFILE_HEADER\n";
+        stream << "#pragma once\n\n";
+
+        for (std::size_t index = 0; index < records_.size(); ++index)
+        {
+            const auto& record = records_[index];
+
+            // A name given to several sites can only describe one of them, the first recorded is kept
+            bool duplicate = false;
+            for (std::size_t other = 0; other < index; ++other)
+                duplicate = duplicate || records_[other].name == record.name;
+
+            if (duplicate)
+                continue;
+
+            stream << "PATUM_SITE_PROFILE(\"";
+
+            for (const char c : record.name)
+            {
+                if (c == '"' || c == '\\')
+                    stream << '\\';
+
+                stream << c;
+            }
+
+            stream << "\", 0x" << std::hex << record.signature << "ull" << std::dec;
+
+            for (std::size_t arm = 0; arm < record.arm_count; ++arm)
+                stream << ", " << record.hits[arm].load(std::memory_order_relaxed);
+
+            stream << ")\n";
+        }
+    }
+
+    profile_registry(const profile_registry&) = delete;
+    profile_registry& operator=(const profile_registry&) = delete;
+
+private:
+    profile_registry() = default;
+
+    ~profile_registry()
+    {
+#if PATUM_PROFILE_RECORD
+        if (records_.empty())
+            return;
+
+        const char* path = std::getenv("PATUM_PROFILE_OUTPUT");
+
+        if (std::ofstream stream(path != nullptr ? path : "patum_profile.h"); stream)
+            write(stream);
+#endif
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<site_record> records_;
+};
+
+// Hit counters of a recorded site. They are constant initialized and trivially destructible, so they are still there
+// when the registry writes them at exit.
+template <std::size_t ArmCount>
+struct profile_counters
+{
+    std::array<std::atomic<std::uint64_t>, ArmCount> hits{};
+    std::atomic<bool> registered{ false };
+
+    void record(std::string_view site, std::uint64_t signature, std::size_t arm)
+    {
+        if (not registered.load(std::memory_order_acquire) && not registered.exchange(true, std::memory_order_acq_rel))
+            profile_registry::instance().add({ site, signature, hits.data(), ArmCount });
+
+        hits[arm].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+template <fixed_string Site, std::uint64_t Signature, std::size_t ArmCount>
+inline profile_counters<ArmCount> profile_site_counters{};
+
+} // namespace ptm
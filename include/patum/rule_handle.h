@@ -0,0 +1,238 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "expect.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t rule_handle_default_readers = 64;
+
+//=================================================================================================
+
+// Rule handles hold the current version of rules (a rule_set, a mapped_rule_image, a rule_program or anything else
+// matched through a const reference) that writers replace while readers keep matching. Readers are wait-free: they
+// announce the epoch they start in, load the current version and match it, then leave. Writers swap the version, move
+// the epoch forward and retire the previous version with it, freeing it once every reader is either gone or has
+// started in a later epoch, and so can only have seen a newer version.
+
+template <class Rules>
+class rule_reader;
+
+template <class Rules>
+class rule_handle
+{
+public:
+    explicit rule_handle(Rules rules, std::size_t max_readers = rule_handle_default_readers)
+        : slots_(std::make_unique<slot[]>(max_readers))
+        , slot_count_(max_readers)
+        , current_(new Rules(std::move(rules)))
+    {
+    }
+
+    rule_handle(const rule_handle&) = delete;
+    rule_handle& operator=(const rule_handle&) = delete;
+
+    ~rule_handle()
+    {
+        for (std::size_t index = 0; index < slot_count_; ++index)
+            expect(not slots_[index].used.load(std::memory_order_relaxed));
+
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    // Takes a reader slot for the calling thread, given back when the reader is destroyed. None is left once max_readers
+    // readers are alive.
+    [[nodiscard]] std::optional<rule_reader<Rules>> reader()
+    {
+        for (std::size_t index = 0; index < slot_count_; ++index)
+        {
+            if (not slots_[index].used.exchange(true, std::memory_order_acquire))
+                return rule_reader<Rules>(this, &slots_[index]);
+        }
+
+        return std::nullopt;
+    }
+
+    // Replaces the rules, readers already matching keep the previous version until they are done with it
+    void publish(Rules rules)
+    {
+        auto next = std::make_unique<Rules>(std::move(rules));
+
+        std::lock_guard lock(mutex_);
+
+        std::unique_ptr<const Rules> previous(current_.exchange(next.release(), std::memory_order_seq_cst));
+        retired_.push_back({ epoch_.fetch_add(1, std::memory_order_seq_cst) + 1, std::move(previous) });
+
+        reclaim_retired();
+    }
+
+    // Frees the retired versions no reader can still see, returns how many are left
+    std::size_t reclaim()
+    {
+        std::lock_guard lock(mutex_);
+
+        reclaim_retired();
+
+        return retired_.size();
+    }
+
+    std::size_t pending() const
+    {
+        std::lock_guard lock(mutex_);
+
+        return retired_.size();
+    }
+
+    // Number of versions published so far
+    std::uint64_t version() const noexcept
+    {
+        return epoch_.load(std::memory_order_relaxed) - 1;
+    }
+
+private:
+    friend class rule_reader<Rules>;
+
+    // One cache line per reader, so announcing an epoch never invalidates the line of another reader
+    struct alignas(64) slot
+    {
+        std::atomic<std::uint64_t> epoch = 0;
+        std::atomic<bool> used = false;
+    };
+
+    struct retired
+    {
+        std::uint64_t epoch;
+        std::unique_ptr<const Rules> rules;
+    };
+
+    void reclaim_retired()
+    {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+
+        for (std::size_t index = 0; index < slot_count_; ++index)
+        {
+            const auto epoch = slots_[index].epoch.load(std::memory_order_seq_cst);
+
+            if (epoch != 0 && epoch < oldest)
+                oldest = epoch;
+        }
+
+        // Retired in epoch order, the versions retired by the oldest reader epoch are the ones it can still hold
+        std::size_t freed = 0;
+        while (freed < retired_.size() && retired_[freed].epoch <= oldest)
+            ++freed;
+
+        retired_.erase(retired_.begin(), retired_.begin() + static_cast<std::ptrdiff_t>(freed));
+    }
+
+    std::unique_ptr<slot[]> slots_;
+    std::size_t slot_count_ = 0;
+
+    std::atomic<const Rules*> current_;
+    std::atomic<std::uint64_t> epoch_ = 1;
+
+    mutable std::mutex mutex_;
+    std::vector<retired> retired_;
+};
+
+//=================================================================================================
+
+// Matching side of a rule handle, owned by a single thread. Reads nest, the outermost one keeping alive every version
+// seen inside it.
+template <class Rules>
+class rule_reader
+{
+public:
+    rule_reader(rule_reader&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+        , slot_(std::exchange(other.slot_, nullptr))
+    {
+    }
+
+    rule_reader& operator=(rule_reader&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+
+            handle_ = std::exchange(other.handle_, nullptr);
+            slot_ = std::exchange(other.slot_, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~rule_reader()
+    {
+        release();
+    }
+
+    // Calls the function with the current rules, which stay alive until it returns
+    template <class F>
+    decltype(auto) read(F&& function) const
+    {
+        const bool outermost = slot_->epoch.load(std::memory_order_relaxed) == 0;
+
+        if (outermost)
+            slot_->epoch.store(handle_->epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+
+        struct leave
+        {
+            typename rule_handle<Rules>::slot* slot;
+            bool outermost;
+
+            ~leave()
+            {
+                if (outermost)
+                    slot->epoch.store(0, std::memory_order_release);
+            }
+        } guard{ slot_, outermost };
+
+        return std::forward<F>(function)(*handle_->current_.load(std::memory_order_seq_cst));
+    }
+
+    template <class... U>
+    decltype(auto) match(const U&... values) const
+    {
+        return read([&](const Rules& rules) { return rules.match(values...); });
+    }
+
+private:
+    friend class rule_handle<Rules>;
+
+    rule_reader(rule_handle<Rules>* handle, typename rule_handle<Rules>::slot* slot)
+        : handle_(handle)
+        , slot_(slot)
+    {
+    }
+
+    void release() noexcept
+    {
+        if (slot_ != nullptr)
+            slot_->used.store(false, std::memory_order_release);
+    }
+
+    rule_handle<Rules>* handle_ = nullptr;
+    typename rule_handle<Rules>::slot* slot_ = nullptr;
+};
+
+} // namespace ptm
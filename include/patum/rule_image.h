@@ -0,0 +1,766 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concepts.h"
+#include "expect.h"
+#include "features.h"
+#include "rule_set.h"
+#include "string_table.h"
+
+#if PATUM_HAS_FEATURE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ptm {
+
+//=================================================================================================
+
+// Rule images are frozen rule sets laid out in a single block of bytes: the actions, then for each column its
+// conditions, their values, the characters of its strings, an open addressing hash table over its equality keys and the
+// rules listed under each key. Every section is addressed by its offset from the start of the image, so a file holding
+// one is mapped read only and matched in place without being parsed, its pages shared by every process mapping it.
+// Images are native: they are read back on machines of the same byte order, by rule sets of the same column types.
+
+inline static constexpr char rule_image_magic[8] = "PATUMRI";
+inline static constexpr std::uint32_t rule_image_version = 1;
+inline static constexpr std::uint32_t rule_image_byte_order = 0x01020304;
+inline static constexpr std::uint32_t rule_image_empty_slot = std::numeric_limits<std::uint32_t>::max();
+
+struct rule_image_error
+{
+    std::string message;
+};
+
+enum class rule_image_type : std::uint32_t
+{
+    signed_integer = 1,
+    unsigned_integer,
+    string
+};
+
+struct rule_image_section
+{
+    std::uint64_t offset = 0;
+    std::uint64_t count = 0;
+};
+
+struct rule_image_header
+{
+    char magic[8] = {};
+    std::uint32_t version = 0;
+    std::uint32_t byte_order = 0;
+    std::uint64_t size = 0;
+    std::uint32_t column_count = 0;
+    std::uint32_t rule_count = 0;
+    rule_image_section actions;
+};
+
+struct rule_image_column_header
+{
+    rule_image_type type = rule_image_type::signed_integer;
+    std::uint32_t value_size = 0;
+    rule_image_section conditions;
+    rule_image_section values;
+    rule_image_section characters;
+    rule_image_section slots;
+    rule_image_section postings;
+    rule_image_section unindexed;
+};
+
+struct rule_image_condition
+{
+    std::uint32_t kind = 0;
+    std::uint32_t offset = 0;
+    std::uint32_t count = 0;
+};
+
+struct rule_image_string
+{
+    std::uint32_t offset = 0;
+    std::uint32_t size = 0;
+};
+
+// Key of the table (an index in the values of the column) and the rules listed under it
+struct rule_image_slot
+{
+    std::uint32_t hash = 0;
+    std::uint32_t value = rule_image_empty_slot;
+    std::uint32_t offset = 0;
+    std::uint32_t count = 0;
+};
+
+//=================================================================================================
+
+template <class T>
+concept RuleImageValue = StringLike<T> || std::is_integral_v<T> || std::is_enum_v<T>;
+
+template <class T>
+using rule_image_stored_t = std::conditional_t<StringLike<T>, rule_image_string, T>;
+
+template <RuleImageValue T>
+consteval rule_image_type rule_image_type_of()
+{
+    if constexpr (StringLike<T>)
+        return rule_image_type::string;
+    else if constexpr (std::is_enum_v<T>)
+        return std::is_signed_v<std::underlying_type_t<T>> ? rule_image_type::signed_integer : rule_image_type::unsigned_integer;
+    else
+        return std::is_signed_v<T> ? rule_image_type::signed_integer : rule_image_type::unsigned_integer;
+}
+
+// Stored in the image, so unlike std::hash it must give the same result in every build reading it
+template <class T, class U>
+std::uint32_t rule_image_hash(const U& value) noexcept
+{
+    std::uint64_t hash = 0;
+
+    if constexpr (StringLike<T>)
+        hash = string_table_hash(std::string_view(value));
+    else if constexpr (std::is_enum_v<T>)
+        hash = string_table_remix(static_cast<std::uint64_t>(static_cast<std::underlying_type_t<T>>(static_cast<T>(value))), 0);
+    else
+        hash = string_table_remix(static_cast<std::uint64_t>(static_cast<T>(value)), 0);
+
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+//=================================================================================================
+
+// Column of a rule image, answering the same queries as a frozen rule_column
+template <class T>
+struct rule_image_column
+{
+    using value_type = std::conditional_t<StringLike<T>, std::string_view, T>;
+
+    const rule_image_condition* conditions = nullptr;
+    const rule_image_stored_t<T>* values = nullptr;
+    const char* characters = nullptr;
+    const rule_image_slot* slots = nullptr;
+    std::uint32_t slot_mask = 0;
+    const std::uint32_t* postings = nullptr;
+    std::span<const std::uint32_t> unindexed;
+
+    value_type value(std::uint32_t index) const noexcept
+    {
+        if constexpr (StringLike<T>)
+            return { characters + values[index].offset, values[index].size };
+        else
+            return values[index];
+    }
+
+    bool is_indexed() const noexcept
+    {
+        return slots != nullptr;
+    }
+
+    template <class U>
+    std::span<const std::uint32_t> candidates(const U& key) const
+    {
+        const auto hash = rule_image_hash<T>(key);
+
+        for (std::uint32_t probe = 0, index = hash & slot_mask; probe <= slot_mask; ++probe, index = (index + 1) & slot_mask)
+        {
+            const auto& slot = slots[index];
+
+            if (slot.value == rule_image_empty_slot)
+                break;
+
+            if (slot.hash == hash && value(slot.value) == key)
+                return { postings + slot.offset, slot.count };
+        }
+
+        return {};
+    }
+
+    template <class U>
+    bool check(std::uint32_t rule, const U& key) const
+    {
+        const auto& c = conditions[rule];
+
+        switch (static_cast<rule_condition_kind>(c.kind))
+        {
+        case rule_condition_kind::any:
+            return true;
+
+        case rule_condition_kind::equal:
+            return value(c.offset) == key;
+
+        case rule_condition_kind::range:
+            return not (key < value(c.offset)) && not (value(c.offset + 1) < key);
+
+        case rule_condition_kind::set:
+            for (std::uint32_t element = 0; element < c.count; ++element)
+            {
+                if (value(c.offset + element) == key)
+                    return true;
+            }
+
+            return false;
+        }
+
+        return false;
+    }
+};
+
+//=================================================================================================
+
+template <class... Columns>
+struct rule_image_writer
+{
+    static_assert((RuleImageValue<Columns> && ...), "Rule images hold integral, enum and string columns");
+
+    static std::vector<std::byte> write(const rule_set<Columns...>& rules)
+    {
+        std::vector<std::byte> image(sizeof(rule_image_header) + sizeof...(Columns) * sizeof(rule_image_column_header));
+
+        rule_image_header header;
+        std::memcpy(header.magic, rule_image_magic, sizeof(header.magic));
+        header.version = rule_image_version;
+        header.byte_order = rule_image_byte_order;
+        header.column_count = static_cast<std::uint32_t>(sizeof...(Columns));
+        header.rule_count = static_cast<std::uint32_t>(rules.actions_.size());
+        header.actions = append(image, std::span<const rule_action>(rules.actions_));
+
+        const auto columns = std::apply([&](const auto&... column)
+        {
+            return std::array<rule_image_column_header, sizeof...(Columns)>{ write_column(image, column)... };
+        }, rules.columns_);
+
+        header.size = image.size();
+
+        std::memcpy(image.data(), &header, sizeof(header));
+        std::memcpy(image.data() + sizeof(header), columns.data(), sizeof(columns));
+
+        return image;
+    }
+
+private:
+    template <class T>
+    static rule_image_column_header write_column(std::vector<std::byte>& image, const rule_column<T>& column)
+    {
+        std::vector<rule_image_condition> conditions;
+        std::vector<rule_image_stored_t<T>> values;
+        std::string characters;
+        std::vector<rule_image_slot> slots;
+
+        const auto store = [&](const T& value)
+        {
+            if constexpr (StringLike<T>)
+            {
+                const auto text = std::string_view(value);
+
+                values.push_back({ static_cast<std::uint32_t>(characters.size()), static_cast<std::uint32_t>(text.size()) });
+                characters.append(text);
+            }
+            else
+            {
+                values.push_back(value);
+            }
+
+            return static_cast<std::uint32_t>(values.size() - 1);
+        };
+
+        conditions.reserve(column.conditions.size());
+        for (const auto& c : column.conditions)
+            conditions.push_back({ static_cast<std::uint32_t>(c.kind), c.offset, c.count });
+
+        values.reserve(column.values.size() + column.index.size());
+        for (const auto& value : column.values)
+            store(value);
+
+        // Half full at most, so probing always ends on an empty slot
+        if (column.is_indexed())
+        {
+            std::size_t capacity = 2;
+            while (capacity < column.index.size() * 2)
+                capacity *= 2;
+
+            expect(capacity <= std::numeric_limits<std::uint32_t>::max());
+
+            slots.resize(capacity);
+
+            for (const auto& [key, bucket] : column.index)
+            {
+                const auto hash = rule_image_hash<T>(key);
+
+                auto index = hash & (capacity - 1);
+                while (slots[index].value != rule_image_empty_slot)
+                    index = (index + 1) & (capacity - 1);
+
+                slots[index] = { hash, store(key), bucket.offset, bucket.count };
+            }
+        }
+
+        expect(characters.size() <= std::numeric_limits<std::uint32_t>::max());
+
+        rule_image_column_header header;
+        header.type = rule_image_type_of<T>();
+        header.value_size = static_cast<std::uint32_t>(sizeof(rule_image_stored_t<T>));
+        header.conditions = append(image, std::span<const rule_image_condition>(conditions));
+        header.values = append(image, std::span<const rule_image_stored_t<T>>(values));
+        header.characters = append(image, std::span<const char>(characters));
+        header.slots = append(image, std::span<const rule_image_slot>(slots));
+        header.postings = append(image, std::span<const std::uint32_t>(column.postings));
+        header.unindexed = append(image, std::span<const std::uint32_t>(column.unindexed));
+
+        return header;
+    }
+
+    // Sections start on 8 bytes boundaries, the alignment of the mapping is then enough for any of them
+    template <class E>
+    static rule_image_section append(std::vector<std::byte>& image, std::span<const E> elements)
+    {
+        image.resize((image.size() + 7) & ~std::size_t(7));
+
+        const rule_image_section section{ image.size(), elements.size() };
+        const auto bytes = std::as_bytes(elements);
+
+        image.insert(image.end(), bytes.begin(), bytes.end());
+
+        return section;
+    }
+};
+
+// Lays out the frozen rule set as an image
+template <class... Columns>
+[[nodiscard]] std::vector<std::byte> make_rule_image(const rule_set<Columns...>& rules)
+{
+    return rule_image_writer<Columns...>::write(rules);
+}
+
+// Writes the image next to the file then renames it over, so processes still mapping the previous file keep its pages
+template <class... Columns>
+bool save_rule_image(const rule_set<Columns...>& rules, const std::filesystem::path& path, rule_image_error* error = nullptr)
+{
+    const auto image = make_rule_image(rules);
+
+    auto temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+
+        if (not stream.flush())
+        {
+            if (error != nullptr)
+                error->message = "Cannot write '" + temporary.string() + "'";
+
+            return false;
+        }
+    }
+
+    std::error_code code;
+    std::filesystem::rename(temporary, path, code);
+
+    if (code)
+    {
+        if (error != nullptr)
+            error->message = "Cannot rename '" + temporary.string() + "': " + code.message();
+
+        std::filesystem::remove(temporary, code);
+        return false;
+    }
+
+    return true;
+}
+
+//=================================================================================================
+
+// Rule set read in place from the bytes of an image, which must outlive it. Opening checks the header, that every
+// section lies within the bytes and, in one pass over the sections, that every kind and index they hold stays in range,
+// so matching a damaged or hostile image never reads outside of it.
+template <class... Columns>
+class rule_image
+{
+public:
+    static_assert((RuleImageValue<Columns> && ...), "Rule images hold integral, enum and string columns");
+
+    [[nodiscard]] static std::optional<rule_image> open(std::span<const std::byte> bytes, rule_image_error* error = nullptr)
+    {
+        const auto fail = [&](const char* message)
+        {
+            if (error != nullptr)
+                error->message = message;
+
+            return std::nullopt;
+        };
+
+        if (bytes.size() < sizeof(rule_image_header) + sizeof...(Columns) * sizeof(rule_image_column_header))
+            return fail("Rule image is truncated");
+
+        if (reinterpret_cast<std::uintptr_t>(bytes.data()) % 8 != 0)
+            return fail("Rule image is not aligned on 8 bytes");
+
+        rule_image_header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, rule_image_magic, sizeof(header.magic)) != 0)
+            return fail("Not a rule image");
+
+        if (header.version != rule_image_version)
+            return fail("Unsupported rule image version");
+
+        if (header.byte_order != rule_image_byte_order)
+            return fail("Rule image written with another byte order");
+
+        if (header.size > bytes.size())
+            return fail("Rule image is truncated");
+
+        bytes = bytes.first(static_cast<std::size_t>(header.size));
+
+        if (header.column_count != sizeof...(Columns))
+            return fail("Rule image columns differ from the rule set");
+
+        bool valid = true;
+
+        const auto section = [&]<class E>(std::type_identity<E>, const rule_image_section& s) -> const E*
+        {
+            if (s.offset % alignof(E) != 0 || s.offset > bytes.size() || s.count > (bytes.size() - s.offset) / sizeof(E))
+            {
+                valid = false;
+                return nullptr;
+            }
+
+            return reinterpret_cast<const E*>(bytes.data() + s.offset);
+        };
+
+        rule_image result;
+        result.bytes_ = bytes;
+        result.actions_ = { section(std::type_identity<rule_action>{}, header.actions), static_cast<std::size_t>(header.actions.count) };
+
+        if (header.actions.count != header.rule_count)
+            return fail("Rule image is corrupted");
+
+        bool matching = true;
+
+        std::apply([&](auto&... columns)
+        {
+            std::size_t index = 0;
+
+            const auto open_column = [&]<class T>(rule_image_column<T>& column)
+            {
+                rule_image_column_header h;
+                std::memcpy(&h, bytes.data() + sizeof(header) + index++ * sizeof(h), sizeof(h));
+
+                if (h.type != rule_image_type_of<T>() || h.value_size != sizeof(rule_image_stored_t<T>))
+                {
+                    matching = false;
+                    return;
+                }
+
+                column.conditions = section(std::type_identity<rule_image_condition>{}, h.conditions);
+                column.values = section(std::type_identity<rule_image_stored_t<T>>{}, h.values);
+                column.characters = section(std::type_identity<char>{}, h.characters);
+                column.postings = section(std::type_identity<std::uint32_t>{}, h.postings);
+                column.unindexed = { section(std::type_identity<std::uint32_t>{}, h.unindexed), static_cast<std::size_t>(h.unindexed.count) };
+
+                // Slot counts are powers of two, none for unindexed columns
+                if (h.slots.count != 0)
+                {
+                    column.slots = section(std::type_identity<rule_image_slot>{}, h.slots);
+                    column.slot_mask = static_cast<std::uint32_t>(h.slots.count - 1);
+
+                    valid = valid && (h.slots.count & (h.slots.count - 1)) == 0 && h.slots.count <= rule_image_empty_slot;
+                }
+
+                valid = valid && h.conditions.count == header.rule_count && h.unindexed.count <= header.rule_count;
+
+                if (valid)
+                    valid = is_valid_column(column, h, header.rule_count);
+            };
+
+            (open_column(columns), ...);
+        }, result.columns_);
+
+        if (not matching)
+            return fail("Rule image columns differ from the rule set");
+
+        if (not valid)
+            return fail("Rule image is corrupted");
+
+        return result;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return actions_.size();
+    }
+
+    bool is_indexed(std::size_t column) const noexcept
+    {
+        return std::apply([&](const auto&... columns)
+        {
+            std::size_t index = 0;
+            return ((index++ == column && columns.is_indexed()) || ...);
+        }, columns_);
+    }
+
+    // Action of the matching rule of highest priority, as the rule set the image was made of
+    template <class... U>
+        requires(sizeof...(U) == sizeof...(Columns))
+    std::optional<rule_action> match(const U&... values) const
+    {
+        const auto rule = find_rule(columns_, actions_.size(), values...);
+
+        return rule < actions_.size() ? std::optional<rule_action>(actions_[rule]) : std::nullopt;
+    }
+
+    std::span<const std::byte> bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+private:
+    rule_image() = default;
+
+    // Contents of a column whose sections lie within the image, checked against the sections they index
+    template <class T>
+    static bool is_valid_column(const rule_image_column<T>& column, const rule_image_column_header& h, std::uint32_t rule_count) noexcept
+    {
+        for (std::uint64_t rule = 0; rule < h.conditions.count; ++rule)
+        {
+            const auto& c = column.conditions[rule];
+
+            if (c.kind > static_cast<std::uint32_t>(rule_condition_kind::set))
+                return false;
+
+            // Values read by check: none for any, one for equal, two for range, count for set
+            const auto kind = static_cast<rule_condition_kind>(c.kind);
+
+            if ((kind == rule_condition_kind::equal && c.count != 1) || (kind == rule_condition_kind::range && c.count != 2))
+                return false;
+
+            if (kind != rule_condition_kind::any && std::uint64_t(c.offset) + c.count > h.values.count)
+                return false;
+        }
+
+        if constexpr (StringLike<T>)
+        {
+            for (std::uint64_t index = 0; index < h.values.count; ++index)
+            {
+                if (std::uint64_t(column.values[index].offset) + column.values[index].size > h.characters.count)
+                    return false;
+            }
+        }
+
+        for (std::uint64_t index = 0; index < h.slots.count; ++index)
+        {
+            const auto& slot = column.slots[index];
+
+            if (slot.value == rule_image_empty_slot)
+                continue;
+
+            if (slot.value >= h.values.count || std::uint64_t(slot.offset) + slot.count > h.postings.count)
+                return false;
+        }
+
+        const auto is_rule = [&](std::uint32_t rule) { return rule < rule_count; };
+
+        return std::all_of(column.postings, column.postings + h.postings.count, is_rule)
+            && std::all_of(column.unindexed.begin(), column.unindexed.end(), is_rule);
+    }
+
+    std::span<const std::byte> bytes_;
+    std::span<const rule_action> actions_;
+    std::tuple<rule_image_column<Columns>...> columns_;
+};
+
+//=================================================================================================
+
+// Whole file mapped read only, its pages shared by every process mapping it. Without memory mappings the file is read
+// in memory instead.
+class rule_image_file
+{
+public:
+    rule_image_file() = default;
+
+    rule_image_file(rule_image_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+#if !PATUM_HAS_FEATURE_MMAP
+        , buffer_(std::move(other.buffer_))
+#endif
+    {
+    }
+
+    rule_image_file& operator=(rule_image_file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#if !PATUM_HAS_FEATURE_MMAP
+            buffer_ = std::move(other.buffer_);
+#endif
+        }
+
+        return *this;
+    }
+
+    ~rule_image_file()
+    {
+        unmap();
+    }
+
+    [[nodiscard]] static std::optional<rule_image_file> open(const std::filesystem::path& path, rule_image_error* error = nullptr)
+    {
+        const auto fail = [&](const char* message)
+        {
+            if (error != nullptr)
+                error->message = std::string(message) + " '" + path.string() + "'";
+
+            return std::nullopt;
+        };
+
+        rule_image_file result;
+
+#if PATUM_HAS_FEATURE_MMAP
+        const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0)
+            return fail("Cannot open");
+
+        struct stat status;
+        if (::fstat(descriptor, &status) != 0 || status.st_size <= 0)
+        {
+            ::close(descriptor);
+            return fail("Cannot map empty or unreadable");
+        }
+
+        // The mapping keeps the file alive once the descriptor is closed
+        void* data = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+
+        if (data == MAP_FAILED)
+            return fail("Cannot map");
+
+        result.data_ = static_cast<const std::byte*>(data);
+        result.size_ = static_cast<std::size_t>(status.st_size);
+#else
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (not stream)
+            return fail("Cannot open");
+
+        const auto size = static_cast<std::size_t>(stream.tellg());
+        stream.seekg(0);
+
+        // Words keep the contents aligned like a mapping would
+        result.buffer_.resize((size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+
+        if (not stream.read(reinterpret_cast<char*>(result.buffer_.data()), static_cast<std::streamsize>(size)))
+            return fail("Cannot read");
+
+        result.data_ = reinterpret_cast<const std::byte*>(result.buffer_.data());
+        result.size_ = size;
+#endif
+
+        return result;
+    }
+
+    std::span<const std::byte> bytes() const noexcept
+    {
+        return { data_, size_ };
+    }
+
+private:
+    void unmap() noexcept
+    {
+#if PATUM_HAS_FEATURE_MMAP
+        if (data_ != nullptr)
+            ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    }
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+
+#if !PATUM_HAS_FEATURE_MMAP
+    std::vector<std::uint64_t> buffer_;
+#endif
+};
+
+//=================================================================================================
+
+// Rule image matched straight from the mapping of its file
+template <class... Columns>
+class mapped_rule_image
+{
+public:
+    [[nodiscard]] static std::optional<mapped_rule_image> open(const std::filesystem::path& path, rule_image_error* error = nullptr)
+    {
+        auto file = rule_image_file::open(path, error);
+        if (not file)
+            return std::nullopt;
+
+        auto image = rule_image<Columns...>::open(file->bytes(), error);
+        if (not image)
+            return std::nullopt;
+
+        return mapped_rule_image(std::move(*file), *image);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return image_.size();
+    }
+
+    bool is_indexed(std::size_t column) const noexcept
+    {
+        return image_.is_indexed(column);
+    }
+
+    template <class... U>
+        requires(sizeof...(U) == sizeof...(Columns))
+    std::optional<rule_action> match(const U&... values) const
+    {
+        return image_.match(values...);
+    }
+
+    const rule_image<Columns...>& image() const noexcept
+    {
+        return image_;
+    }
+
+private:
+    // Moving the file keeps its bytes where they are, so the image still points into them
+    mapped_rule_image(rule_image_file file, const rule_image<Columns...>& image)
+        : file_(std::move(file))
+        , image_(image)
+    {
+    }
+
+    rule_image_file file_;
+    rule_image<Columns...> image_;
+};
+
+} // namespace ptm
@@ -0,0 +1,1111 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concepts.h"
+#include "features.h"
+#include "rule_set.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+// Rule scripts are matches written in a text file and compiled when loaded, so they can change without a rebuild:
+//
+//   // Fields of the subject matched, as registered in the rule_fields given to compile_rules
+//   match(method, status)
+//
+//   pattern("GET", range(200, 299))              = 1
+//   pattern(in("PUT", "POST"), _x >= 500)        = 2
+//   pattern(_, !(_x == 404) && (_x < 100 || _x > 599)) = 3
+//   pattern(_, 404)                              = 4
+//   pattern(_)                                   = 0
+//
+// Patterns take the vocabulary of the library: _, literals, in(...), range(first, last), comparisons of _x with a
+// literal, &&, || and ! with parentheses, and ds(...) on groups of fields. Fields left out at the end of a pattern match
+// anything. Arms are tried in order and give the integer after them. Integer fields read any integral or enumeration,
+// string fields a reference to a string, a std::string_view or a const char*, which must stay valid while the subject
+// is. A group of fields registered with rule_fields::add_group is matched by ds(...) as an aggregate is:
+//
+//   match(method, peer)
+//
+//   pattern("GET", ds("localhost", _x >= 1024))   = 1
+//   pattern(_, ds(_, 80) || ds(_, 443))           = 2
+
+inline static constexpr std::size_t rule_script_max_fields = 32;
+
+// Patterns are parsed and compiled recursively, scripts nesting parentheses, ! or chains of && and || deeper than this
+// are rejected instead of overflowing the stack
+inline static constexpr std::size_t rule_script_max_depth = 256;
+
+enum class rule_value_kind : std::uint8_t
+{
+    integer,
+    string
+};
+
+template <class T>
+class rule_program;
+
+// Named accessors to the fields of a subject of type T. Accessors are member pointers or callables taking a subject,
+// kept inline without allocating, so they must be trivially copyable and small (captureless or capturing a pointer).
+template <class T>
+class rule_fields
+{
+public:
+    template <class F>
+        requires(std::is_trivially_copyable_v<F> && std::is_invocable_v<const F&, const T&>)
+    rule_fields& add(std::string_view name, F accessor)
+    {
+        static_assert(sizeof(F) <= sizeof(field::storage) && alignof(F) <= alignof(std::max_align_t),
+            "Field accessors must be member pointers or small callables");
+
+        using result_type = std::remove_cvref_t<std::invoke_result_t<const F&, const T&>>;
+
+        field entry;
+        entry.name = std::string(name);
+        ::new (static_cast<void*>(entry.storage)) F(accessor);
+
+        if constexpr (std::integral<result_type> || std::is_enum_v<result_type>)
+        {
+            using integer_type = typename std::conditional_t<std::is_enum_v<result_type>,
+                std::underlying_type<result_type>,
+                std::type_identity<result_type>>::type;
+
+            static_assert(std::is_signed_v<integer_type> || sizeof(integer_type) < sizeof(std::int64_t),
+                "Unsigned 64 bits fields don't fit the signed 64 bits registers, narrow them in the accessor");
+
+            entry.kind = rule_value_kind::integer;
+            entry.load_integer = [](const std::byte* storage, const T& subject)
+            {
+                return static_cast<std::int64_t>(std::invoke(*std::launder(reinterpret_cast<const F*>(storage)), subject));
+            };
+        }
+        else
+        {
+            static_assert(StringLike<result_type>, "Fields are integral, enumerations or strings");
+            static_assert(std::is_lvalue_reference_v<std::invoke_result_t<const F&, const T&>>
+                    || std::same_as<result_type, std::string_view>
+                    || std::is_pointer_v<result_type>,
+                "String fields are read through a reference, a std::string_view or a const char*, a string returned by value would not outlive the load");
+
+            entry.kind = rule_value_kind::string;
+            entry.load_string = [](const std::byte* storage, const T& subject)
+            {
+                decltype(auto) value = std::invoke(*std::launder(reinterpret_cast<const F*>(storage)), subject);
+
+                // Null strings read as empty ones
+                if constexpr (std::is_pointer_v<result_type>)
+                    return value != nullptr ? std::string_view(value) : std::string_view();
+                else
+                    return std::string_view(value);
+            };
+        }
+
+        fields_.push_back(std::move(entry));
+
+        return *this;
+    }
+
+    // Field made of registered fields, matched as a whole by _ or member by member by ds(...)
+    rule_fields& add_group(std::string_view name, std::initializer_list<std::string_view> members)
+    {
+        group entry;
+        entry.name = std::string(name);
+
+        for (const auto member : members)
+            entry.members.emplace_back(member);
+
+        groups_.push_back(std::move(entry));
+
+        return *this;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return fields_.size();
+    }
+
+private:
+    friend class rule_program<T>;
+
+    struct field
+    {
+        std::string name;
+        rule_value_kind kind = rule_value_kind::integer;
+        std::int64_t (*load_integer)(const std::byte*, const T&) = nullptr;
+        std::string_view (*load_string)(const std::byte*, const T&) = nullptr;
+        alignas(std::max_align_t) std::byte storage[16] = {};
+    };
+
+    struct group
+    {
+        std::string name;
+        std::vector<std::string> members;
+    };
+
+    const field* find(std::string_view name) const noexcept
+    {
+        for (const auto& entry : fields_)
+        {
+            if (entry.name == name)
+                return &entry;
+        }
+
+        return nullptr;
+    }
+
+    const group* find_group(std::string_view name) const noexcept
+    {
+        for (const auto& entry : groups_)
+        {
+            if (entry.name == name)
+                return &entry;
+        }
+
+        return nullptr;
+    }
+
+    std::vector<field> fields_;
+    std::vector<group> groups_;
+};
+
+//=================================================================================================
+
+enum class rule_opcode : std::uint8_t
+{
+    integer_equal,
+    integer_less,
+    integer_less_equal,
+    integer_range,
+    integer_in,
+    string_equal,
+    string_less,
+    string_less_equal,
+    string_range,
+    string_in,
+    jump,
+    accept,
+    reject
+};
+
+// Tests compare the field in the register with the constants from operand (count of them for in, two for range),
+// then jump to target when the result is the expected one and fall through otherwise. Accept gives the action in
+// operand.
+struct rule_instruction
+{
+    rule_opcode opcode = rule_opcode::reject;
+    bool expected = false;
+    std::uint16_t reg = 0;
+    std::uint32_t operand = 0;
+    std::uint32_t count = 0;
+    std::uint32_t target = 0;
+};
+
+struct rule_script_error
+{
+    std::size_t line = 0;
+    std::size_t column = 0;
+    std::string message;
+};
+
+//=================================================================================================
+
+namespace detail {
+
+struct rule_script_token
+{
+    enum class kind : std::uint8_t
+    {
+        end,
+        identifier,
+        integer,
+        string,
+        symbol,
+        invalid
+    };
+
+    kind type = kind::end;
+    std::string_view text;
+    std::string value; // Unescaped content of strings
+    std::int64_t integer = 0;
+    std::size_t line = 1;
+    std::size_t column = 1;
+};
+
+class rule_script_lexer
+{
+public:
+    explicit rule_script_lexer(std::string_view source) noexcept
+        : source_(source)
+    {
+    }
+
+    rule_script_token next()
+    {
+        skip_blanks();
+
+        rule_script_token token;
+        token.line = line_;
+        token.column = position_ - line_start_ + 1;
+
+        if (position_ >= source_.size())
+            return token;
+
+        const std::size_t start = position_;
+        const char c = source_[position_];
+
+        if (is_identifier_char(c) && not is_digit(c))
+        {
+            while (position_ < source_.size() && is_identifier_char(source_[position_]))
+                ++position_;
+
+            token.type = rule_script_token::kind::identifier;
+        }
+        else if (is_digit(c) || (c == '-' && position_ + 1 < source_.size() && is_digit(source_[position_ + 1])))
+        {
+            ++position_;
+
+            while (position_ < source_.size() && is_digit(source_[position_]))
+                ++position_;
+
+            const auto [end, error] = std::from_chars(source_.data() + start, source_.data() + position_, token.integer);
+            token.type = error == std::errc() ? rule_script_token::kind::integer : rule_script_token::kind::invalid;
+        }
+        else if (c == '"')
+        {
+            token.type = rule_script_token::kind::invalid;
+
+            for (++position_; position_ < source_.size() && source_[position_] != '\n'; ++position_)
+            {
+                if (source_[position_] == '"')
+                {
+                    ++position_;
+                    token.type = rule_script_token::kind::string;
+                    break;
+                }
+
+                if (source_[position_] == '\\' && position_ + 1 < source_.size())
+                    ++position_;
+
+                token.value.push_back(source_[position_]);
+            }
+        }
+        else
+        {
+            static constexpr std::array<std::string_view, 15> symbols = {
+                "&&", "||", "==", "!=", "<=", ">=", "(", ")", ",", "=", ";", "!", "<", ">", "-"
+            };
+
+            token.type = rule_script_token::kind::invalid;
+            ++position_;
+
+            for (const auto symbol : symbols)
+            {
+                if (source_.substr(start, symbol.size()) == symbol)
+                {
+                    position_ = start + symbol.size();
+                    token.type = rule_script_token::kind::symbol;
+                    break;
+                }
+            }
+        }
+
+        token.text = source_.substr(start, position_ - start);
+
+        return token;
+    }
+
+private:
+    static constexpr bool is_digit(char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static constexpr bool is_identifier_char(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || is_digit(c);
+    }
+
+    void skip_blanks() noexcept
+    {
+        while (position_ < source_.size())
+        {
+            const char c = source_[position_];
+
+            if (c == '\n')
+            {
+                ++position_;
+                ++line_;
+                line_start_ = position_;
+            }
+            else if (c == ' ' || c == '\t' || c == '\r')
+            {
+                ++position_;
+            }
+            else if (source_.substr(position_, 2) == "//")
+            {
+                while (position_ < source_.size() && source_[position_] != '\n')
+                    ++position_;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    std::string_view source_;
+    std::size_t position_ = 0;
+    std::size_t line_ = 1;
+    std::size_t line_start_ = 0;
+};
+
+} // namespace detail
+
+//=================================================================================================
+
+// Rule script compiled to a register bytecode: the fields are loaded once in registers, then every arm is a sequence
+// of tests falling through to the next one while they hold and jumping to the next arm as soon as one doesn't, with
+// && and || compiled to jumps instead of being evaluated. Dispatch is threaded where the compiler supports computed
+// gotos, each instruction jumping straight to the code of the next one.
+template <class T>
+class rule_program
+{
+public:
+    [[nodiscard]] static std::optional<rule_program> compile(const rule_fields<T>& fields, std::string_view source, rule_script_error* error = nullptr)
+    {
+        compiler state(fields, source);
+
+        if (state.compile())
+        {
+            state.program.finalize();
+            return std::move(state.program);
+        }
+
+        if (error != nullptr)
+            *error = std::move(state.error);
+
+        return std::nullopt;
+    }
+
+    // Action of the first arm matching the subject
+    std::optional<rule_action> match(const T& subject) const
+    {
+        std::array<std::int64_t, rule_script_max_fields> integers;
+        std::array<std::string_view, rule_script_max_fields> strings;
+
+        for (std::size_t reg = 0; reg < fields_.size(); ++reg)
+        {
+            const auto& entry = fields_[reg];
+
+            if (entry.kind == rule_value_kind::integer)
+                integers[reg] = entry.load_integer(entry.storage, subject);
+            else
+                strings[reg] = entry.load_string(entry.storage, subject);
+        }
+
+        const rule_instruction* const code = instructions_.data();
+        const rule_instruction* pc = code;
+
+        const std::int64_t* const integer_constants = integers_.data();
+        const std::string_view* const string_constants = views_.data();
+
+#if PATUM_HAS_FEATURE_COMPUTED_GOTO
+        static const void* const labels[] = {
+            &&integer_equal, &&integer_less, &&integer_less_equal, &&integer_range, &&integer_in,
+            &&string_equal, &&string_less, &&string_less_equal, &&string_range, &&string_in,
+            &&jump, &&accept, &&reject
+        };
+
+#define PATUM_RULE_OP(name) name:
+#define PATUM_RULE_NEXT() goto *labels[static_cast<std::size_t>(pc->opcode)]
+
+        PATUM_RULE_NEXT();
+#else
+#define PATUM_RULE_OP(name) case rule_opcode::name:
+#define PATUM_RULE_NEXT() continue
+
+        for (;;)
+        {
+            switch (pc->opcode)
+            {
+#endif
+
+#define PATUM_RULE_TEST(result) \
+    pc = (result) == pc->expected ? code + pc->target : pc + 1; \
+    PATUM_RULE_NEXT();
+
+        PATUM_RULE_OP(integer_equal)
+            PATUM_RULE_TEST(integers[pc->reg] == integer_constants[pc->operand])
+
+        PATUM_RULE_OP(integer_less)
+            PATUM_RULE_TEST(integers[pc->reg] < integer_constants[pc->operand])
+
+        PATUM_RULE_OP(integer_less_equal)
+            PATUM_RULE_TEST(integers[pc->reg] <= integer_constants[pc->operand])
+
+        PATUM_RULE_OP(integer_range)
+            PATUM_RULE_TEST(integers[pc->reg] >= integer_constants[pc->operand] && integers[pc->reg] <= integer_constants[pc->operand + 1])
+
+        PATUM_RULE_OP(integer_in)
+            PATUM_RULE_TEST(std::find(integer_constants + pc->operand, integer_constants + pc->operand + pc->count, integers[pc->reg])
+                != integer_constants + pc->operand + pc->count)
+
+        PATUM_RULE_OP(string_equal)
+            PATUM_RULE_TEST(strings[pc->reg] == string_constants[pc->operand])
+
+        PATUM_RULE_OP(string_less)
+            PATUM_RULE_TEST(strings[pc->reg] < string_constants[pc->operand])
+
+        PATUM_RULE_OP(string_less_equal)
+            PATUM_RULE_TEST(strings[pc->reg] <= string_constants[pc->operand])
+
+        PATUM_RULE_OP(string_range)
+            PATUM_RULE_TEST(strings[pc->reg] >= string_constants[pc->operand] && strings[pc->reg] <= string_constants[pc->operand + 1])
+
+        PATUM_RULE_OP(string_in)
+            PATUM_RULE_TEST(std::find(string_constants + pc->operand, string_constants + pc->operand + pc->count, strings[pc->reg])
+                != string_constants + pc->operand + pc->count)
+
+        PATUM_RULE_OP(jump)
+            pc = code + pc->target;
+            PATUM_RULE_NEXT();
+
+        PATUM_RULE_OP(accept)
+            return pc->operand;
+
+        PATUM_RULE_OP(reject)
+            return std::nullopt;
+
+#if not PATUM_HAS_FEATURE_COMPUTED_GOTO
+            }
+        }
+#endif
+
+#undef PATUM_RULE_TEST
+#undef PATUM_RULE_NEXT
+#undef PATUM_RULE_OP
+    }
+
+    const std::vector<rule_instruction>& instructions() const noexcept
+    {
+        return instructions_;
+    }
+
+    // Copies point their string constants to their own pool
+    rule_program(const rule_program& other)
+        : instructions_(other.instructions_)
+        , fields_(other.fields_)
+        , integers_(other.integers_)
+        , strings_(other.strings_)
+    {
+        finalize();
+    }
+
+    rule_program& operator=(const rule_program& other)
+    {
+        if (this != &other)
+            *this = rule_program(other);
+
+        return *this;
+    }
+
+    rule_program(rule_program&&) noexcept = default;
+    rule_program& operator=(rule_program&&) noexcept = default;
+
+private:
+    using field = typename rule_fields<T>::field;
+    using group = typename rule_fields<T>::group;
+    using token = detail::rule_script_token;
+
+    rule_program() = default;
+
+    void finalize()
+    {
+        views_.assign(strings_.begin(), strings_.end());
+    }
+
+    // Patterns are parsed to a small tree, then compiled to jumps
+    struct node
+    {
+        enum class kind : std::uint8_t
+        {
+            any,
+            test,
+            conjunction,
+            disjunction,
+            negation
+        };
+
+        kind type = kind::any;
+        rule_opcode opcode = rule_opcode::reject;
+        bool negate = false;
+        std::uint16_t reg = 0;
+        std::uint32_t operand = 0;
+        std::uint32_t count = 0;
+        std::uint32_t lhs = 0;
+        std::uint32_t rhs = 0;
+        std::uint32_t depth = 0;
+    };
+
+    struct compiler
+    {
+        compiler(const rule_fields<T>& fields, std::string_view source)
+            : fields(fields)
+            , lexer(source)
+        {
+            advance();
+        }
+
+        bool compile()
+        {
+            if (not accept_identifier("match") || not accept_symbol("("))
+                return fail("Rule scripts start with match(fields...)");
+
+            do
+            {
+                if (current.type != token::kind::identifier)
+                    return fail("Expected the name of a field");
+
+                // The members of a group are loaded in consecutive registers
+                const column matched{ static_cast<std::uint16_t>(program.fields_.size()), fields.find_group(current.text) };
+
+                if (matched.members != nullptr)
+                {
+                    for (const auto& member : matched.members->members)
+                    {
+                        if (not load_field(member))
+                            return false;
+                    }
+                }
+                else if (not load_field(current.text))
+                {
+                    return false;
+                }
+
+                columns.push_back(matched);
+                advance();
+            }
+            while (accept_symbol(","));
+
+            if (not accept_symbol(")"))
+                return fail("Expected ')' after the fields matched");
+
+            while (current.type != token::kind::end)
+            {
+                if (not compile_arm())
+                    return false;
+            }
+
+            emit({ rule_opcode::reject });
+
+            return true;
+        }
+
+        bool load_field(std::string_view name)
+        {
+            const auto* entry = fields.find(name);
+            if (entry == nullptr)
+                return fail("Unknown field '" + std::string(name) + "'");
+
+            if (program.fields_.size() == rule_script_max_fields)
+                return fail("Too many fields matched");
+
+            program.fields_.push_back(*entry);
+
+            return true;
+        }
+
+        bool compile_arm()
+        {
+            if (not accept_identifier("pattern") || not accept_symbol("("))
+                return fail("Expected pattern(...)");
+
+            std::vector<std::uint32_t> roots;
+
+            do
+            {
+                if (roots.size() == columns.size())
+                    return fail("More patterns than fields matched");
+
+                const auto root = parse_disjunction(columns[roots.size()].reg, columns[roots.size()].members);
+                if (not root)
+                    return false;
+
+                roots.push_back(*root);
+            }
+            while (accept_symbol(","));
+
+            if (not accept_symbol(")"))
+                return fail("Expected ')' after the patterns");
+
+            if (not accept_symbol("=") || current.type != token::kind::integer)
+                return fail("Expected '=' and the integer given by the arm");
+
+            if (current.integer < 0 || current.integer > std::int64_t(std::numeric_limits<rule_action>::max()))
+                return fail("Arm results are unsigned 32 bits integers");
+
+            const auto action = static_cast<rule_action>(current.integer);
+            advance();
+            accept_symbol(";");
+
+            // Every pattern jumps to the next arm when it doesn't hold, fields left out match anything
+            std::vector<std::uint32_t> next_arm;
+
+            for (const auto root : roots)
+                emit_branch(root, false, next_arm);
+
+            emit({ rule_opcode::accept, false, 0, action });
+            patch(next_arm);
+
+            return true;
+        }
+
+        //=========================================================================================
+
+        // Patterns of the field in reg, or of the group of fields from reg when members isn't null
+        std::optional<std::uint32_t> parse_disjunction(std::uint16_t reg, const group* members)
+        {
+            auto lhs = parse_conjunction(reg, members);
+
+            while (lhs && accept_symbol("||"))
+            {
+                const auto rhs = parse_conjunction(reg, members);
+                if (not rhs)
+                    return std::nullopt;
+
+                lhs = add_operator({ node::kind::disjunction, rule_opcode::reject, false, reg, 0, 0, *lhs, *rhs });
+            }
+
+            return lhs;
+        }
+
+        std::optional<std::uint32_t> parse_conjunction(std::uint16_t reg, const group* members)
+        {
+            auto lhs = parse_unary(reg, members);
+
+            while (lhs && accept_symbol("&&"))
+            {
+                const auto rhs = parse_unary(reg, members);
+                if (not rhs)
+                    return std::nullopt;
+
+                lhs = add_operator({ node::kind::conjunction, rule_opcode::reject, false, reg, 0, 0, *lhs, *rhs });
+            }
+
+            return lhs;
+        }
+
+        std::optional<std::uint32_t> parse_unary(std::uint16_t reg, const group* members)
+        {
+            if (accept_symbol("!"))
+            {
+                if (depth == rule_script_max_depth)
+                    return fail_node("Patterns nest too deeply");
+
+                ++depth;
+                const auto operand = parse_unary(reg, members);
+                --depth;
+
+                if (not operand)
+                    return std::nullopt;
+
+                return add_operator({ node::kind::negation, rule_opcode::reject, false, reg, 0, 0, *operand });
+            }
+
+            if (accept_symbol("("))
+            {
+                if (depth == rule_script_max_depth)
+                    return fail_node("Patterns nest too deeply");
+
+                ++depth;
+                const auto inner = parse_disjunction(reg, members);
+                --depth;
+
+                if (not inner)
+                    return std::nullopt;
+
+                if (not accept_symbol(")"))
+                    return fail_node("Expected ')'");
+
+                return inner;
+            }
+
+            if (accept_identifier("_"))
+                return add_node({ node::kind::any });
+
+            if (members != nullptr)
+                return parse_destructure(reg, *members);
+
+            if (current.type == token::kind::identifier && current.text == "ds")
+                return fail_node("ds(...) matches the members of a group of fields");
+
+            if (accept_identifier("_x"))
+            {
+                const auto comparison = current.text;
+                if (current.type != token::kind::symbol)
+                    return fail_node("Expected a comparison after _x");
+
+                advance();
+
+                return parse_comparison(reg, comparison, false);
+            }
+
+            if (accept_identifier("in"))
+                return parse_in(reg);
+
+            if (accept_identifier("range"))
+                return parse_range(reg);
+
+            const auto constant = parse_constant(reg);
+            if (not constant)
+                return std::nullopt;
+
+            // A literal alone compares equal, or is the left side of a comparison with _x
+            if (current.type == token::kind::symbol && current.text != "," && current.text != ")" && current.text != "&&" && current.text != "||")
+            {
+                const auto comparison = current.text;
+                advance();
+
+                if (not accept_identifier("_x"))
+                    return fail_node("Expected _x after the comparison");
+
+                return comparison_node(reg, comparison, true, *constant);
+            }
+
+            return add_node({ node::kind::test, opcode(reg, rule_opcode::integer_equal), false, reg, *constant, 1 });
+        }
+
+        // Every member pattern has to hold, members left out at the end match anything
+        std::optional<std::uint32_t> parse_destructure(std::uint16_t reg, const group& members)
+        {
+            if (not accept_identifier("ds") || not accept_symbol("("))
+                return fail_node("Expected ds(...) or _ for the group '" + members.name + "'");
+
+            std::optional<std::uint32_t> result;
+            std::size_t count = 0;
+
+            do
+            {
+                if (count == members.members.size())
+                    return fail_node("More patterns than members in the group '" + members.name + "'");
+
+                const auto member = parse_disjunction(static_cast<std::uint16_t>(reg + count), nullptr);
+                if (not member)
+                    return std::nullopt;
+
+                result = result ? add_operator({ node::kind::conjunction, rule_opcode::reject, false, reg, 0, 0, *result, *member }) : member;
+                if (not result)
+                    return std::nullopt;
+
+                ++count;
+            }
+            while (accept_symbol(","));
+
+            if (not accept_symbol(")"))
+                return fail_node("Expected ')' after the patterns of ds");
+
+            return result;
+        }
+
+        std::optional<std::uint32_t> parse_comparison(std::uint16_t reg, std::string_view comparison, bool reversed)
+        {
+            const auto constant = parse_constant(reg);
+            if (not constant)
+                return std::nullopt;
+
+            return comparison_node(reg, comparison, reversed, *constant);
+        }
+
+        // _x compared to a constant, or a constant compared to _x when reversed. Greater and not equal tests are the
+        // negations of less equal, less and equal.
+        std::optional<std::uint32_t> comparison_node(std::uint16_t reg, std::string_view comparison, bool reversed, std::uint32_t constant)
+        {
+            if (reversed)
+            {
+                if (comparison == "<")
+                    comparison = ">";
+                else if (comparison == "<=")
+                    comparison = ">=";
+                else if (comparison == ">")
+                    comparison = "<";
+                else if (comparison == ">=")
+                    comparison = "<=";
+            }
+
+            rule_opcode base = rule_opcode::integer_equal;
+            bool negate = false;
+
+            if (comparison == "==")
+                base = rule_opcode::integer_equal;
+            else if (comparison == "!=")
+                base = rule_opcode::integer_equal, negate = true;
+            else if (comparison == "<")
+                base = rule_opcode::integer_less;
+            else if (comparison == "<=")
+                base = rule_opcode::integer_less_equal;
+            else if (comparison == ">")
+                base = rule_opcode::integer_less_equal, negate = true;
+            else if (comparison == ">=")
+                base = rule_opcode::integer_less, negate = true;
+            else
+                return fail_node("Unknown comparison '" + std::string(comparison) + "'");
+
+            return add_node({ node::kind::test, opcode(reg, base), negate, reg, constant, 1 });
+        }
+
+        std::optional<std::uint32_t> parse_in(std::uint16_t reg)
+        {
+            if (not accept_symbol("("))
+                return fail_node("Expected '(' after in");
+
+            std::optional<std::uint32_t> first;
+            std::uint32_t count = 0;
+
+            do
+            {
+                const auto constant = parse_constant(reg);
+                if (not constant)
+                    return std::nullopt;
+
+                first = first ? first : constant;
+                ++count;
+            }
+            while (accept_symbol(","));
+
+            if (not accept_symbol(")"))
+                return fail_node("Expected ')' after the values of in");
+
+            return add_node({ node::kind::test, opcode(reg, rule_opcode::integer_in), false, reg, *first, count });
+        }
+
+        std::optional<std::uint32_t> parse_range(std::uint16_t reg)
+        {
+            if (not accept_symbol("("))
+                return fail_node("Expected '(' after range");
+
+            const auto first = parse_constant(reg);
+            if (not first || not accept_symbol(","))
+                return fail_node("Expected range(first, last)");
+
+            const auto last = parse_constant(reg);
+            if (not last || not accept_symbol(")"))
+                return fail_node("Expected range(first, last)");
+
+            const bool ordered = program.fields_[reg].kind == rule_value_kind::integer
+                ? program.integers_[*first] <= program.integers_[*last]
+                : program.strings_[*first] <= program.strings_[*last];
+
+            if (not ordered)
+                return fail_node("Range bounds are reversed");
+
+            return add_node({ node::kind::test, opcode(reg, rule_opcode::integer_range), false, reg, *first, 2 });
+        }
+
+        // Literal of the type of the field, appended to the constants
+        std::optional<std::uint32_t> parse_constant(std::uint16_t reg)
+        {
+            if (program.fields_[reg].kind == rule_value_kind::integer)
+            {
+                if (current.type != token::kind::integer)
+                    return fail_node("Expected an integer literal for field '" + program.fields_[reg].name + "'");
+
+                program.integers_.push_back(current.integer);
+                advance();
+
+                return static_cast<std::uint32_t>(program.integers_.size() - 1);
+            }
+
+            if (current.type != token::kind::string)
+                return fail_node("Expected a string literal for field '" + program.fields_[reg].name + "'");
+
+            program.strings_.push_back(std::move(current.value));
+            advance();
+
+            return static_cast<std::uint32_t>(program.strings_.size() - 1);
+        }
+
+        // Opcodes are listed as integer tests followed by the string tests in the same order
+        rule_opcode opcode(std::uint16_t reg, rule_opcode integer_opcode) const noexcept
+        {
+            if (program.fields_[reg].kind == rule_value_kind::integer)
+                return integer_opcode;
+
+            return static_cast<rule_opcode>(static_cast<std::uint8_t>(integer_opcode) + static_cast<std::uint8_t>(rule_opcode::string_equal));
+        }
+
+        //=========================================================================================
+
+        // Jumps to one of the exits when the pattern evaluates to jump_when, falls through otherwise
+        void emit_branch(std::uint32_t index, bool jump_when, std::vector<std::uint32_t>& exits)
+        {
+            const node current_node = nodes[index];
+
+            switch (current_node.type)
+            {
+            case node::kind::any:
+                if (jump_when)
+                    exits.push_back(emit({ rule_opcode::jump }));
+                break;
+
+            case node::kind::test:
+                exits.push_back(emit({ current_node.opcode, jump_when != current_node.negate, current_node.reg, current_node.operand, current_node.count }));
+                break;
+
+            case node::kind::negation:
+                emit_branch(current_node.lhs, not jump_when, exits);
+                break;
+
+            case node::kind::conjunction:
+            case node::kind::disjunction:
+            {
+                // Jumping when a conjunction is false (or a disjunction true) is jumping as soon as either side is
+                const bool short_circuit = current_node.type == node::kind::disjunction;
+
+                if (jump_when == short_circuit)
+                {
+                    emit_branch(current_node.lhs, jump_when, exits);
+                    emit_branch(current_node.rhs, jump_when, exits);
+                }
+                else
+                {
+                    std::vector<std::uint32_t> skip;
+                    emit_branch(current_node.lhs, short_circuit, skip);
+                    emit_branch(current_node.rhs, jump_when, exits);
+                    patch(skip);
+                }
+                break;
+            }
+            }
+        }
+
+        std::uint32_t emit(rule_instruction instruction)
+        {
+            program.instructions_.push_back(instruction);
+            return static_cast<std::uint32_t>(program.instructions_.size() - 1);
+        }
+
+        void patch(const std::vector<std::uint32_t>& jumps)
+        {
+            for (const auto jump : jumps)
+                program.instructions_[jump].target = static_cast<std::uint32_t>(program.instructions_.size());
+        }
+
+        std::uint32_t add_node(node value)
+        {
+            nodes.push_back(value);
+            return static_cast<std::uint32_t>(nodes.size() - 1);
+        }
+
+        // Conjunctions, disjunctions and negations, one level deeper than their operands
+        std::optional<std::uint32_t> add_operator(node value)
+        {
+            value.depth = nodes[value.lhs].depth + 1;
+
+            if (value.type != node::kind::negation)
+                value.depth = std::max(value.depth, nodes[value.rhs].depth + 1);
+
+            if (value.depth > rule_script_max_depth)
+                return fail_node("Patterns nest too deeply");
+
+            return add_node(value);
+        }
+
+        //=========================================================================================
+
+        void advance()
+        {
+            current = lexer.next();
+
+            if (current.type == token::kind::invalid && error.message.empty())
+                fail("Invalid token '" + std::string(current.text) + "'");
+        }
+
+        bool accept_symbol(std::string_view symbol)
+        {
+            if (current.type != token::kind::symbol || current.text != symbol)
+                return false;
+
+            advance();
+            return true;
+        }
+
+        bool accept_identifier(std::string_view identifier)
+        {
+            if (current.type != token::kind::identifier || current.text != identifier)
+                return false;
+
+            advance();
+            return true;
+        }
+
+        // Keeps the first error, later ones usually follow from it
+        bool fail(std::string message)
+        {
+            if (error.message.empty())
+                error = { current.line, current.column, std::move(message) };
+
+            return false;
+        }
+
+        std::optional<std::uint32_t> fail_node(std::string message)
+        {
+            fail(std::move(message));
+            return std::nullopt;
+        }
+
+        // Field matched by a pattern, a group taking the registers of its members from reg
+        struct column
+        {
+            std::uint16_t reg = 0;
+            const group* members = nullptr;
+        };
+
+        const rule_fields<T>& fields;
+        std::vector<column> columns;
+        detail::rule_script_lexer lexer;
+        token current;
+        rule_script_error error;
+        std::vector<node> nodes;
+        std::size_t depth = 0;
+        rule_program program;
+    };
+
+    std::vector<rule_instruction> instructions_;
+    std::vector<field> fields_;
+    std::vector<std::int64_t> integers_;
+    std::vector<std::string> strings_;
+    std::vector<std::string_view> views_;
+};
+
+template <class T>
+[[nodiscard]] std::optional<rule_program<T>> compile_rules(const rule_fields<T>& fields, std::string_view source, rule_script_error* error = nullptr)
+{
+    return rule_program<T>::compile(fields, source, error);
+}
+
+} // namespace ptm
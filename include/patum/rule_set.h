@@ -0,0 +1,461 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "concepts.h"
+#include "expect.h"
+#include "type_traits.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+// Rule sets are the runtime counterpart of match: rows of column conditions built from data known at startup (routing
+// tables, configuration), frozen once, then matched many times. Columns take a value (compared for equality), the
+// wildcard _, a rule_range or a rule_in set. Matching returns the action of the matching rule of highest priority,
+// ties resolved in insertion order.
+
+using rule_action = std::uint32_t;
+
+template <class T>
+struct rule_range_condition
+{
+    T first;
+    T last;
+};
+
+template <class T>
+struct rule_in_condition
+{
+    std::vector<T> values;
+};
+
+// Values between first and last, both included
+template <class T>
+[[nodiscard]] rule_range_condition<T> rule_range(T first, T last)
+{
+    expect(not (last < first));
+
+    return { std::move(first), std::move(last) };
+}
+
+template <class T>
+[[nodiscard]] rule_in_condition<T> rule_in(std::initializer_list<T> values)
+{
+    return { std::vector<T>(values) };
+}
+
+template <std::ranges::input_range R>
+[[nodiscard]] rule_in_condition<std::ranges::range_value_t<R>> rule_in(const R& values)
+{
+    return { std::vector<std::ranges::range_value_t<R>>(std::ranges::begin(values), std::ranges::end(values)) };
+}
+
+//=================================================================================================
+
+enum class rule_condition_kind : std::uint8_t
+{
+    any,
+    equal,
+    range,
+    set
+};
+
+// Hashes the values of a column and anything comparable to them that they convert from, so string columns are looked up
+// with views without building strings
+template <class T>
+struct rule_key_hash
+{
+    using is_transparent = void;
+
+    template <class U>
+    std::size_t operator()(const U& value) const noexcept
+    {
+        if constexpr (StringLike<T>)
+            return std::hash<std::string_view>{}(std::string_view(value));
+        else
+            return std::hash<T>{}(static_cast<T>(value));
+    }
+};
+
+// Conditions of every rule on one column. Their values live in a shared pool (one for equal, two for range, the
+// distinct values for set). Columns with equality or set conditions are indexed by value: the rules listed under a
+// value are the ones that could match it, the unindexed rules are the ones with other conditions.
+template <class T>
+struct rule_column
+{
+    struct condition
+    {
+        rule_condition_kind kind = rule_condition_kind::any;
+        std::uint32_t offset = 0;
+        std::uint32_t count = 0;
+    };
+
+    struct bucket
+    {
+        std::uint32_t offset = 0;
+        std::uint32_t count = 0;
+    };
+
+    std::vector<condition> conditions;
+    std::vector<T> values;
+
+    std::unordered_map<T, bucket, rule_key_hash<T>, std::equal_to<>> index;
+    std::vector<std::uint32_t> postings;
+    std::vector<std::uint32_t> unindexed;
+
+    template <class U>
+    void add(U&& value)
+    {
+        const auto offset = static_cast<std::uint32_t>(values.size());
+
+        if constexpr (is_wildcard_v<U>)
+        {
+            conditions.push_back({ rule_condition_kind::any, offset, 0 });
+        }
+        else if constexpr (is_specialization_of_v<std::remove_cvref_t<U>, rule_range_condition>)
+        {
+            values.emplace_back(std::forward<U>(value).first);
+            values.emplace_back(std::forward<U>(value).last);
+            conditions.push_back({ rule_condition_kind::range, offset, 2 });
+        }
+        else if constexpr (is_specialization_of_v<std::remove_cvref_t<U>, rule_in_condition>)
+        {
+            for (const auto& element : value.values)
+            {
+                T converted(element);
+
+                if (std::find(values.begin() + offset, values.end(), converted) == values.end())
+                    values.push_back(std::move(converted));
+            }
+
+            conditions.push_back({ rule_condition_kind::set, offset, static_cast<std::uint32_t>(values.size() - offset) });
+        }
+        else
+        {
+            static_assert(std::constructible_from<T, U>, "Rule conditions are values of the column, _, rule_range or rule_in");
+
+            values.emplace_back(std::forward<U>(value));
+            conditions.push_back({ rule_condition_kind::equal, offset, 1 });
+        }
+    }
+
+    // Copies the conditions of the rules in the given order and indexes them
+    rule_column frozen(const std::vector<std::uint32_t>& order) const
+    {
+        rule_column result;
+        result.conditions.reserve(order.size());
+        result.values.reserve(values.size());
+
+        for (const auto rule : order)
+        {
+            auto copy = conditions[rule];
+            copy.offset = static_cast<std::uint32_t>(result.values.size());
+
+            result.values.insert(result.values.end(), values.begin() + conditions[rule].offset,
+                values.begin() + conditions[rule].offset + conditions[rule].count);
+
+            result.conditions.push_back(copy);
+        }
+
+        result.build_index();
+
+        return result;
+    }
+
+    bool is_indexed() const noexcept
+    {
+        return not index.empty();
+    }
+
+    void build_index()
+    {
+        const auto is_keyed = [](const condition& c)
+        {
+            return c.kind == rule_condition_kind::equal || c.kind == rule_condition_kind::set;
+        };
+
+        if (std::none_of(conditions.begin(), conditions.end(), is_keyed))
+            return;
+
+        // Counted first so the rules of a value are stored contiguously, in priority order
+        for (const auto& c : conditions)
+        {
+            if (is_keyed(c))
+            {
+                for (std::uint32_t element = 0; element < c.count; ++element)
+                    ++index[values[c.offset + element]].count;
+            }
+        }
+
+        std::uint32_t offset = 0;
+        for (auto& [key, entry] : index)
+        {
+            entry.offset = offset;
+            offset += std::exchange(entry.count, 0);
+        }
+
+        postings.resize(offset);
+
+        for (std::uint32_t rule = 0; rule < conditions.size(); ++rule)
+        {
+            const auto& c = conditions[rule];
+
+            if (not is_keyed(c))
+            {
+                unindexed.push_back(rule);
+                continue;
+            }
+
+            for (std::uint32_t element = 0; element < c.count; ++element)
+            {
+                auto& entry = index.find(values[c.offset + element])->second;
+                postings[entry.offset + entry.count++] = rule;
+            }
+        }
+    }
+
+    // Rules under the value, empty when no rule compares equal to it
+    template <class U>
+    std::span<const std::uint32_t> candidates(const U& value) const
+    {
+        if (const auto it = index.find(value); it != index.end())
+            return { postings.data() + it->second.offset, it->second.count };
+
+        return {};
+    }
+
+    template <class U>
+    bool check(std::uint32_t rule, const U& value) const
+    {
+        const auto& c = conditions[rule];
+        const T* first = values.data() + c.offset;
+
+        switch (c.kind)
+        {
+        case rule_condition_kind::any:
+            return true;
+
+        case rule_condition_kind::equal:
+            return first[0] == value;
+
+        case rule_condition_kind::range:
+            return not (value < first[0]) && not (first[1] < value);
+
+        case rule_condition_kind::set:
+            return std::find(first, first + c.count, value) != first + c.count;
+        }
+
+        return false;
+    }
+};
+
+//=================================================================================================
+
+// Index of the matching rule of highest priority, rule_count when none matches. Each match looks its values up in the
+// indexed columns and walks the rules of the column leaving the fewest candidates (the ones under the value plus the
+// unindexed ones), in priority order, stopping at the first rule whose every condition holds. Without indexed columns
+// every rule is a candidate. Columns are any type answering is_indexed, candidates, unindexed and check like rule_column.
+template <class... C, class... U>
+    requires(sizeof...(U) == sizeof...(C))
+std::uint32_t find_rule(const std::tuple<C...>& columns, std::size_t rule_count, const U&... values)
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        std::span<const std::uint32_t> keyed;
+        std::span<const std::uint32_t> unkeyed;
+        std::size_t fewest = std::numeric_limits<std::size_t>::max();
+
+        const auto select = [&](const auto& column, const auto& value)
+        {
+            if (not column.is_indexed())
+                return;
+
+            const auto candidates = column.candidates(value);
+            const auto count = candidates.size() + column.unindexed.size();
+
+            if (count < fewest)
+            {
+                fewest = count;
+                keyed = candidates;
+                unkeyed = column.unindexed;
+            }
+        };
+
+        (select(std::get<I>(columns), values), ...);
+
+        const auto matches = [&](std::uint32_t rule)
+        {
+            return (std::get<I>(columns).check(rule, values) && ...);
+        };
+
+        if (fewest == std::numeric_limits<std::size_t>::max())
+        {
+            for (std::uint32_t rule = 0; rule < rule_count; ++rule)
+            {
+                if (matches(rule))
+                    return rule;
+            }
+
+            return static_cast<std::uint32_t>(rule_count);
+        }
+
+        // Both lists are sorted by priority, merged on the fly
+        auto k = keyed.begin();
+        auto u = unkeyed.begin();
+
+        while (k != keyed.end() || u != unkeyed.end())
+        {
+            const bool from_keyed = u == unkeyed.end() || (k != keyed.end() && *k < *u);
+            const auto rule = from_keyed ? *k++ : *u++;
+
+            if (matches(rule))
+                return rule;
+        }
+
+        return static_cast<std::uint32_t>(rule_count);
+    }(std::index_sequence_for<C...>{});
+}
+
+//=================================================================================================
+
+template <class... Columns>
+class rule_set;
+
+template <class... Columns>
+struct rule_image_writer;
+
+template <class... Columns>
+class rule_set_builder
+{
+public:
+    static_assert(sizeof...(Columns) != 0, "Rule sets need at least one column");
+
+    // Adds a rule made of one condition per column
+    template <class... Conditions>
+        requires(sizeof...(Conditions) == sizeof...(Columns))
+    rule_set_builder& add(int priority, rule_action action, Conditions&&... conditions)
+    {
+        expect(rules_.size() < std::numeric_limits<std::uint32_t>::max());
+
+        add_conditions(std::index_sequence_for<Columns...>{}, std::forward<Conditions>(conditions)...);
+        rules_.push_back({ priority, action });
+
+        return *this;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return rules_.size();
+    }
+
+    // Sorts the rules by priority and indexes them, the builder is left untouched
+    [[nodiscard]] rule_set<Columns...> freeze() const
+    {
+        return rule_set<Columns...>(*this);
+    }
+
+private:
+    friend class rule_set<Columns...>;
+
+    struct rule_entry
+    {
+        int priority;
+        rule_action action;
+    };
+
+    template <std::size_t... I, class... Conditions>
+    void add_conditions(std::index_sequence<I...>, Conditions&&... conditions)
+    {
+        (std::get<I>(columns_).add(std::forward<Conditions>(conditions)), ...);
+    }
+
+    std::vector<rule_entry> rules_;
+    std::tuple<rule_column<Columns>...> columns_;
+};
+
+//=================================================================================================
+
+// Frozen rule set, matched through find_rule
+template <class... Columns>
+class rule_set
+{
+public:
+    explicit rule_set(const rule_set_builder<Columns...>& builder)
+    {
+        std::vector<std::uint32_t> order(builder.rules_.size());
+        std::iota(order.begin(), order.end(), std::uint32_t(0));
+
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs)
+        {
+            return builder.rules_[lhs].priority > builder.rules_[rhs].priority;
+        });
+
+        actions_.reserve(order.size());
+        for (const auto rule : order)
+            actions_.push_back(builder.rules_[rule].action);
+
+        columns_ = std::apply([&](const auto&... columns)
+        {
+            return std::tuple<rule_column<Columns>...>(columns.frozen(order)...);
+        }, builder.columns_);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return actions_.size();
+    }
+
+    bool is_indexed(std::size_t column) const noexcept
+    {
+        return std::apply([&](const auto&... columns)
+        {
+            std::size_t index = 0;
+            return ((index++ == column && columns.is_indexed()) || ...);
+        }, columns_);
+    }
+
+    // Action of the matching rule of highest priority
+    template <class... U>
+        requires(sizeof...(U) == sizeof...(Columns))
+    std::optional<rule_action> match(const U&... values) const
+    {
+        const auto rule = find_rule(columns_, actions_.size(), values...);
+
+        return rule < actions_.size() ? std::optional<rule_action>(actions_[rule]) : std::nullopt;
+    }
+
+private:
+    template <class... C>
+    friend struct rule_image_writer;
+
+    std::vector<rule_action> actions_;
+    std::tuple<rule_column<Columns>...> columns_;
+};
+
+} // namespace ptm
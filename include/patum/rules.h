@@ -0,0 +1,15 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+// Rule engine, included on its own: rule images bring in files and memory mappings, which matching doesn't need
+#include "rule_set.h"
+#include "rule_image.h"
+#include "rule_handle.h"
+#include "rule_script.h"
@@ -0,0 +1,325 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "features.h"
+
+#if PATUM_HAS_FEATURE_AVX2
+#include <immintrin.h>
+#elif PATUM_HAS_FEATURE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace ptm {
+
+//=================================================================================================
+
+#if PATUM_HAS_FEATURE_SSE2
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline __m128i simd_broadcast128(std::uint64_t value) noexcept
+{
+    if constexpr (Bytes == 1)
+        return _mm_set1_epi8(static_cast<char>(value));
+    else if constexpr (Bytes == 2)
+        return _mm_set1_epi16(static_cast<short>(value));
+    else if constexpr (Bytes == 4)
+        return _mm_set1_epi32(static_cast<int>(value));
+    else
+        return _mm_set1_epi64x(static_cast<long long>(value));
+}
+
+// Ors together all the lanes of a register, returning the result in the lowest lane
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline std::uint64_t simd_reduce_or128(__m128i value) noexcept
+{
+    value = _mm_or_si128(value, _mm_srli_si128(value, 8));
+
+    if constexpr (Bytes < 8)
+        value = _mm_or_si128(value, _mm_srli_si128(value, 4));
+
+    if constexpr (Bytes < 4)
+        value = _mm_or_si128(value, _mm_srli_si128(value, 2));
+
+    if constexpr (Bytes < 2)
+        value = _mm_or_si128(value, _mm_srli_si128(value, 1));
+
+    std::uint64_t result;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&result), value);
+    return result;
+}
+
+// Signed comparison of the lanes, all bits set where lhs is greater
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline __m128i simd_greater128(__m128i lhs, __m128i rhs) noexcept
+{
+    if constexpr (Bytes == 1)
+        return _mm_cmpgt_epi8(lhs, rhs);
+    else if constexpr (Bytes == 2)
+        return _mm_cmpgt_epi16(lhs, rhs);
+    else
+        return _mm_cmpgt_epi32(lhs, rhs);
+}
+
+// One bit per lane of a comparison result, the first lane in the lowest bit
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline std::uint32_t simd_movemask128(__m128i mask) noexcept
+{
+    if constexpr (Bytes == 1)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(mask));
+    else if constexpr (Bytes == 2)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(mask, _mm_setzero_si128())));
+    else
+        return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+}
+#endif
+
+#if PATUM_HAS_FEATURE_AVX2
+inline static constexpr std::size_t simd_register_bytes = 32;
+
+using simd_register = __m256i;
+
+PATUM_ALWAYS_INLINE inline simd_register simd_load(const void* address) noexcept
+{
+    return _mm256_load_si256(static_cast<const simd_register*>(address));
+}
+
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline simd_register simd_broadcast(std::uint64_t value) noexcept
+{
+    return _mm256_broadcastsi128_si256(simd_broadcast128<Bytes>(value));
+}
+
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline simd_register simd_equal(simd_register lhs, simd_register rhs) noexcept
+{
+    if constexpr (Bytes == 1)
+        return _mm256_cmpeq_epi8(lhs, rhs);
+    else if constexpr (Bytes == 2)
+        return _mm256_cmpeq_epi16(lhs, rhs);
+    else if constexpr (Bytes == 4)
+        return _mm256_cmpeq_epi32(lhs, rhs);
+    else
+        return _mm256_cmpeq_epi64(lhs, rhs);
+}
+
+PATUM_ALWAYS_INLINE inline simd_register simd_zero() noexcept
+{
+    return _mm256_setzero_si256();
+}
+
+PATUM_ALWAYS_INLINE inline simd_register simd_or_masked(simd_register accumulator, simd_register mask, simd_register value) noexcept
+{
+    return _mm256_or_si256(accumulator, _mm256_and_si256(mask, value));
+}
+
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline std::uint64_t simd_reduce_or(simd_register value) noexcept
+{
+    return simd_reduce_or128<Bytes>(_mm_or_si128(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1)));
+}
+
+#elif PATUM_HAS_FEATURE_SSE2
+inline static constexpr std::size_t simd_register_bytes = 16;
+
+using simd_register = __m128i;
+
+PATUM_ALWAYS_INLINE inline simd_register simd_load(const void* address) noexcept
+{
+    return _mm_load_si128(static_cast<const simd_register*>(address));
+}
+
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline simd_register simd_broadcast(std::uint64_t value) noexcept
+{
+    return simd_broadcast128<Bytes>(value);
+}
+
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline simd_register simd_equal(simd_register lhs, simd_register rhs) noexcept
+{
+    if constexpr (Bytes == 1)
+        return _mm_cmpeq_epi8(lhs, rhs);
+    else if constexpr (Bytes == 2)
+        return _mm_cmpeq_epi16(lhs, rhs);
+    else if constexpr (Bytes == 4)
+        return _mm_cmpeq_epi32(lhs, rhs);
+    else
+    {
+        // SSE2 has no 64 bit lanes comparison: both 32 bit halves of a lane have to be equal
+        const auto halves = _mm_cmpeq_epi32(lhs, rhs);
+        return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+}
+
+PATUM_ALWAYS_INLINE inline simd_register simd_zero() noexcept
+{
+    return _mm_setzero_si128();
+}
+
+PATUM_ALWAYS_INLINE inline simd_register simd_or_masked(simd_register accumulator, simd_register mask, simd_register value) noexcept
+{
+    return _mm_or_si128(accumulator, _mm_and_si128(mask, value));
+}
+
+template <std::size_t Bytes>
+PATUM_ALWAYS_INLINE inline std::uint64_t simd_reduce_or(simd_register value) noexcept
+{
+    return simd_reduce_or128<Bytes>(value);
+}
+
+#else
+inline static constexpr std::size_t simd_register_bytes = sizeof(std::uint64_t);
+#endif
+
+//=================================================================================================
+
+// Set of unique integral keys packed into aligned vector registers, next to the one based position of each key.
+// A lookup compares every register against a broadcast of the subject and ors together the positions of the
+// equal lanes, so it doesn't branch on where (or whether) the subject is found.
+template <std::integral K, std::size_t Count>
+struct simd_key_set
+{
+    using lane_type = std::make_unsigned_t<K>;
+
+    inline static constexpr std::size_t lanes = simd_register_bytes / sizeof(K);
+    inline static constexpr std::size_t block_count = (Count + lanes - 1) / lanes;
+
+    static_assert(Count < std::size_t(std::numeric_limits<lane_type>::max()), "Too many keys for the lane width");
+
+    static constexpr simd_key_set make(const K* keys) noexcept
+    {
+        simd_key_set result{};
+
+        for (std::size_t index = 0; index < Count; ++index)
+        {
+            result.keys[index] = static_cast<lane_type>(keys[index]);
+            result.positions[index] = static_cast<lane_type>(index + 1);
+        }
+
+        return result;
+    }
+
+    // Returns one plus the index of the key equal to value, or zero when there is none
+    PATUM_ALWAYS_INLINE constexpr std::size_t find(K value) const noexcept
+    {
+#if PATUM_HAS_FEATURE_SSE2
+        if (not std::is_constant_evaluated())
+        {
+            const auto needle = simd_broadcast<sizeof(K)>(static_cast<lane_type>(value));
+            auto found = simd_zero();
+
+            for (std::size_t block = 0; block < block_count; ++block)
+            {
+                const auto equal = simd_equal<sizeof(K)>(simd_load(keys.data() + block * lanes), needle);
+                found = simd_or_masked(found, equal, simd_load(positions.data() + block * lanes));
+            }
+
+            return static_cast<lane_type>(simd_reduce_or<sizeof(K)>(found));
+        }
+#endif
+
+        lane_type found = 0;
+
+        for (std::size_t index = 0; index < Count; ++index)
+            found |= keys[index] == static_cast<lane_type>(value) ? positions[index] : lane_type(0);
+
+        return found;
+    }
+
+    // Padding lanes have no position, so they never contribute to a lookup
+    alignas(simd_register_bytes) std::array<lane_type, block_count * lanes> keys;
+    alignas(simd_register_bytes) std::array<lane_type, block_count * lanes> positions;
+};
+
+//=================================================================================================
+
+// Inclusive intervals of integral keys, tested all at once against a subject: the keys are biased to signed lanes,
+// compared to a broadcast of the subject and the lanes outside their interval collected in one bit per interval.
+// The intervals are padded to whole words with empty ones. Keys wider than 32 bits are compared one by one.
+template <std::integral K, std::size_t Count>
+struct simd_interval_set
+{
+    using lane_type = std::make_signed_t<K>;
+    using unsigned_lane_type = std::make_unsigned_t<K>;
+
+    inline static constexpr std::size_t word_count = (Count + 63) / 64;
+    inline static constexpr std::size_t lanes = 16 / sizeof(K);
+
+    static constexpr lane_type bias(K value) noexcept
+    {
+        if constexpr (std::is_signed_v<K>)
+            return value;
+        else
+            return static_cast<lane_type>(static_cast<unsigned_lane_type>(value ^ (unsigned_lane_type(1) << (sizeof(K) * 8 - 1))));
+    }
+
+    static constexpr simd_interval_set make(const K* firsts, const K* lasts) noexcept
+    {
+        simd_interval_set result{};
+
+        for (std::size_t index = 0; index < word_count * 64; ++index)
+        {
+            result.firsts[index] = index < Count ? bias(firsts[index]) : std::numeric_limits<lane_type>::max();
+            result.lasts[index] = index < Count ? bias(lasts[index]) : std::numeric_limits<lane_type>::min();
+        }
+
+        return result;
+    }
+
+    PATUM_ALWAYS_INLINE constexpr std::array<std::uint64_t, word_count> contains(K value) const noexcept
+    {
+        std::array<std::uint64_t, word_count> words{};
+        const lane_type key = bias(value);
+
+#if PATUM_HAS_FEATURE_SSE2
+        if constexpr (sizeof(K) <= 4)
+        {
+            if (not std::is_constant_evaluated())
+            {
+                const auto needle = simd_broadcast128<sizeof(K)>(static_cast<unsigned_lane_type>(key));
+
+                for (std::size_t word = 0; word < word_count; ++word)
+                {
+                    std::uint64_t outside = 0;
+
+                    for (std::size_t block = 0; block < 64 / lanes; ++block)
+                    {
+                        const auto offset = word * 64 + block * lanes;
+                        const auto below = simd_greater128<sizeof(K)>(_mm_load_si128(reinterpret_cast<const __m128i*>(firsts.data() + offset)), needle);
+                        const auto above = simd_greater128<sizeof(K)>(needle, _mm_load_si128(reinterpret_cast<const __m128i*>(lasts.data() + offset)));
+
+                        outside |= std::uint64_t(simd_movemask128<sizeof(K)>(_mm_or_si128(below, above))) << (block * lanes);
+                    }
+
+                    words[word] = ~outside;
+                }
+
+                return words;
+            }
+        }
+#endif
+
+        for (std::size_t index = 0; index < word_count * 64; ++index)
+            words[index / 64] |= std::uint64_t(firsts[index] <= key && key <= lasts[index]) << (index % 64);
+
+        return words;
+    }
+
+    alignas(16) std::array<lane_type, word_count * 64> firsts;
+    alignas(16) std::array<lane_type, word_count * 64> lasts;
+};
+
+} // namespace ptm
@@ -0,0 +1,714 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "adaptive.h"
+#include "decision_tree.h"
+#include "dispatch.h"
+#include "domain_table.h"
+#include "interval_table.h"
+#include "string_table.h"
+#include "variant_table.h"
+#include "jump_table.h"
+#include "matcher.h"
+#include "predicate.h"
+#include "profile.h"
+#include "type_traits.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+template <class M>
+struct single_pattern
+{
+    using type = void;
+};
+
+template <class M>
+    requires(matcher_traits<std::remove_cvref_t<M>>::capture_count == 1)
+struct single_pattern<M>
+{
+    using type = std::remove_cvref_t<std::tuple_element_t<0, matcher_pattern_types_t<M>>>;
+};
+
+template <class M>
+using single_pattern_t = typename single_pattern<M>::type;
+
+//=================================================================================================
+
+template <class U>
+concept destructurable_tuple = not std::is_aggregate_v<U> && requires { std::tuple_size<U>::value; };
+
+template <class U, class Sequence = std::make_index_sequence<std::tuple_size_v<U>>>
+struct destructure_subjects;
+
+template <class U, std::size_t... I>
+struct destructure_subjects<U, std::index_sequence<I...>>
+{
+    using type = std::tuple<std::remove_cvref_t<std::tuple_element_t<I, U>>...>;
+};
+
+template <std::size_t Count, class Sequence = std::make_index_sequence<Count>>
+struct wildcard_row;
+
+template <std::size_t Count, std::size_t... I>
+struct wildcard_row<Count, std::index_sequence<I...>>
+{
+    template <std::size_t>
+    using wildcard_type = std::remove_cvref_t<decltype(_)>;
+
+    template <class... Args>
+    using prepend = std::tuple<Args..., wildcard_type<I>...>;
+};
+
+template <class P, std::size_t Size>
+struct destructure_row
+{
+    using type = void;
+};
+
+template <class P, std::size_t Size>
+    requires is_wildcard_v<P>
+struct destructure_row<P, Size>
+{
+    using type = typename wildcard_row<Size>::template prepend<>;
+};
+
+template <class... Args, std::size_t Size>
+    requires(sizeof...(Args) <= Size)
+struct destructure_row<predicate<destructure<Args...>>, Size>
+{
+    using type = typename wildcard_row<Size - sizeof...(Args)>::template prepend<std::remove_cvref_t<Args>...>;
+};
+
+//=================================================================================================
+
+struct default_policy
+{
+};
+
+// Evaluates the patterns of every arm unconditionally and picks the first match from a bitmask, trading the extra
+// evaluations for the absence of data dependent branches. Only speculatable patterns are accepted.
+struct branchless_policy
+{
+};
+
+inline static constexpr branchless_policy branchless{};
+
+// Counts the hits of every arm and tries the arms hit most often first. Only arms proven mutually exclusive are
+// accepted (see ptm::disjoint_arms), so the first arm found matching is the same as in source order. Sites are told
+// apart by the types of their subjects and arms: sites matching the same subjects with the same patterns and results
+// share their counters, unless named with adaptive_at<"name">.
+struct adaptive_policy
+{
+};
+
+inline static constexpr adaptive_policy adaptive{};
+
+// Adaptive policy of a named site, counting its hits apart from every other site
+template <fixed_string Site>
+struct adaptive_site_policy
+{
+};
+
+template <fixed_string Site>
+inline static constexpr adaptive_site_policy<Site> adaptive_at{};
+
+// Orders the arms of a named site from the hits recorded by an instrumented build (see PATUM_PROFILE_RECORD). Arms
+// are only reordered when proven mutually exclusive, and sites without an up to date profile are matched as usual.
+template <fixed_string Site>
+struct profiled_policy
+{
+};
+
+template <fixed_string Site>
+inline static constexpr profiled_policy<Site> profiled{};
+
+// Selects the arms as the default policy does, but calls their handlers through functions of their own, so only the
+// checks of the arms are laid out in the caller (see ptm::arm_heat for the arms to keep inline or to move away)
+struct outlined_policy
+{
+};
+
+inline static constexpr outlined_policy outlined{};
+
+template <class T>
+struct is_profiled_policy : std::false_type
+{
+};
+
+template <fixed_string Site>
+struct is_profiled_policy<profiled_policy<Site>> : std::true_type
+{
+};
+
+template <class T>
+struct is_adaptive_site_policy : std::false_type
+{
+};
+
+template <fixed_string Site>
+struct is_adaptive_site_policy<adaptive_site_policy<Site>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_match_policy_v = std::same_as<std::remove_cvref_t<T>, default_policy>
+    || std::same_as<std::remove_cvref_t<T>, branchless_policy>
+    || std::same_as<std::remove_cvref_t<T>, adaptive_policy>
+    || std::same_as<std::remove_cvref_t<T>, outlined_policy>
+    || is_adaptive_site_policy<std::remove_cvref_t<T>>::value
+    || is_profiled_policy<std::remove_cvref_t<T>>::value;
+
+//=================================================================================================
+
+template <class Patterns>
+struct speculatable_patterns;
+
+template <class... P>
+struct speculatable_patterns<std::tuple<P...>> : std::bool_constant<all_speculatable_v<P...>>
+{
+};
+
+template <class Policy, class... M>
+inline static constexpr bool policy_accepts_v = true;
+
+template <class... M>
+inline static constexpr bool policy_accepts_v<branchless_policy, M...> =
+    (speculatable_patterns<matcher_pattern_types_t<M>>::value && ...);
+
+template <class... M>
+inline static constexpr bool policy_accepts_v<adaptive_policy, M...> = disjoint_arms<matcher_pattern_types_t<M>...>::value;
+
+template <fixed_string Site, class... M>
+inline static constexpr bool policy_accepts_v<adaptive_site_policy<Site>, M...> = policy_accepts_v<adaptive_policy, M...>;
+
+//=================================================================================================
+
+struct linear_strategy
+{
+};
+
+//=================================================================================================
+
+template <class E, class... M>
+struct jump_table_strategy
+{
+    using table_type = literal_jump_table_impl<std::remove_cvref_t<E>, single_pattern_t<M>...>;
+
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&...) noexcept
+    {
+        return table_type::select(std::get<0>(expressions));
+    }
+};
+
+//=================================================================================================
+
+template <class E, class... M>
+struct interval_table_strategy
+{
+    using table_type = literal_interval_table_impl<std::remove_cvref_t<E>, single_pattern_t<M>...>;
+
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&...) noexcept
+    {
+        return table_type::select(std::get<0>(expressions));
+    }
+};
+
+//=================================================================================================
+
+template <class Matcher, class Expressions>
+PATUM_FORWARDING_INLINE constexpr bool check_expressions(const Matcher& matcher, const Expressions& expressions)
+{
+    return matcher.check_tuple(expressions);
+}
+
+// Checks the arms of a single subject match starting from First in order, as a plain chain would do
+template <std::size_t First, std::size_t... I, class Expressions, class... Matchers>
+constexpr std::size_t select_first_match(std::index_sequence<I...>, const Expressions& expressions, const Matchers&... matchers)
+{
+    std::size_t index = sizeof...(Matchers);
+
+    [[maybe_unused]] auto ignore = (((I >= First) && matchers.check(std::get<0>(expressions))
+        && (void(index = I), true)) || ...);
+
+    return index;
+}
+
+//=================================================================================================
+
+template <class Table>
+struct string_table_strategy
+{
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        const std::size_t index = Table::select(std::get<0>(expressions));
+
+        // Arms following the string literals are left to be checked in order
+        if (index != Table::literal_count)
+            return index;
+
+        return select_first_match<Table::literal_count>(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+    }
+};
+
+//=================================================================================================
+
+template <class Table>
+struct domain_table_strategy
+{
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        const std::size_t index = Table::select(std::get<0>(expressions));
+
+        if constexpr (Table::traits::full)
+            return index;
+
+        else if (index != Table::outside_domain)
+            return index;
+
+        else
+            return select_first_match<0>(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+    }
+};
+
+//=================================================================================================
+
+template <class Table>
+struct variant_table_strategy
+{
+    // Switches once on the index shifted by one, so a variant valueless by exception (std::variant_npos) lands on
+    // the first case and checks every arm in order
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        return visit_index<Table::alternative_count + 1>(std::get<0>(expressions).index() + 1, [&](auto shifted) -> std::size_t
+        {
+            if constexpr (shifted() == 0)
+                return select_first_match<0>(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+            else
+                return Table::template select_alternative<shifted() - 1>(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+        });
+    }
+};
+
+//=================================================================================================
+
+template <class Table>
+struct variant_grid_strategy
+{
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        const std::size_t cell = Table::cell_index(expressions);
+
+        // Valueless subjects check every arm in order
+        if (cell == Table::cell_count) [[unlikely]]
+            return select_valueless(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+
+        const std::size_t index = Table::table[cell];
+
+        if constexpr (Table::resolved)
+            return index;
+
+        else if (index != Table::unresolved)
+            return index;
+
+        else
+        {
+            // Cells needing to look at the values get their own case, holding only the arms that apply to them
+            return visit_index<Table::cell_count>(cell, [&](auto selected) -> std::size_t
+            {
+                if constexpr (Table::table[selected()] != Table::unresolved)
+                    return Table::table[selected()];
+                else
+                    return Table::template select_cell<selected()>(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+            });
+        }
+    }
+
+private:
+    // Same as a plain chain, each arm being checked against all of the subjects and not only the first one
+    template <std::size_t... I, class Expressions, class... Matchers>
+    static constexpr std::size_t select_valueless(std::index_sequence<I...>, const Expressions& expressions, const Matchers&... matchers)
+    {
+        std::size_t index = sizeof...(Matchers);
+
+        [[maybe_unused]] auto ignore = ((check_expressions(matchers, expressions) && (void(index = I), true)) || ...);
+
+        return index;
+    }
+};
+
+//=================================================================================================
+
+template <class Table>
+struct decision_tree_strategy
+{
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&...) noexcept
+    {
+        return Table::select(expressions);
+    }
+};
+
+template <class Table>
+struct destructure_tree_strategy
+{
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&...) noexcept
+    {
+        return Table::select(std::get<0>(expressions));
+    }
+};
+
+//=================================================================================================
+
+struct branchless_strategy
+{
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        return select_mask(std::index_sequence_for<Matchers...>{}, expressions, matchers...);
+    }
+
+private:
+    template <std::size_t... I, class Expressions, class... Matchers>
+    static constexpr std::size_t select_mask(std::index_sequence<I...>, const Expressions& expressions, const Matchers&... matchers)
+    {
+        constexpr std::size_t arm_count = sizeof...(Matchers);
+
+        // One bit per arm, plus a sentinel bit after the last arm so the scan always stops at the no match index
+        std::array<std::uint64_t, arm_count / 64 + 1> words{};
+
+        ((words[I / 64] |= std::uint64_t(check_all(matchers, expressions)) << (I % 64)), ...);
+        words[arm_count / 64] |= std::uint64_t(1) << (arm_count % 64);
+
+        for (std::size_t word = 0; word < words.size() - 1; ++word)
+        {
+            if (words[word] != 0)
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(words[word]));
+        }
+
+        return (words.size() - 1) * 64 + static_cast<std::size_t>(std::countr_zero(words.back()));
+    }
+
+    // Short circuiting the patterns of an arm would introduce branches the optimizer can thread through the
+    // correlated predicates of the other arms (like x < 1 and x < 2), rebuilding a chain of conditional jumps
+    template <class Matcher, class Expressions>
+    static constexpr bool check_all(const Matcher& matcher, const Expressions& expressions)
+    {
+        return std::apply([&](const auto&... ex) { return matcher.check_all(ex...); }, expressions);
+    }
+};
+
+//=================================================================================================
+
+template <class Site, class Expressions, class Matchers>
+struct adaptive_strategy;
+
+template <fixed_string Site, class Expressions, class Matchers>
+struct profiled_strategy;
+
+//=================================================================================================
+
+template <class E, class... M>
+consteval auto select_destructure_strategy()
+{
+    using U = std::remove_cvref_t<E>;
+
+    if constexpr (not destructurable_tuple<U>)
+        return std::type_identity<linear_strategy>{};
+
+    else if constexpr (not (false || ... || is_destructure_v<single_pattern_t<M>>))
+        return std::type_identity<linear_strategy>{};
+
+    else if constexpr (not (not std::is_void_v<typename destructure_row<single_pattern_t<M>, std::tuple_size_v<U>>::type> && ...))
+        return std::type_identity<linear_strategy>{};
+
+    else
+    {
+        using table_type = decision_tree_impl<typename destructure_subjects<U>::type,
+            typename destructure_row<single_pattern_t<M>, std::tuple_size_v<U>>::type...>;
+
+        if constexpr (table_type::applicable)
+            return std::type_identity<destructure_tree_strategy<table_type>>{};
+        else
+            return std::type_identity<linear_strategy>{};
+    }
+}
+
+template <class E, class... M>
+consteval auto select_single_match_strategy()
+{
+    if constexpr (literal_domain_table<std::remove_cvref_t<E>, single_pattern_t<M>...>::applicable)
+        return std::type_identity<domain_table_strategy<literal_domain_table_impl<std::remove_cvref_t<E>, single_pattern_t<M>...>>>{};
+
+    else if constexpr (literal_jump_table<std::remove_cvref_t<E>, single_pattern_t<M>...>::applicable)
+        return std::type_identity<jump_table_strategy<E, M...>>{};
+
+    else if constexpr (literal_interval_table<std::remove_cvref_t<E>, single_pattern_t<M>...>::applicable)
+        return std::type_identity<interval_table_strategy<E, M...>>{};
+
+    else if constexpr (literal_string_switch<std::remove_cvref_t<E>, single_pattern_t<M>...>::applicable)
+        return std::type_identity<string_table_strategy<literal_string_switch_impl<std::remove_cvref_t<E>, single_pattern_t<M>...>>>{};
+
+    else if constexpr (literal_string_table<std::remove_cvref_t<E>, single_pattern_t<M>...>::applicable)
+        return std::type_identity<string_table_strategy<literal_string_table_impl<std::remove_cvref_t<E>, single_pattern_t<M>...>>>{};
+
+    else if constexpr (variant_index_table<std::remove_cvref_t<E>, single_pattern_t<M>...>::applicable)
+        return std::type_identity<variant_table_strategy<variant_index_table_impl<std::remove_cvref_t<E>, single_pattern_t<M>...>>>{};
+
+    else
+        return select_destructure_strategy<E, M...>();
+}
+
+template <class... E, class... M>
+consteval auto select_multiple_match_strategy(type_list<E...>, type_list<M...>)
+{
+    using table_type = decision_tree_impl<std::tuple<std::remove_cvref_t<E>...>, matcher_pattern_types_t<M>...>;
+
+    if constexpr (variant_grid_table<std::tuple<std::remove_cvref_t<E>...>, matcher_pattern_types_t<M>...>::applicable)
+        return std::type_identity<variant_grid_strategy<variant_grid_table_impl<std::tuple<std::remove_cvref_t<E>...>, matcher_pattern_types_t<M>...>>>{};
+
+    else if constexpr (table_type::applicable)
+        return std::type_identity<decision_tree_strategy<table_type>>{};
+    else
+        return std::type_identity<linear_strategy>{};
+}
+
+template <class... E, class... M>
+consteval auto select_match_strategy(default_policy, type_list<E...>, type_list<M...>)
+{
+    if constexpr (sizeof...(E) == 1)
+        return select_single_match_strategy<E..., M...>();
+
+    else
+        return select_multiple_match_strategy(type_list<E...>{}, type_list<M...>{});
+}
+
+template <class... E, class... M>
+consteval auto select_match_strategy(outlined_policy, type_list<E...>, type_list<M...>)
+{
+    return select_match_strategy(default_policy{}, type_list<E...>{}, type_list<M...>{});
+}
+
+template <class... E, class... M>
+consteval auto select_match_strategy(branchless_policy, type_list<E...>, type_list<M...>)
+{
+    return std::type_identity<branchless_strategy>{};
+}
+
+template <class... E, class... M>
+consteval auto select_match_strategy(adaptive_policy, type_list<E...>, type_list<M...>)
+{
+    return std::type_identity<adaptive_strategy<void, type_list<E...>, type_list<M...>>>{};
+}
+
+template <fixed_string Site, class... E, class... M>
+consteval auto select_match_strategy(adaptive_site_policy<Site>, type_list<E...>, type_list<M...>)
+{
+    return std::type_identity<adaptive_strategy<adaptive_site_policy<Site>, type_list<E...>, type_list<M...>>>{};
+}
+
+template <fixed_string Site, class... E, class... M>
+consteval auto select_match_strategy(profiled_policy<Site>, type_list<E...>, type_list<M...>)
+{
+    return std::type_identity<profiled_strategy<Site, type_list<E...>, type_list<M...>>>{};
+}
+
+template <class Policy, class Expressions, class Matchers>
+using match_strategy_t = typename decltype(select_match_strategy(Policy{}, Expressions{}, Matchers{}))::type;
+
+//=================================================================================================
+
+// Each match site owns the counters of its arms, keyed by its name or else by the types of its subjects and arms. When
+// the hot arms don't match, the arms are selected as without the policy: being disjoint, at most one of them can match
+// the subjects and none of the hot arms does, so skipping them only matters when they are checked in order.
+template <class Site, class... E, class... M>
+struct adaptive_strategy<Site, type_list<E...>, type_list<M...>>
+{
+    inline static constexpr std::size_t arm_count = sizeof...(M);
+    inline static constexpr std::size_t disjoint_count = disjoint_arms<matcher_pattern_types_t<M>...>::count;
+
+    using fallback_strategy = match_strategy_t<default_policy, type_list<E...>, type_list<M...>>;
+
+    using counters_type = adaptive_counters<disjoint_count>;
+
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        if (std::is_constant_evaluated())
+            return select_fallback(counters_type::no_hot_arms, expressions, matchers...);
+
+        auto& counters = adaptive_site_counters<std::conditional_t<std::is_void_v<Site>, adaptive_strategy, Site>, disjoint_count>;
+        const std::uint64_t hot_arms = counters.hot_arms.load(std::memory_order_relaxed);
+
+        for (std::size_t slot = 0; slot < adaptive_hot_arms; ++slot)
+        {
+            const std::size_t arm = (hot_arms >> (slot * 16)) & counters_type::empty_slot;
+
+            if (arm == counters_type::empty_slot)
+                break;
+
+            if (check_arm(arm, expressions, matchers...))
+            {
+                counters.record(arm);
+                return arm;
+            }
+        }
+
+        const std::size_t index = select_fallback(hot_arms, expressions, matchers...);
+
+        if (index < disjoint_count)
+            counters.record(index);
+
+        return index;
+    }
+
+private:
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select_fallback(std::uint64_t hot_arms, const Expressions& expressions, const Matchers&... matchers)
+    {
+        if constexpr (std::same_as<fallback_strategy, linear_strategy>)
+            return select_in_order(std::index_sequence_for<Matchers...>{}, hot_arms, expressions, matchers...);
+        else
+            return fallback_strategy::select(expressions, matchers...);
+    }
+
+    template <class Expressions, class... Matchers>
+    static bool check_arm(std::size_t arm, const Expressions& expressions, const Matchers&... matchers)
+    {
+        const auto arms = std::forward_as_tuple(matchers...);
+
+        return visit_index<sizeof...(Matchers)>(arm, [&](auto selected)
+        {
+            return check_expressions(std::get<selected()>(arms), expressions);
+        });
+    }
+
+    static constexpr bool is_hot(std::size_t arm, std::uint64_t hot_arms) noexcept
+    {
+        bool result = false;
+
+        for (std::size_t slot = 0; slot < adaptive_hot_arms; ++slot)
+            result |= ((hot_arms >> (slot * 16)) & counters_type::empty_slot) == arm;
+
+        return result;
+    }
+
+    // The remaining arms in source order, skipping the hot ones already checked
+    template <std::size_t... I, class Expressions, class... Matchers>
+    static constexpr std::size_t select_in_order(std::index_sequence<I...>, std::uint64_t hot_arms, const Expressions& expressions, const Matchers&... matchers)
+    {
+        std::size_t index = sizeof...(Matchers);
+
+        [[maybe_unused]] auto ignore = ((not is_hot(I, hot_arms) && check_expressions(matchers, expressions)
+            && (void(index = I), true)) || ...);
+
+        return index;
+    }
+};
+
+//=================================================================================================
+
+// The profile is read at compile time: chains are reordered when their arms are disjoint, tables are preceded by the
+// few arms taking most of the hits, and the arm expected to match is hinted as likely. Instrumented builds count the
+// arm selected on top of that.
+template <fixed_string Site, class... E, class... M>
+struct profiled_strategy<Site, type_list<E...>, type_list<M...>>
+{
+    using plan = profile_plan<Site, std::tuple<std::remove_cvref_t<E>...>, matcher_pattern_types_t<M>...>;
+
+    using fallback_strategy = match_strategy_t<default_policy, type_list<E...>, type_list<M...>>;
+
+    inline static constexpr std::size_t arm_count = sizeof...(M);
+    inline static constexpr profile_dispatch dispatch = plan::select_dispatch(std::same_as<fallback_strategy, linear_strategy>);
+    inline static constexpr std::size_t likely_arm = plan::select_likely_arm(dispatch);
+
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select(const Expressions& expressions, const Matchers&... matchers)
+    {
+        const std::size_t index = select_profiled(expressions, matchers...);
+
+#if PATUM_PROFILE_RECORD
+        if (not std::is_constant_evaluated() && index < arm_count)
+            profile_site_counters<Site, plan::signature, arm_count>.record(Site.view(), plan::signature, index);
+#endif
+
+        return index;
+    }
+
+private:
+    template <class Expressions, class... Matchers>
+    static constexpr std::size_t select_profiled(const Expressions& expressions, const Matchers&... matchers)
+    {
+        if constexpr (dispatch == profile_dispatch::ordered_chain || dispatch == profile_dispatch::likely_chain)
+            return select_ordered(std::make_index_sequence<arm_count>{}, expressions, matchers...);
+
+        else if constexpr (dispatch == profile_dispatch::hot_first)
+        {
+            const std::size_t index = select_ordered(std::make_index_sequence<plan::hot_count>{}, expressions, matchers...);
+
+            // Disjoint arms: when none of the hot ones matches, the first matching arm is the same without them
+            return index != arm_count ? index : fallback_strategy::select(expressions, matchers...);
+        }
+
+        else if constexpr (std::same_as<fallback_strategy, linear_strategy>)
+            return select_ordered(std::make_index_sequence<arm_count>{}, expressions, matchers...);
+
+        else
+            return fallback_strategy::select(expressions, matchers...);
+    }
+
+    template <std::size_t Arm, class Arms, class Expressions>
+    static constexpr bool check_arm(const Arms& arms, const Expressions& expressions)
+    {
+        const bool matched = check_expressions(std::get<Arm>(arms), expressions);
+
+        if constexpr (Arm == likely_arm)
+        {
+            if (matched) [[likely]]
+                return true;
+
+            return false;
+        }
+        else
+            return matched;
+    }
+
+    // The arms at the first positions of the profile order, which is the source order unless the arms are disjoint
+    template <std::size_t... I, class Expressions, class... Matchers>
+    static constexpr std::size_t select_ordered(std::index_sequence<I...>, const Expressions& expressions, const Matchers&... matchers)
+    {
+        const auto arms = std::forward_as_tuple(matchers...);
+        std::size_t index = sizeof...(Matchers);
+
+        [[maybe_unused]] auto ignore = ((check_arm<plan::order[I]>(arms, expressions)
+            && (void(index = plan::order[I]), true)) || ...);
+
+        return index;
+    }
+};
+
+} // namespace ptm
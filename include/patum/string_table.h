@@ -0,0 +1,367 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "literal.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t string_table_min_literals = 4;
+inline static constexpr std::uint32_t string_table_max_seed = 0x10000;
+inline static constexpr std::size_t string_switch_min_literals = 2;
+inline static constexpr std::size_t string_switch_max_length = 16;
+inline static constexpr std::size_t string_switch_max_bucket = 8;
+
+//=================================================================================================
+
+constexpr std::uint64_t string_table_hash(std::string_view text) noexcept
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (const char c : text)
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+
+    return hash;
+}
+
+constexpr std::uint64_t string_table_remix(std::uint64_t hash, std::uint32_t seed) noexcept
+{
+    hash ^= seed;
+    hash *= 0x9e3779b97f4a7c15ull;
+    return hash ^ (hash >> 29);
+}
+
+//=================================================================================================
+
+struct packed_string
+{
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+
+    constexpr bool operator==(const packed_string&) const noexcept = default;
+};
+
+// Packs a string of up to 16 bytes into two zero padded little endian words, so two strings of the same length are
+// equal when their words are equal. At runtime on little endian machines its bytes are copied at once into the zeroed
+// words, otherwise they are gathered one by one.
+constexpr packed_string pack_short_string(std::string_view text) noexcept
+{
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        if (not std::is_constant_evaluated())
+        {
+            std::uint64_t words[2] = {};
+            std::memcpy(words, text.data(), std::min(text.size(), sizeof(words)));
+
+            return { words[0], words[1] };
+        }
+    }
+
+    packed_string result;
+
+    for (std::size_t index = 0; index < text.size(); ++index)
+        (index < 8 ? result.low : result.high) |= std::uint64_t(static_cast<unsigned char>(text[index])) << ((index % 8) * 8);
+
+    return result;
+}
+
+//=================================================================================================
+
+template <class... P>
+inline static constexpr std::size_t leading_literal_strings = []
+{
+    constexpr std::array<bool, sizeof...(P)> literal_arms = { is_literal_string_v<P>... };
+
+    std::size_t count = 0;
+
+    while (count < literal_arms.size() && literal_arms[count])
+        ++count;
+
+    return count;
+}();
+
+//=================================================================================================
+
+// Perfect hash over the leading run of string literal arms: the subject is hashed once, the hash picks a bucket whose
+// seed remixes it into a slot owned by at most one literal, then a single comparison confirms the hit. Arms after the
+// run (predicates, wildcards) are left to the caller, starting from literal_count.
+template <class S, class... P>
+struct literal_string_table_impl
+{
+    inline static constexpr std::size_t literal_count = leading_literal_strings<P...>;
+
+    using index_type = std::conditional_t<(sizeof...(P) < 0xff), std::uint8_t, std::uint16_t>;
+
+    template <class Q>
+    static constexpr std::string_view arm_key() noexcept
+    {
+        if constexpr (is_literal_string_v<Q>)
+            return literal_string_value_v<Q>;
+        else
+            return {};
+    }
+
+    inline static constexpr std::array<std::string_view, sizeof...(P)> arm_keys = { arm_key<P>()... };
+
+    inline static constexpr std::size_t slot_count = std::bit_ceil(literal_count * 2);
+    inline static constexpr std::size_t bucket_count = std::bit_ceil(literal_count);
+
+    struct table_type
+    {
+        std::array<std::uint32_t, bucket_count> seeds;
+        std::array<index_type, slot_count> slots;
+        bool complete;
+    };
+
+    inline static constexpr table_type table = []
+    {
+        table_type result{};
+        result.slots.fill(static_cast<index_type>(literal_count));
+
+        std::array<std::uint64_t, literal_count> hashes{};
+        std::array<bool, literal_count> shadowed{};
+
+        for (std::size_t index = 0; index < literal_count; ++index)
+        {
+            hashes[index] = string_table_hash(arm_keys[index]);
+
+            // The same literal repeated later never gets selected, the first arm using it wins
+            for (std::size_t other = 0; other < index; ++other)
+                shadowed[index] = shadowed[index] || arm_keys[other] == arm_keys[index];
+        }
+
+        // Larger buckets are harder to place, so they get to pick their seed first
+        std::array<std::size_t, bucket_count> bucket_sizes{};
+        std::array<std::size_t, bucket_count> bucket_order{};
+
+        for (std::size_t index = 0; index < literal_count; ++index)
+        {
+            if (not shadowed[index])
+                ++bucket_sizes[hashes[index] & (bucket_count - 1)];
+        }
+
+        for (std::size_t bucket = 0; bucket < bucket_count; ++bucket)
+            bucket_order[bucket] = bucket;
+
+        std::sort(bucket_order.begin(), bucket_order.end(), [&](std::size_t lhs, std::size_t rhs)
+        {
+            return bucket_sizes[lhs] > bucket_sizes[rhs] || (bucket_sizes[lhs] == bucket_sizes[rhs] && lhs < rhs);
+        });
+
+        for (const auto bucket : bucket_order)
+        {
+            if (bucket_sizes[bucket] == 0)
+                break;
+
+            bool placed = false;
+
+            for (std::uint32_t seed = 0; seed < string_table_max_seed && not placed; ++seed)
+            {
+                auto slots = result.slots;
+                placed = true;
+
+                for (std::size_t index = 0; index < literal_count && placed; ++index)
+                {
+                    if (shadowed[index] || (hashes[index] & (bucket_count - 1)) != bucket)
+                        continue;
+
+                    const auto slot = string_table_remix(hashes[index], seed) & (slot_count - 1);
+
+                    if (slots[slot] != literal_count)
+                        placed = false;
+                    else
+                        slots[slot] = static_cast<index_type>(index);
+                }
+
+                if (placed)
+                {
+                    result.seeds[bucket] = seed;
+                    result.slots = slots;
+                }
+            }
+
+            if (not placed)
+                return result;
+        }
+
+        result.complete = true;
+
+        return result;
+    }();
+
+    static constexpr std::size_t select(const S& subject) noexcept
+    {
+        const std::string_view text(subject);
+
+        const auto hash = string_table_hash(text);
+        const auto slot = string_table_remix(hash, table.seeds[hash & (bucket_count - 1)]) & (slot_count - 1);
+        const std::size_t arm = table.slots[slot];
+
+        return arm < literal_count && arm_keys[arm] == text ? arm : literal_count;
+    }
+};
+
+//=================================================================================================
+
+// Switches on the length of the subject first, then compares its packed words against the ones of the literals
+// having that same length, trading the byte by byte comparison for a couple of integer compares per literal
+template <class S, class... P>
+struct literal_string_switch_impl
+{
+    inline static constexpr std::size_t literal_count = leading_literal_strings<P...>;
+
+    struct entry
+    {
+        packed_string words;
+        std::size_t position;
+    };
+
+    template <class Q>
+    static constexpr std::string_view arm_key() noexcept
+    {
+        if constexpr (is_literal_string_v<Q>)
+            return literal_string_value_v<Q>;
+        else
+            return {};
+    }
+
+    inline static constexpr std::array<std::string_view, sizeof...(P)> arm_keys = { arm_key<P>()... };
+
+    static constexpr bool is_shadowed(std::size_t arm) noexcept
+    {
+        for (std::size_t other = 0; other < arm; ++other)
+        {
+            if (arm_keys[other] == arm_keys[arm])
+                return true;
+        }
+
+        return false;
+    }
+
+    inline static constexpr std::size_t max_length = []
+    {
+        std::size_t result = 0;
+
+        for (std::size_t index = 0; index < literal_count; ++index)
+            result = std::max(result, arm_keys[index].size());
+
+        return result;
+    }();
+
+    // Literals of the most crowded length: every length gets that many slots, so the number of compares is fixed
+    inline static constexpr std::size_t bucket_size = []
+    {
+        std::array<std::size_t, max_length + 1> counts{};
+
+        for (std::size_t index = 0; index < literal_count; ++index)
+            counts[arm_keys[index].size()] += is_shadowed(index) ? 0 : 1;
+
+        std::size_t result = 0;
+
+        for (const auto count : counts)
+            result = std::max(result, count);
+
+        return result;
+    }();
+
+    // Unique literals grouped by length in rows of bucket_size slots, each one holding the one based position of the
+    // first arm (in source order) using it. Unused slots hold position zero, so they never contribute to a match.
+    inline static constexpr auto buckets = []
+    {
+        std::array<entry, bucket_size * (max_length + 1)> result{};
+        std::array<std::size_t, max_length + 1> counts{};
+
+        for (std::size_t arm = 0; arm < literal_count; ++arm)
+        {
+            if (is_shadowed(arm))
+                continue;
+
+            const std::size_t size = arm_keys[arm].size();
+            result[size * bucket_size + counts[size]++] = { pack_short_string(arm_keys[arm]), arm + 1 };
+        }
+
+        return result;
+    }();
+
+    static constexpr std::size_t select(const S& subject) noexcept
+    {
+        const std::string_view text(subject);
+
+        if (text.size() > max_length)
+            return literal_count;
+
+        const auto words = pack_short_string(text);
+        const entry* bucket = buckets.data() + text.size() * bucket_size;
+
+        // At most one literal of a given length matches, so its position can be collected without branching
+        std::size_t position = 0;
+
+        for (std::size_t index = 0; index < bucket_size; ++index)
+        {
+            const auto difference = (bucket[index].words.low ^ words.low) | (bucket[index].words.high ^ words.high);
+            position |= bucket[index].position & (std::size_t(0) - std::size_t(difference == 0));
+        }
+
+        return position != 0 ? position - 1 : literal_count;
+    }
+};
+
+//=================================================================================================
+
+template <class S, class... P>
+struct literal_string_switch
+{
+    static consteval bool is_applicable()
+    {
+        if constexpr (not std::is_convertible_v<const S&, std::string_view>)
+            return false;
+
+        else if constexpr (leading_literal_strings<P...> < string_switch_min_literals)
+            return false;
+
+        else
+            return literal_string_switch_impl<S, P...>::max_length <= string_switch_max_length
+                && literal_string_switch_impl<S, P...>::bucket_size <= string_switch_max_bucket;
+    }
+
+    inline static constexpr bool applicable = is_applicable();
+};
+
+//=================================================================================================
+
+template <class S, class... P>
+struct literal_string_table
+{
+    static consteval bool is_applicable()
+    {
+        if constexpr (not std::is_convertible_v<const S&, std::string_view>)
+            return false;
+
+        else if constexpr (leading_literal_strings<P...> < string_table_min_literals)
+            return false;
+
+        else
+            return literal_string_table_impl<S, P...>::table.complete;
+    }
+
+    inline static constexpr bool applicable = is_applicable();
+};
+
+} // namespace ptm
@@ -20,7 +20,7 @@ template <std::size_t N>
 struct tuple_unpacker
 {
     template <class F, class... Args1, class... Args2>
-    static constexpr bool apply(const F& func, std::tuple<Args1...> t1, std::tuple<Args2...> t2)
+    static constexpr bool apply(const F& func, const std::tuple<Args1...>& t1, const std::tuple<Args2...>& t2)
     {
         return func(std::get<N - 1>(t1), std::get<N - 1>(t2)) && tuple_unpacker<N - 1>::apply(func, t1, t2);
     }
@@ -30,7 +30,7 @@ template <>
 struct tuple_unpacker<0>
 {
     template <class F, class... Args1, class... Args2>
-    static constexpr bool apply(const F& func, std::tuple<Args1...> t1, std::tuple<Args2...> t2)
+    static constexpr bool apply(const F& func, const std::tuple<Args1...>& t1, const std::tuple<Args2...>& t2)
     {
         return true;
     }
@@ -67,6 +67,21 @@ inline static constexpr bool is_variant_holding_v = is_variant_holding<T, U>::va
 
 //=================================================================================================
 
+template <class T, class = void>
+struct is_callable : std::is_function<std::remove_pointer_t<std::remove_cvref_t<T>>>
+{
+};
+
+template <class T>
+struct is_callable<T, std::void_t<decltype(&std::remove_cvref_t<T>::operator())>> : std::true_type
+{
+};
+
+template <class T>
+inline static constexpr bool is_callable_v = is_callable<T>::value;
+
+//=================================================================================================
+
 template <class T, class... Ts>
 struct common_type_or
 {
@@ -121,25 +136,54 @@ using common_type_t = typename common_type<type_list<Ts...>>::type;
 
 //=================================================================================================
 
-template <class List>
-struct non_void_common_type;
+template <class T>
+struct common_type_accumulator
+{
+    using type = T;
+};
 
-template <>
-struct non_void_common_type<type_list<>>
+template <class T, class U>
+constexpr auto operator+(common_type_accumulator<T>, common_type_accumulator<U>) noexcept
 {
-    using type = type_list<>;
+    if constexpr (std::is_void_v<U>)
+        return common_type_accumulator<T>{};
+
+    else if constexpr (std::is_void_v<T>)
+        return common_type_accumulator<std::decay_t<U>>{};
+
+    else if constexpr (std::is_same_v<T, not_found_t>)
+        return common_type_accumulator<not_found_t>{};
+
+    else if constexpr (requires { typename std::common_type<T, U>::type; })
+        return common_type_accumulator<std::common_type_t<T, U>>{};
+
+    else
+        return common_type_accumulator<not_found_t>{};
+}
+
+// Left fold of std::common_type skipping void types, expanded without recursive instantiations so it
+// scales to matches with hundreds of arms: yields void when there are no types, not_found_t on failure
+template <class... Ts>
+struct common_type_fold
+{
+    using type = typename decltype((common_type_accumulator<void>{} + ... + common_type_accumulator<Ts>{}))::type;
 };
 
-template <class T, class... Ts>
-struct non_void_common_type<type_list<T, Ts...>>
+template <class... Ts>
+using common_type_fold_t = typename common_type_fold<Ts...>::type;
+
+//=================================================================================================
+
+template <class T>
+struct non_void_common_type
 {
     using type = std::conditional_t<
-        std::is_same_v<T, void>,
-        typename non_void_common_type<type_list<Ts...>>::type,
-        typename append_type<typename non_void_common_type<type_list<Ts...>>::type, T>::type>;
+        std::is_void_v<T> || not requires { T(); },
+        not_found_t,
+        T>;
 };
 
 template <class... Ts>
-using non_void_common_type_t = typename common_type<typename non_void_common_type<type_list<Ts...>>::type>::type;
+using non_void_common_type_t = typename non_void_common_type<common_type_fold_t<Ts...>>::type;
 
 } // namespace ptm
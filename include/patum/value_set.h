@@ -0,0 +1,312 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concepts.h"
+#include "features.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t value_set_min_sorted = 16;
+inline static constexpr std::size_t value_set_max_sorted = 1024;
+inline static constexpr std::size_t value_set_min_hashed = 12;
+
+//=================================================================================================
+
+// Integers ordered the way they compare, looked up after checking they fit in the type of the set
+template <class T>
+concept sorted_value = std::integral<T>
+    && not std::same_as<T, bool>
+    && not std::same_as<T, char>
+    && not std::same_as<T, wchar_t>
+    && not std::same_as<T, char8_t>
+    && not std::same_as<T, char16_t>
+    && not std::same_as<T, char32_t>;
+
+//=================================================================================================
+
+// Branchless binary search: the candidate range halves at every step, the comparison only picks which half it keeps
+template <class T>
+PATUM_ALWAYS_INLINE constexpr bool sorted_contains(const T* first, std::size_t count, T value) noexcept
+{
+    if (count == 0)
+        return false;
+
+    while (count > 1)
+    {
+        const std::size_t half = count / 2;
+
+        first += static_cast<std::size_t>(first[half] <= value) * half;
+        count -= half;
+    }
+
+    return *first == value;
+}
+
+//=================================================================================================
+
+// Bijective, so integers of the same type have the same hash only when they are equal
+constexpr std::uint64_t value_set_mix(std::uint64_t hash) noexcept
+{
+    hash = (hash ^ (hash >> 32)) * 0xd6e8feb86659fd93ull;
+    hash = (hash ^ (hash >> 32)) * 0xd6e8feb86659fd93ull;
+    return hash ^ (hash >> 32);
+}
+
+template <sorted_value T>
+constexpr std::uint64_t value_set_hash(T value) noexcept
+{
+    return value_set_mix(static_cast<std::uint64_t>(value));
+}
+
+// Little endian words of the characters, the same at compile time and at run time
+constexpr std::uint64_t value_set_word(const char* characters, std::size_t count) noexcept
+{
+    std::uint64_t word = 0;
+
+    if (not std::is_constant_evaluated() && std::endian::native == std::endian::little && count == sizeof(word))
+        std::memcpy(&word, characters, sizeof(word));
+
+    else
+    {
+        for (std::size_t index = 0; index < count; ++index)
+            word |= std::uint64_t(static_cast<unsigned char>(characters[index])) << (8 * index);
+    }
+
+    return word;
+}
+
+constexpr std::uint64_t value_set_hash(std::string_view text) noexcept
+{
+    std::uint64_t hash = text.size();
+    std::size_t offset = 0;
+
+    for (; offset + 8 <= text.size(); offset += 8)
+        hash = value_set_mix(hash ^ value_set_word(text.data() + offset, 8));
+
+    if (offset < text.size())
+        hash = value_set_mix(hash ^ value_set_word(text.data() + offset, text.size() - offset));
+
+    return hash;
+}
+
+//=================================================================================================
+
+// Slot of an open addressing table. Strings compare their characters once their hash is equal, integers being done
+// with the hash alone.
+struct value_set_slot
+{
+    inline static constexpr std::size_t empty = std::numeric_limits<std::size_t>::max();
+
+    std::uint64_t hash = 0;
+    std::size_t index = empty;
+};
+
+// Tables are at most half full, so probes stay short
+constexpr std::size_t value_set_slot_count(std::size_t count) noexcept
+{
+    return std::bit_ceil(std::max(count * 2, std::size_t(2)));
+}
+
+template <class T>
+PATUM_ALWAYS_INLINE constexpr auto value_set_key(const T& value) noexcept
+{
+    if constexpr (sorted_value<T>)
+        return value;
+    else
+        return std::string_view(value);
+}
+
+template <class Slots, class Values, class K>
+PATUM_ALWAYS_INLINE constexpr std::size_t hashed_find(const Slots& slots, const Values& values, const K& key, std::uint64_t hash) noexcept
+{
+    const std::size_t mask = std::size(slots) - 1;
+
+    std::size_t slot = hash & mask;
+
+    for (; slots[slot].index != value_set_slot::empty; slot = (slot + 1) & mask)
+    {
+        if constexpr (sorted_value<K>)
+        {
+            if (slots[slot].hash == hash)
+                break;
+        }
+        else if (slots[slot].hash == hash && value_set_key(values[slots[slot].index]) == key)
+            break;
+    }
+
+    return slot;
+}
+
+template <class Slots, class Values>
+constexpr void hashed_insert(Slots& slots, const Values& values, std::size_t index) noexcept
+{
+    const auto key = value_set_key(values[index]);
+    const std::uint64_t hash = value_set_hash(key);
+    const std::size_t slot = hashed_find(slots, values, key, hash);
+
+    if (slots[slot].index == value_set_slot::empty)
+        slots[slot] = { hash, index };
+}
+
+template <class Slots, class Values, class K>
+PATUM_ALWAYS_INLINE constexpr bool hashed_contains(const Slots& slots, const Values& values, const K& key) noexcept
+{
+    return slots[hashed_find(slots, values, key, value_set_hash(key))].index != value_set_slot::empty;
+}
+
+//=================================================================================================
+
+// Strings of a large in() pack, hashed when the predicate is built. Packs of integers are left to the compiler, which
+// already turns comparisons with constants into bit tests or a search tree.
+template <std::size_t N>
+class string_value_array
+{
+public:
+    template <class... Args>
+    constexpr explicit string_value_array(const Args&... values) noexcept
+        : values_{ std::string_view(values)... }
+    {
+        for (std::size_t index = 0; index < N; ++index)
+            hashed_insert(slots_, values_, index);
+    }
+
+    PATUM_ALWAYS_INLINE constexpr bool contains(std::string_view value) const noexcept
+    {
+        return hashed_contains(slots_, values_, value);
+    }
+
+private:
+    std::array<std::string_view, N> values_;
+    std::array<value_set_slot, value_set_slot_count(N)> slots_{};
+};
+
+//=================================================================================================
+
+// Values of a runtime container passed to in(), copied once when the predicate is built. Integers are compared one by
+// one, sorted from ptm::value_set_min_sorted values on and hashed past ptm::value_set_max_sorted, where the misses of a
+// binary search outgrow the single one of a hash table. Strings are hashed from ptm::value_set_min_hashed values on.
+template <class T>
+class value_set
+{
+public:
+    enum class layout
+    {
+        linear,
+        sorted,
+        hashed
+    };
+
+    template <class U>
+    inline static constexpr bool indexable = (sorted_value<T> && sorted_value<U>) || (StringLike<T> && StringLike<U>);
+
+    template <std::ranges::input_range R>
+    explicit value_set(const R& values)
+        : values_(std::ranges::begin(values), std::ranges::end(values))
+    {
+        if constexpr (sorted_value<T>)
+        {
+            if (values_.size() >= value_set_min_sorted && values_.size() <= value_set_max_sorted)
+            {
+                std::ranges::sort(values_);
+
+                const auto duplicates = std::ranges::unique(values_);
+                values_.erase(duplicates.begin(), duplicates.end());
+
+                layout_ = layout::sorted;
+            }
+            else if (values_.size() > value_set_max_sorted)
+                hash_values();
+        }
+
+        else if constexpr (StringLike<T>)
+        {
+            if (values_.size() >= value_set_min_hashed)
+                hash_values();
+        }
+    }
+
+    template <class U>
+        requires indexable<U>
+    bool contains(const U& value) const noexcept
+    {
+        if constexpr (sorted_value<T>)
+        {
+            if (not std::in_range<T>(value))
+                return false;
+
+            const T key = static_cast<T>(value);
+
+            switch (layout_)
+            {
+            case layout::sorted: return sorted_contains(values_.data(), values_.size(), key);
+            case layout::hashed: return hashed_contains(slots_, values_, key);
+            default: return std::ranges::find(values_, key) != values_.end();
+            }
+        }
+        else
+        {
+            const std::string_view text = value;
+
+            if (layout_ == layout::hashed)
+                return hashed_contains(slots_, values_, text);
+
+            return std::ranges::any_of(values_, [&](const T& element) { return std::string_view(element) == text; });
+        }
+    }
+
+    const std::vector<T>& values() const noexcept
+    {
+        return values_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return values_.size();
+    }
+
+    layout representation() const noexcept
+    {
+        return layout_;
+    }
+
+private:
+    void hash_values()
+    {
+        slots_.resize(value_set_slot_count(values_.size()));
+
+        for (std::size_t index = 0; index < values_.size(); ++index)
+            hashed_insert(slots_, values_, index);
+
+        layout_ = layout::hashed;
+    }
+
+    std::vector<T> values_;
+    std::vector<value_set_slot> slots_;
+    layout layout_ = layout::linear;
+};
+
+} // namespace ptm
@@ -0,0 +1,335 @@
+/**
+ * patum - A pattern matching library for modern C++
+ *
+ * Copyright (c) 2025 - kunitoki <kunitoki@gmail.com>
+ *
+ * Licensed under the MIT License. Visit https://opensource.org/licenses/MIT for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "predicate.h"
+#include "type_traits.h"
+#include "wildcard.h"
+
+namespace ptm {
+
+//=================================================================================================
+
+inline static constexpr std::size_t variant_grid_max_cells = 1024;
+
+//=================================================================================================
+
+template <class P>
+struct variant_pattern_type;
+
+template <class T>
+struct variant_pattern_type<predicate<variant_type<T>>>
+{
+    using type = T;
+};
+
+template <class T>
+struct variant_pattern_type<predicate<variant_value<T>>>
+{
+    using type = T;
+};
+
+template <class T>
+struct variant_pattern_type<predicate<same_type<T>>>
+{
+    using type = std::remove_cvref_t<T>;
+};
+
+template <class P>
+using variant_pattern_type_t = typename variant_pattern_type<std::remove_cvref_t<P>>::type;
+
+//=================================================================================================
+
+enum class variant_arm_kind
+{
+    never,
+    always,
+    check
+};
+
+// What an arm can do for a variant holding its alternative A: being skipped, matching without looking at the value,
+// or being checked as usual. Arms not known to look at the alternative are always checked.
+template <class V, std::size_t A, class P>
+consteval variant_arm_kind classify_variant_arm()
+{
+    using alternative = std::variant_alternative_t<A, V>;
+
+    if constexpr (is_wildcard_v<P>)
+        return variant_arm_kind::always;
+
+    else if constexpr (is_variant_type_v<P>)
+        return std::same_as<variant_pattern_type_t<P>, alternative> ? variant_arm_kind::always : variant_arm_kind::never;
+
+    else if constexpr (is_variant_value_v<P>)
+        return std::same_as<variant_pattern_type_t<P>, alternative> ? variant_arm_kind::check : variant_arm_kind::never;
+
+    else if constexpr (is_same_type_v<P>)
+        return std::same_as<variant_pattern_type_t<P>, V> ? variant_arm_kind::always : variant_arm_kind::never;
+
+    else
+        return variant_arm_kind::check;
+}
+
+//=================================================================================================
+
+template <class S, class... P>
+struct variant_index_table
+{
+    static consteval bool is_applicable()
+    {
+        if constexpr (not is_variant_v<S>)
+            return false;
+
+        else
+            return (false || ... || (is_variant_type_v<P> || is_variant_value_v<P>));
+    }
+
+    inline static constexpr bool applicable = is_applicable();
+};
+
+//=================================================================================================
+
+// Arms that could match each alternative of the variant, pruned at compile time and checked in order
+template <class S, class... P>
+struct variant_index_table_impl
+{
+    inline static constexpr std::size_t alternative_count = std::variant_size_v<S>;
+
+    template <std::size_t A, class Q, class Matcher, class Expressions>
+    static constexpr bool check_arm(const Matcher& matcher, const Expressions& expressions)
+    {
+        constexpr auto kind = classify_variant_arm<S, A, Q>();
+
+        if constexpr (kind == variant_arm_kind::never)
+            return false;
+
+        else if constexpr (kind == variant_arm_kind::always)
+            return true;
+
+        else
+            return matcher.check(std::get<0>(expressions));
+    }
+
+    template <std::size_t A, std::size_t... I, class Expressions, class... Matchers>
+    static constexpr std::size_t select_alternative(std::index_sequence<I...>, const Expressions& expressions, const Matchers&... matchers)
+    {
+        std::size_t index = sizeof...(Matchers);
+
+        [[maybe_unused]] auto ignore = ((check_arm<A, P>(matchers, expressions) && (void(index = I), true)) || ...);
+
+        return index;
+    }
+};
+
+//=================================================================================================
+
+template <class Subjects, class... Rows>
+struct variant_grid_table
+{
+    inline static constexpr bool applicable = false;
+};
+
+template <class... S, class... Rows>
+struct variant_grid_table<std::tuple<S...>, Rows...>
+{
+    template <class Row>
+    struct has_variant_patterns;
+
+    template <class... P>
+    struct has_variant_patterns<std::tuple<P...>>
+        : std::bool_constant<(false || ... || (is_variant_type_v<P> || is_variant_value_v<P>))>
+    {
+    };
+
+    static consteval bool is_applicable()
+    {
+        if constexpr (not (is_variant_v<S> && ...))
+            return false;
+
+        else if constexpr (not (false || ... || has_variant_patterns<Rows>::value))
+            return false;
+
+        else
+            return (std::variant_size_v<S> * ... * 1) <= variant_grid_max_cells;
+    }
+
+    inline static constexpr bool applicable = is_applicable();
+};
+
+//=================================================================================================
+
+// Resolves matches over several variants through a grid with one cell per combination of their alternatives, laid
+// out in row major order of the subjects. Cells whose first applicable arm doesn't need to look at the values (typed,
+// is and wildcard patterns) store that arm, the others are marked unresolved and only check the arms that apply.
+template <class Subjects, class... Rows>
+struct variant_grid_table_impl;
+
+template <class... S, class... Rows>
+struct variant_grid_table_impl<std::tuple<S...>, Rows...>
+{
+    inline static constexpr std::size_t subject_count = sizeof...(S);
+    inline static constexpr std::size_t arm_count = sizeof...(Rows);
+    inline static constexpr std::size_t cell_count = (std::variant_size_v<S> * ... * 1);
+
+    inline static constexpr std::array<std::size_t, subject_count> alternative_counts = { std::variant_size_v<S>... };
+
+    using index_type = std::conditional_t<(sizeof...(Rows) < 0xfe), std::uint8_t, std::uint16_t>;
+
+    inline static constexpr std::size_t unresolved = arm_count + 1;
+
+    // Alternative held by the subject in the given column for a cell
+    static constexpr std::size_t cell_alternative(std::size_t cell, std::size_t column) noexcept
+    {
+        for (std::size_t index = subject_count; index-- > column + 1;)
+            cell /= alternative_counts[index];
+
+        return cell % alternative_counts[column];
+    }
+
+    inline static constexpr std::array<std::size_t, subject_count> alternative_offsets = []
+    {
+        std::array<std::size_t, subject_count> result{};
+
+        for (std::size_t column = 1; column < subject_count; ++column)
+            result[column] = result[column - 1] + alternative_counts[column - 1];
+
+        return result;
+    }();
+
+    inline static constexpr std::size_t alternative_total = (std::variant_size_v<S> + ... + 0);
+
+    // Patterns are classified once per alternative of their column, cells then combine the kinds of their columns
+    template <class V, class P, std::size_t... A>
+    static constexpr void classify_column(variant_arm_kind* kinds, std::index_sequence<A...>)
+    {
+        ((kinds[A] = classify_variant_arm<V, A, P>()), ...);
+    }
+
+    template <class... P>
+    static constexpr void classify_row(variant_arm_kind* kinds, std::type_identity<std::tuple<P...>>)
+    {
+        ((classify_column<S, std::remove_cvref_t<P>>(kinds, std::make_index_sequence<std::variant_size_v<S>>{}),
+            kinds += std::variant_size_v<S>), ...);
+    }
+
+    inline static constexpr auto column_kinds = []
+    {
+        std::array<variant_arm_kind, arm_count * alternative_total> result{};
+        std::size_t arm = 0;
+
+        ((classify_row(result.data() + (arm++) * alternative_total, std::type_identity<Rows>{})), ...);
+
+        return result;
+    }();
+
+    // An arm is skipped in a cell as soon as one of its patterns is, and matches as is when all of them do
+    static constexpr variant_arm_kind cell_arm_kind(std::size_t cell, std::size_t arm) noexcept
+    {
+        bool always = true;
+
+        for (std::size_t column = 0; column < subject_count; ++column)
+        {
+            const auto kind = column_kinds[arm * alternative_total + alternative_offsets[column] + cell_alternative(cell, column)];
+
+            if (kind == variant_arm_kind::never)
+                return variant_arm_kind::never;
+
+            always = always && kind == variant_arm_kind::always;
+        }
+
+        return always ? variant_arm_kind::always : variant_arm_kind::check;
+    }
+
+    inline static constexpr auto table = []
+    {
+        std::array<index_type, cell_count> result{};
+
+        for (std::size_t cell = 0; cell < cell_count; ++cell)
+        {
+            result[cell] = static_cast<index_type>(arm_count);
+
+            for (std::size_t arm = 0; arm < arm_count; ++arm)
+            {
+                const auto kind = cell_arm_kind(cell, arm);
+
+                if (kind != variant_arm_kind::never)
+                {
+                    result[cell] = static_cast<index_type>(kind == variant_arm_kind::always ? arm : unresolved);
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }();
+
+    inline static constexpr std::size_t table_size = sizeof(table);
+
+    inline static constexpr bool resolved = []
+    {
+        for (const auto arm : table)
+        {
+            if (arm == unresolved)
+                return false;
+        }
+
+        return true;
+    }();
+
+    // Combined row major index of the alternatives held, or cell_count when any subject is valueless by exception
+    template <class Expressions>
+    static constexpr std::size_t cell_index(const Expressions& expressions) noexcept
+    {
+        return [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            std::size_t cell = 0;
+            bool valueless = false;
+
+            ((cell = cell * std::variant_size_v<S> + std::get<I>(expressions).index(),
+                valueless = valueless || std::get<I>(expressions).valueless_by_exception()), ...);
+
+            return valueless ? cell_count : cell;
+        }(std::make_index_sequence<subject_count>{});
+    }
+
+    template <std::size_t Cell, std::size_t Arm, class Matcher, class Expressions>
+    static constexpr bool check_arm(const Matcher& matcher, const Expressions& expressions)
+    {
+        constexpr auto kind = cell_arm_kind(Cell, Arm);
+
+        if constexpr (kind == variant_arm_kind::never)
+            return false;
+
+        else if constexpr (kind == variant_arm_kind::always)
+            return true;
+
+        else
+            return matcher.check_tuple(expressions);
+    }
+
+    template <std::size_t Cell, std::size_t... I, class Expressions, class... Matchers>
+    static constexpr std::size_t select_cell(std::index_sequence<I...>, const Expressions& expressions, const Matchers&... matchers)
+    {
+        std::size_t index = sizeof...(Matchers);
+
+        [[maybe_unused]] auto ignore = ((check_arm<Cell, I>(matchers, expressions) && (void(index = I), true)) || ...);
+
+        return index;
+    }
+};
+
+} // namespace ptm
@@ -12,6 +12,7 @@
 #include <utility>
 
 #include "predicate.h"
+#include "type_traits.h"
 
 namespace ptm {
 
@@ -20,7 +21,7 @@ namespace ptm {
 template <class F>
 struct wildcard : predicate<F>
 {
-    constexpr wildcard(F&& func)
+    PATUM_FORWARDING_INLINE constexpr wildcard(F&& func)
         : predicate<F>(std::forward<F>(func))
     {
     }
@@ -70,7 +71,17 @@ struct wildcard : predicate<F>
 
 //=================================================================================================
 
-inline static constexpr auto _ = wildcard([]<class U>([[maybe_unused]] const U& value_to_test)
+template <class T>
+inline static constexpr bool is_wildcard_v = is_specialization_of_v<std::remove_cvref_t<T>, wildcard>;
+
+template <class F>
+struct is_speculatable<wildcard<F>> : std::true_type
+{
+};
+
+//=================================================================================================
+
+inline static constexpr auto _ = wildcard([]<class U>([[maybe_unused]] const U& value_to_test) PATUM_ALWAYS_INLINE
 {
     return true;
 });
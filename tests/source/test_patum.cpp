@@ -7,12 +7,22 @@
  */
 
 #include <patum.h>
+#include <patum/profile_record.h>
+#include <patum/rules.h>
 
 #include <snitch_all.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <variant>
 #include <vector>
 
 #include <iostream>
@@ -64,6 +74,8 @@ struct movable_copyable
         return *this;
     }
 
+    friend bool operator==(const movable_copyable& lhs, const movable_copyable& rhs) = default;
+
     static void reset_counters()
     {
         copy_count = 0;
@@ -163,19 +175,18 @@ TEST_CASE("Simple matcher movable objects", "[match][move]")
     REQUIRE(matched_pattern.has_value());
     CHECK(matched_pattern->counter == 3);
 #if _MSC_VER
-    // The result of 5 move constructors (there are 3 movable_copyable objects):
-    // + (1) the matched one is then moved into the invoker
-    // + (1) then it's emplaced into the result optional
-    // = (5)
-    CHECK(movable_copyable::move_count == 5);
+    // The result of 4 move constructors (there are 3 movable_copyable objects):
+    //   (3) they are moved into the pattern()
+    // + (1) the matched one is emplaced into the result optional
+    // = (4)
+    CHECK(movable_copyable::move_count == 4);
 #else
-    // The result of 6 move constructors (there are 3 movable_copyable objects):
+    // The result of 5 move constructors (there are 3 movable_copyable objects):
     //   (3) they are moved into the pattern()
-    // + (1) the matched one is then moved into the invoker
-    // + (1) then it's emplaced into the result optional
+    // + (1) the matched one is emplaced into the result optional
     // + (1) then the optional is returned with NRVO
-    // = (6)
-    CHECK(movable_copyable::move_count == 6);
+    // = (5)
+    CHECK(movable_copyable::move_count == 5);
 #endif
     CHECK(movable_copyable::copy_count == 0);
     CHECK(movable_copyable::move_assign_count == 0);
@@ -184,6 +195,187 @@ TEST_CASE("Simple matcher movable objects", "[match][move]")
 
 //=================================================================================================
 
+namespace {
+auto make_range_classifier()
+{
+    // Every pattern is a temporary dying with this function, the compiled match owns them all
+    return compile_match
+    (
+        pattern(_x > 10 && _x < 20) = 1,
+        pattern(in(30, 40, 50))     = 2,
+        pattern(_)                  = 0
+    );
+}
+
+auto make_pair_classifier()
+{
+    const int second = 9;
+
+    return compile_match
+    (
+        pattern(ds(7, _))           = 3,
+        pattern(ds(_, second))      = 4,
+        pattern(_)                  = 0
+    );
+}
+
+auto make_name_classifier()
+{
+    const std::string name = "alpha";
+    const std::size_t limit = 8;
+    const auto named = pattern(_x == name) = 1;
+
+    // The operands and the arms given by name die with this function, the compiled match keeps copies of them
+    return compile_match
+    (
+        named,
+        pattern(in(name + "2", "beta"s))    = 2,
+        pattern(size(_x) > limit)           = 3,
+        pattern(_)                          = 0
+    );
+}
+
+auto make_buffer_classifier(std::string_view text)
+{
+    char buffer[8] = {};
+    char other[8] = {};
+    text.copy(buffer, sizeof(buffer) - 1);
+    text.substr(1).copy(other, sizeof(other) - 1);
+
+    // The arrays are no string literals, the compiled match copies them instead of referring to this frame
+    return compile_match
+    (
+        pattern(buffer)         = 1,
+        pattern(in(other, "z")) = 2,
+        pattern(_)              = 0
+    );
+}
+} // namespace
+
+TEST_CASE("Compiled match", "[match][compiled]")
+{
+    const auto classifier = make_range_classifier();
+
+    CHECK(classifier(15).value_or(-1) == 1);
+    CHECK(classifier(40).value_or(-1) == 2);
+    CHECK(classifier(25).value_or(-1) == 0);
+
+    auto pair_classifier = make_pair_classifier();
+    const auto pair_classifier_copy = pair_classifier;
+
+    CHECK(pair_classifier_copy(std::make_tuple(7, 2)).value_or(-1) == 3);
+
+    CHECK(pair_classifier(std::make_tuple(7, 1)).value_or(-1) == 3);
+    CHECK(pair_classifier(std::make_tuple(8, 1)).value_or(-1) == 0);
+    CHECK(pair_classifier(std::make_tuple(8, 9)).value_or(-1) == 4);
+
+    const auto name_classifier = make_name_classifier();
+
+    CHECK(name_classifier("alpha"s).value_or(-1) == 1);
+    CHECK(name_classifier("alpha2"s).value_or(-1) == 2);
+    CHECK(name_classifier("beta"s).value_or(-1) == 2);
+    CHECK(name_classifier("something long"s).value_or(-1) == 3);
+    CHECK(name_classifier("gamma"s).value_or(-1) == 0);
+
+    const auto buffer_classifier = make_buffer_classifier("delta");
+
+    CHECK(buffer_classifier("delta"sv).value_or(-1) == 1);
+    CHECK(buffer_classifier("elta"s).value_or(-1) == 2);
+    CHECK(buffer_classifier("z").value_or(-1) == 2);
+    CHECK(buffer_classifier("gamma"sv).value_or(-1) == 0);
+
+    static const auto literals = compile_match
+    (
+        pattern(1) = 10,
+        pattern(2) = 20,
+        pattern(3) = 30
+    );
+
+    for (int x = 0; x < 5; ++x)
+        CHECK(literals(x).value_or(0) == (x >= 1 && x <= 3 ? x * 10 : 0));
+
+    static_assert(compile_match(pattern(1) = 10, pattern(_) = 0)(1).value_or(-1) == 10);
+
+    const auto words = compile_match
+    (
+        pattern(sregex("[a-z]+"))  = "word"sv,
+        pattern(sregex("[0-9]+"))  = "number"sv,
+        pattern(_)                 = "other"sv
+    );
+
+    CHECK(words("abc").value_or(""sv) == "word"sv);
+    CHECK(words(std::string("123")).value_or(""sv) == "number"sv);
+    CHECK(words("a1").value_or(""sv) == "other"sv);
+
+    const auto pairs = compile_match(adaptive,
+        pattern(1, 2) = [](int x, int y) { return x + y; },
+        pattern(_, _) = [](int x, int y) { return x * y; }
+    );
+
+    CHECK(pairs(1, 2).value_or(0) == 3);
+    CHECK(pairs(3, 4).value_or(0) == 12);
+
+    int invoked = 0;
+    const auto handlers = compile_match
+    (
+        pattern(1) = [&] { invoked += 1; },
+        pattern(_) = [&] { invoked += 10; }
+    );
+
+    handlers(1);
+    handlers(2);
+    CHECK(invoked == 11);
+}
+
+TEST_CASE("Compiled match copies the values referred to by patterns", "[match][compiled][move]")
+{
+    const movable_copyable first(1);
+    const movable_copyable second(2);
+
+    movable_copyable::reset_counters();
+
+    // Patterns of a match refer to their values
+    CHECK(match(movable_copyable(2))(pattern(in(first, second)) = 1, pattern(_) = 0).value_or(-1) == 1);
+    CHECK(movable_copyable::copy_count == 0);
+
+    const auto compiled = compile_match(pattern(in(first, second)) = 1, pattern(_) = 0);
+    CHECK(movable_copyable::copy_count == 2);
+
+    CHECK(compiled(movable_copyable(1)).value_or(-1) == 1);
+    CHECK(compiled(movable_copyable(3)).value_or(-1) == 0);
+    CHECK(movable_copyable::copy_count == 2);
+}
+
+TEST_CASE("Compiled match copies results", "[match][compiled][move]")
+{
+    movable_copyable::reset_counters();
+
+    const auto compiled = compile_match
+    (
+        pattern("123") = movable_copyable(1),
+        pattern("456") = movable_copyable(2)
+    );
+
+    for (int index = 0; index < 3; ++index)
+    {
+        auto matched_pattern = compiled("456");
+
+        REQUIRE(matched_pattern.has_value());
+        CHECK(matched_pattern->counter == 2);
+    }
+
+    // The stored results are copied once per match and never moved from, so they can be matched again
+    CHECK(movable_copyable::copy_count == 3);
+    CHECK(movable_copyable::move_assign_count == 0);
+
+    auto matched_pattern = compiled("123");
+
+    REQUIRE(matched_pattern.has_value());
+    CHECK(matched_pattern->counter == 1);
+}
+
+//=================================================================================================
+
 namespace {
 consteval bool evaluate_match_if_ten(int x)
 {
@@ -401,218 +593,1759 @@ TEST_CASE("Simple matcher catch none from all same types", "[match][integral]")
 
 //=================================================================================================
 
-TEST_CASE("Simple matcher string literal catch one", "[match][string]")
+namespace {
+enum class opcode : unsigned char
 {
-    int matched_pattern = 0;
+    nop,
+    load,
+    store,
+    jump = 200
+};
 
-    match("12345")
+constexpr int evaluate_literal_jump_table(int x)
+{
+    return match(x)
     (
-        pattern("1"sv)    = [&](auto&& v) { matched_pattern = 1; },
-        pattern("2")      = [&](auto&& v) { matched_pattern = 2; },
-        pattern("12345"s) = [&] { matched_pattern = 3; },
-        pattern(_)        = [&] { matched_pattern = 4; }
-    );
-
-    CHECK(matched_pattern == 3);
+        pattern(lit<1>) = 1,
+        pattern(lit<2>) = 20,
+        pattern(lit<2>) = 21,
+        pattern(lit<3>) = 300,
+        pattern(lit<4>) = 4000,
+        pattern(_)      = -1,
+        pattern(lit<5>) = 50000
+    ).value_or(0);
 }
 
-//=================================================================================================
-
-TEST_CASE("Simple matcher string catch one", "[match][string]")
+constexpr int evaluate_literal_binary_search(long long x)
 {
-    std::string x = "12345";
-    int matched_pattern = 0;
-
-    match(x)
+    return match(x)
     (
-        pattern("1"sv)    = [&](auto&& v) { matched_pattern = 1; },
-        pattern("2"s)     = [&](auto&& v) { matched_pattern = 2; },
-        pattern("12345")  = [&] { matched_pattern = 3; },
-        pattern(_)        = [&] { matched_pattern = 4; }
-    );
-
-    CHECK(matched_pattern == 3);
+        pattern(lit<-1000000>)     = 1,
+        pattern(lit<0>)            = 2,
+        pattern(lit<1000000>)      = 3,
+        pattern(lit<1000000>)      = 4,
+        pattern(lit<1LL << 40>)    = 5
+    ).value_or(0);
 }
 
-//=================================================================================================
-
-TEST_CASE("Simple matcher const char pointer catch one", "[match][string]")
+int evaluate_literal_vector(std::uint64_t x)
 {
-    std::string x = "12345";
-    int matched_pattern = 0;
-
-    match(x.c_str())
+    return match(x)
     (
-        pattern("1"sv)    = [&](auto&& v) { matched_pattern = 1; },
-        pattern("2"s)     = [&](auto&& v) { matched_pattern = 2; },
-        pattern("12345")  = [&] { matched_pattern = 3; },
-        pattern(_)        = [&] { matched_pattern = 4; }
-    );
+        pattern(lit<0x9e3779b97f4a7c15ull>) = 1,
+        pattern(lit<0xdeadbeefull>)         = 2,
+        pattern(lit<404ull>)                = 3,
+        pattern(lit<0xdeadbeefull>)         = 4,
+        pattern(lit<0ull>)                  = 5,
+        pattern(lit<~0ull>)                 = 6,
+        pattern(lit<1ull << 63>)            = 7,
+        pattern(_)                          = -1,
+        pattern(lit<12345ull>)              = 8
+    ).value_or(0);
+}
 
-    CHECK(matched_pattern == 3);
+int evaluate_literal_vector(short x)
+{
+    return match(x)
+    (
+        pattern(lit<-32768>) = 1,
+        pattern(lit<-1>)     = 2,
+        pattern(lit<500>)    = 3,
+        pattern(lit<32767>)  = 4
+    ).value_or(0);
 }
 
-//=================================================================================================
+template <std::size_t... I>
+constexpr int evaluate_literal_many_keys(std::uint64_t x, std::index_sequence<I...>)
+{
+    return match(x)(pattern(lit<I * 1000003ull>) = static_cast<int>(I)...).value_or(-1);
+}
 
-TEST_CASE("Double matcher catch one from all same types", "[match][multi][integral]")
+template <std::size_t... I>
+constexpr int evaluate_literal_constant_results(int x, std::index_sequence<I...>)
 {
-    int x = 42, y = 1337;
+    return match(x)
+    (
+        (pattern(lit<static_cast<int>(I)>) = val<static_cast<int>(I) * 7 + 1>)...,
+        pattern(_) = val<-1>
+    ).value_or(0);
+}
+} // namespace
 
-    {
-        int matched_pattern = 0;
+TEST_CASE("Simple matcher literal jump table", "[match][integral][literal]")
+{
+    static_assert(literal_jump_table_impl<int, decltype(lit<1>), decltype(lit<3>), std::remove_cvref_t<decltype(_)>>::dense);
+    static_assert(not literal_jump_table_impl<int, decltype(lit<1>), decltype(lit<100000>)>::dense);
 
-        match(x, y)
-        (
-            pattern(42, 13370) = [&](auto&& x, auto&& y) { matched_pattern = 1; },
-            pattern(42, _)     = [&](auto&& x, auto&& y) { matched_pattern = 2; },
-            pattern(_, 1337)   = [&] { matched_pattern = 3; },
-            pattern(_, _)      = [&] { matched_pattern = 4; }
-        );
+    static_assert(evaluate_literal_jump_table(2) == 20);
+    static_assert(evaluate_literal_jump_table(5) == -1);
+    static_assert(evaluate_literal_binary_search(1000000) == 3);
+    static_assert(evaluate_literal_binary_search(1LL << 40) == 5);
+    static_assert(evaluate_literal_binary_search(7) == 0);
 
-        CHECK(matched_pattern == 2);
+    static_assert(literal_jump_table_impl<long long, decltype(lit<0>), decltype(lit<1LL << 40>)>::vectorized);
+    static_assert(evaluate_literal_many_keys(129 * 1000003ull, std::make_index_sequence<130>{}) == 129);
 
-        static_assert(match(42, 1337)
+    for (std::uint64_t x : { 0x9e3779b97f4a7c15ull, 0xdeadbeefull, 404ull, 0ull, ~0ull, 1ull << 63, 12345ull, 405ull, 0xdeadbeeeull })
+    {
+        const int expected = match(x)
         (
-            pattern(42, 13370) = [](auto&&, auto&&) { return 1; },
-            pattern(42, _)     = [](auto&&, auto&&) { return 2; },
-            pattern(_, 1337)   = [] { return 3; },
-            pattern(_, _)      = [] { return 4; }
-        ).value_or(0) == 2);
+            pattern(0x9e3779b97f4a7c15ull) = 1,
+            pattern(0xdeadbeefull)         = 2,
+            pattern(404ull)                = 3,
+            pattern(0ull)                  = 5,
+            pattern(~0ull)                 = 6,
+            pattern(1ull << 63)            = 7,
+            pattern(_)                     = -1
+        ).value_or(0);
+
+        CHECK(evaluate_literal_vector(x) == expected);
     }
 
+    CHECK(evaluate_literal_vector(short(-32768)) == 1);
+    CHECK(evaluate_literal_vector(short(-1)) == 2);
+    CHECK(evaluate_literal_vector(short(500)) == 3);
+    CHECK(evaluate_literal_vector(short(32767)) == 4);
+    CHECK(evaluate_literal_vector(short(0)) == 0);
+
+    CHECK(evaluate_literal_many_keys(0, std::make_index_sequence<130>{}) == 0);
+    CHECK(evaluate_literal_many_keys(77 * 1000003ull, std::make_index_sequence<130>{}) == 77);
+    CHECK(evaluate_literal_many_keys(1, std::make_index_sequence<130>{}) == -1);
+
+    static_assert(evaluate_literal_constant_results(299, std::make_index_sequence<300>{}) == 299 * 7 + 1);
+    CHECK(evaluate_literal_constant_results(0, std::make_index_sequence<300>{}) == 1);
+    CHECK(evaluate_literal_constant_results(257, std::make_index_sequence<300>{}) == 257 * 7 + 1);
+    CHECK(evaluate_literal_constant_results(300, std::make_index_sequence<300>{}) == -1);
+    CHECK(evaluate_literal_constant_results(-5, std::make_index_sequence<300>{}) == -1);
+
     {
-        int matched_pattern = 0;
+        int x = 2;
 
-        match(x, y)
+        auto matched_pattern = match_exhaustive(x)
         (
-            pattern(42, 1337)  = [&](auto&& x, auto&& y) { matched_pattern = 1; },
-            pattern(42, _)     = [&](auto&& v, auto&& y) { matched_pattern = 2; },
-            pattern(_, 1337)   = [&] { matched_pattern = 3; },
-            pattern(_, _)      = [&] { matched_pattern = 4; }
+            pattern(lit<1>) = val<10>,
+            pattern(lit<2>) = val<20>,
+            pattern(_)      = val<0>
         );
 
-        CHECK(matched_pattern == 1);
+        static_assert(std::same_as<decltype(matched_pattern), int>);
+        CHECK(matched_pattern == 20);
+    }
 
-        static_assert(match(42, 1337)
+    for (int x : { -10, 0, 1, 2, 3, 4, 5, 6, 1000 })
+    {
+        const int expected = match(x)
         (
-            pattern(42, 1337) = [](auto&&, auto&&) { return 1; },
-            pattern(42, _)    = [](auto&&, auto&&) { return 2; },
-            pattern(_, 1337)  = [] { return 3; },
-            pattern(_, _)     = [] { return 4; }
-        ).value_or(0) == 1);
+            pattern(1) = 1,
+            pattern(2) = 20,
+            pattern(3) = 300,
+            pattern(4) = 4000,
+            pattern(_) = -1
+        ).value_or(0);
+
+        CHECK(evaluate_literal_jump_table(x) == expected);
     }
 
     {
-        int matched_pattern = 0;
+        unsigned char x = 44;
 
-        match(x, y)
+        auto matched_pattern = match(x)
         (
-            pattern(420, 1337) = [&](auto&& x, auto&& y) { matched_pattern = 1; },
-            pattern(420, _)    = [&](auto&& x, auto&& y) { matched_pattern = 2; },
-            pattern(_, 1337)   = [&] { matched_pattern = 3; },
-            pattern(_, _)      = [&] { matched_pattern = 4; }
+            pattern(lit<300>) = 1,
+            pattern(lit<44>)  = 2,
+            pattern(_)        = 3
         );
 
-        CHECK(matched_pattern == 3);
-
-        static_assert(match(42, 1337)
-        (
-            pattern(420, 1337) = [](auto&&, auto&&) { return 1; },
-            pattern(420, _)    = [](auto&&, auto&&) { return 2; },
-            pattern(_, 1337)   = [] { return 3; },
-            pattern(_, _)      = [] { return 4; }
-        ).value_or(0) == 3);
+        CHECK(matched_pattern.value_or(0) == 2);
     }
 
     {
+        opcode x = opcode::jump;
         int matched_pattern = 0;
 
-        match(x, y)
+        match(x)
         (
-            pattern(420, 13370) = [&](auto&& x, auto&& y) { matched_pattern = 1; },
-            pattern(420, _)     = [&](auto&& x, auto&& y) { matched_pattern = 2; },
-            pattern(_, 13370)   = [&] { matched_pattern = 3; },
-            pattern(_, _)       = [&] { matched_pattern = 4; }
+            pattern(lit<opcode::nop>)   = [&] { matched_pattern = 1; },
+            pattern(lit<opcode::load>)  = [&] { matched_pattern = 2; },
+            pattern(lit<opcode::store>) = [&] { matched_pattern = 3; },
+            pattern(lit<opcode::jump>)  = [&](auto&& v) { matched_pattern = v == opcode::jump ? 4 : 5; }
         );
 
         CHECK(matched_pattern == 4);
-
-        static_assert(match(42, 1337)
-        (
-            pattern(420, 13370) = [](auto&&, auto&&) { return 1; },
-            pattern(420, _)     = [](auto&&, auto&&) { return 2; },
-            pattern(_, 13370)   = [] { return 3; },
-            pattern(_, _)       = [] { return 4; }
-        ).value_or(0) == 4);
     }
-}
-
-//=================================================================================================
-
-TEST_CASE("Simple matcher range", "[match][range]")
-{
-    int x = 12;
 
     {
+        int x = 42;
         int matched_pattern = 0;
 
         match(x)
         (
-            pattern(range(1, 124)) = [&] { matched_pattern = 1; },
-            pattern(_)             = [&] { matched_pattern = 2; }
+            pattern(lit<1>) = [&] { matched_pattern = 1; },
+            pattern(lit<2>) = [&] { matched_pattern = 2; }
         );
 
-        CHECK(matched_pattern == 1);
-
-        static_assert(match(12)
-        (
-            pattern(range(1, 124)) = 1,
-            pattern(_)             = 2
-        ).value_or(0) == 1);
+        CHECK(matched_pattern == 0);
     }
 
     {
-        int matched_pattern = 0;
+        int x = 3;
 
-        match(x)
+        auto matched_pattern = match(x)
         (
-            pattern(range(1, 11)) = [&] { matched_pattern = 1; },
-            pattern(_)            = [&] { matched_pattern = 2; }
+            pattern(lit<1>) = [](int v) { return v * 10; },
+            pattern(lit<3>) = [](int v) { return v * 100; },
+            pattern(_)      = [] { return -1; }
         );
 
-        CHECK(matched_pattern == 2);
-
-        static_assert(match(12)
-        (
-            pattern(range(1, 11)) = 1,
-            pattern(_)            = 2
-        ).value_or(0) == 2);
+        CHECK(matched_pattern.value_or(0) == 300);
     }
 
     {
-        int matched_pattern = 0;
+        int x = 3;
 
-        match(x)
+        auto matched_pattern = match(x)
         (
-            pattern(range(13, 124)) = [&] { matched_pattern = 1; },
-            pattern(_)              = [&] { matched_pattern = 2; }
+            pattern(lit<1> || lit<3>) = 1,
+            pattern(_x > 2)           = 2,
+            pattern(_)                = 3
         );
 
-        CHECK(matched_pattern == 2);
-
-        static_assert(match(12)
-        (
-            pattern(range(13, 1124)) = 1,
-            pattern(_)               = 2
-        ).value_or(0) == 2);
+        CHECK(matched_pattern.value_or(0) == 1);
     }
 }
 
 //=================================================================================================
 
-TEST_CASE("Simple matcher in", "[match][in]")
+namespace {
+template <std::size_t... I>
+constexpr auto match_all_overlapping_intervals(int x, std::index_sequence<I...>)
 {
-    int x = 4;
+    return match_all(x)(pattern(lit_range<static_cast<int>(I) * 3, static_cast<int>(I) * 3 + 9>) = static_cast<int>(I)...);
+}
+} // namespace
+
+TEST_CASE("Match all", "[match][all]")
+{
+    static_assert(arm_bounds_table<int, decltype(lit_range<0, 9>), decltype(lit<20>), decltype(_), decltype(lit<5L>)>::bounded_count == 3);
+    static_assert(not arm_bounds_table<int, decltype(_x < 3), decltype(lit<1>), decltype(lit<2>), decltype(lit<3>)>::applicable);
+
+    static_assert(match_all(5)(pattern(lit<5>) = 1, pattern(_x > 9) = 2, pattern(_) = 3).to_ullong() == 0b101);
+
+    for (int x = -3; x <= 20; ++x)
+    {
+        const auto mask = match_all(x)
+        (
+            pattern(_x < 0)                = 0,
+            pattern(lit<0>)                = 1,
+            pattern(lit_range<0, 9>)       = 2,
+            pattern(in(1, 2, 3))           = 3,
+            pattern(lit_range<5, 15>)      = 4,
+            pattern((_x & 1) == 0)         = 5,
+            pattern(lit<12>)               = 6,
+            pattern([](int v) { return v % 5 == 0; }) = 7,
+            pattern(_)                     = 8
+        );
+
+        const std::array<bool, 9> expected = {
+            x < 0, x == 0, x >= 0 && x <= 9, x >= 1 && x <= 3, x >= 5 && x <= 15, (x & 1) == 0, x == 12, x % 5 == 0, true
+        };
+
+        for (std::size_t arm = 0; arm < expected.size(); ++arm)
+            CHECK(mask.test(arm) == expected[arm]);
+
+        CHECK(mask.count() == static_cast<std::size_t>(std::count(expected.begin(), expected.end(), true)));
+        CHECK(mask.first() == static_cast<std::size_t>(std::find(expected.begin(), expected.end(), true) - expected.begin()));
+    }
+
+    // Wider than a word, each arm covering the subjects of the next three
+    for (const int x : { -1, 0, 3, 190, 205, 209, 210, 400 })
+    {
+        const auto mask = match_all_overlapping_intervals(x, std::make_index_sequence<70>{});
+
+        CHECK(mask.size() == 70);
+
+        for (std::size_t arm = 0; arm < 70; ++arm)
+            CHECK(mask.test(arm) == (x >= static_cast<int>(arm) * 3 && x <= static_cast<int>(arm) * 3 + 9));
+    }
+
+    {
+        std::vector<int> invoked;
+        int x = 4, y = 7;
+
+        const auto mask = match_all(x, y).invoke
+        (
+            pattern(_x > 5, _)       = [&] { invoked.push_back(0); },
+            pattern(_, _y > 5)       = [&](int a, int b) { invoked.push_back(a + b); },
+            pattern(lit<4>, lit<7>)  = [&] { invoked.push_back(2); },
+            pattern(_, _)            = [&](int a, int) { invoked.push_back(a); }
+        );
+
+        CHECK(mask.to_ullong() == 0b1110);
+        CHECK((invoked == std::vector<int>{ 11, 2, 4 }));
+
+        std::vector<std::size_t> arms;
+        mask.for_each([&](std::size_t arm) { arms.push_back(arm); });
+
+        CHECK((arms == std::vector<std::size_t>{ 1, 2, 3 }));
+    }
+
+    // Unsigned and narrow subjects are biased to signed lanes, wider ones compared one by one
+    const auto check_widths = []<class T>(T x)
+    {
+        const auto mask = match_all(x)
+        (
+            pattern(lit_range<T(0), T(10)>)                            = 0,
+            pattern(lit_range<T(100), std::numeric_limits<T>::max()>)  = 1,
+            pattern(lit<std::numeric_limits<T>::min()>)                = 2,
+            pattern(lit<T(5)>)                                         = 3,
+            pattern(_)                                                 = 4
+        );
+
+        static_assert(match_all_bounds<type_list<T>, decltype(pattern(lit<T(5)>) = 3)>::bounded[0]);
+
+        return mask.to_ullong();
+    };
+
+    CHECK(check_widths(std::uint8_t(5)) == 0b11001);
+    CHECK(check_widths(std::uint8_t(255)) == 0b10010);
+    CHECK(check_widths(std::int16_t(-32768)) == 0b10100);
+    CHECK(check_widths(std::int16_t(7)) == 0b10001);
+    CHECK(check_widths(4000000000u) == 0b10010);
+    CHECK(check_widths(0u) == 0b10101);
+    CHECK(check_widths(std::numeric_limits<std::int64_t>::max()) == 0b10010);
+    CHECK(check_widths(std::int64_t(5)) == 0b11001);
+
+    CHECK(match_all("beta"sv)(pattern("alpha") = 1, pattern(_) = 2).to_ullong() == 0b10);
+    CHECK(match_all(std::string("beta")).invoke(pattern("alpha") = [] {}, pattern("beta") = [] {}).to_ullong() == 0b10);
+}
+
+//=================================================================================================
+
+namespace {
+constexpr std::size_t evaluate_index(int x)
+{
+    return match_index(x)
+    (
+        pattern(_x < 0),
+        pattern(lit<0>),
+        pattern(in(1, 2, 3)),
+        pattern(range(4, 10)),
+        pattern((_x & 1) == 0)
+    );
+}
+
+template <std::size_t... I>
+constexpr std::size_t evaluate_index_literals(int x, std::index_sequence<I...>)
+{
+    return match_index(x)(pattern(lit<static_cast<int>(I) * 2>)...);
+}
+} // namespace
+
+TEST_CASE("Match index", "[match][index]")
+{
+    static_assert(evaluate_index(-5) == 0);
+    static_assert(evaluate_index(0) == 1);
+    static_assert(evaluate_index(12) == 4);
+    static_assert(evaluate_index(13) == 5);
+
+    static_assert(std::same_as<decltype(match_index(1)(pattern(_))), std::size_t>);
+
+    for (int x = -3; x <= 16; ++x)
+    {
+        const auto expected = match(x)
+        (
+            pattern(_x < 0)            = std::size_t(0),
+            pattern(lit<0>)            = std::size_t(1),
+            pattern(in(1, 2, 3))       = std::size_t(2),
+            pattern(range(4, 10))      = std::size_t(3),
+            pattern((_x & 1) == 0)     = std::size_t(4)
+        ).value_or(5);
+
+        CHECK(evaluate_index(x) == expected);
+        CHECK(match_index(branchless, x)(pattern(_x < 0), pattern(lit<0>), pattern(range(4, 10)), pattern(_)) == (x < 0 ? 0u : x == 0 ? 1u : x <= 10 && x >= 4 ? 2u : 3u));
+    }
+
+    // Literal arms go through the jump table
+    static_assert(literal_jump_table<int, decltype(lit<0>), decltype(lit<2>), decltype(lit<4>)>::applicable);
+
+    CHECK(evaluate_index_literals(0, std::make_index_sequence<32>{}) == 0);
+    CHECK(evaluate_index_literals(62, std::make_index_sequence<32>{}) == 31);
+    CHECK(evaluate_index_literals(3, std::make_index_sequence<32>{}) == 32);
+
+    const std::string text = "beta";
+    CHECK(match_index(text, 2)(pattern("alpha", _), pattern("beta", lit<1>), pattern("beta", _)) == 2);
+    CHECK(match_index(std::string_view("gamma"))(pattern("alpha"), pattern("beta")) == 2);
+}
+
+//=================================================================================================
+
+namespace {
+enum class suit : unsigned char
+{
+    clubs,
+    diamonds,
+    hearts,
+    spades
+};
+} // namespace
+
+template <>
+struct ptm::domain_range<suit>
+{
+    inline static constexpr suit first = suit::clubs;
+    inline static constexpr suit last = suit::spades;
+};
+
+namespace {
+struct square { int side = 0; };
+struct disc { int radius = 0; };
+
+using figure = std::variant<square, disc, std::monostate>;
+
+constexpr int evaluate_figure(const figure& x)
+{
+    return match_exhaustive(x)
+    (
+        pattern(typed<square>)         = [](const figure& f) { return std::get<square>(f).side * std::get<square>(f).side; },
+        pattern(typed<disc>)           = [](const figure& f) { return 3 * std::get<disc>(f).radius * std::get<disc>(f).radius; },
+        pattern(typed<std::monostate>) = 0
+    );
+}
+
+constexpr int evaluate_suit(suit x)
+{
+    return match_exhaustive(x)
+    (
+        pattern(lit<suit::clubs>)    = 1,
+        pattern(lit<suit::diamonds>) = 2,
+        pattern(lit<suit::hearts>)   = 2,
+        pattern(lit<suit::spades>)   = 3
+    );
+}
+
+constexpr int evaluate_figures(const figure& a, const figure& b)
+{
+    return match_exhaustive(a, b)
+    (
+        pattern(typed<square>, typed<square>) = 1,
+        pattern(typed<disc>, _)               = 2,
+        pattern(_, typed<disc>)               = 3,
+        pattern(typed<std::monostate>, _)     = 4,
+        pattern(_, typed<std::monostate>)     = 5
+    );
+}
+} // namespace
+
+TEST_CASE("Match exhaustive", "[match][exhaustive]")
+{
+    using square_pattern = std::remove_cvref_t<decltype(typed<square>)>;
+    using disc_pattern = std::remove_cvref_t<decltype(typed<disc>)>;
+    using empty_pattern = std::remove_cvref_t<decltype(typed<std::monostate>)>;
+    using wildcard_pattern = std::remove_cvref_t<decltype(_)>;
+
+    static_assert(exhaustive_arms<std::tuple<figure>, std::tuple<square_pattern>, std::tuple<disc_pattern>, std::tuple<empty_pattern>>::value);
+    static_assert(not exhaustive_arms<std::tuple<figure>, std::tuple<square_pattern>, std::tuple<disc_pattern>>::value);
+    static_assert(exhaustive_arms<std::tuple<figure>, std::tuple<square_pattern>, std::tuple<wildcard_pattern>>::value);
+    static_assert(exhaustive_arms<std::tuple<int, std::string>, std::tuple<wildcard_pattern, wildcard_pattern>>::value);
+    static_assert(not exhaustive_arms<std::tuple<figure, figure>, std::tuple<square_pattern, wildcard_pattern>, std::tuple<wildcard_pattern, disc_pattern>>::value);
+    static_assert(exhaustive_arms<std::tuple<bool>, std::tuple<std::remove_cvref_t<decltype(lit<true>)>>, std::tuple<std::remove_cvref_t<decltype(lit<false>)>>>::value);
+    static_assert(not exhaustive_arms<std::tuple<suit>, std::tuple<std::remove_cvref_t<decltype(lit<suit::clubs>)>>>::value);
+
+    // Results are returned as is, without a std::optional around them
+    static_assert(std::same_as<decltype(evaluate_figure(figure{})), int>);
+    static_assert(std::same_as<decltype(match_exhaustive(1)(pattern(lit<1>) = 1.0, pattern(_) = 2)), double>);
+
+    static_assert(evaluate_figure(square{ 3 }) == 9);
+    static_assert(evaluate_suit(suit::hearts) == 2);
+
+    CHECK(evaluate_figure(square{ 3 }) == 9);
+    CHECK(evaluate_figure(disc{ 2 }) == 12);
+    CHECK(evaluate_figure(std::monostate{}) == 0);
+
+    CHECK(evaluate_suit(suit::clubs) == 1);
+    CHECK(evaluate_suit(suit::diamonds) == 2);
+    CHECK(evaluate_suit(suit::hearts) == 2);
+    CHECK(evaluate_suit(suit::spades) == 3);
+
+    CHECK(evaluate_figures(square{}, square{}) == 1);
+    CHECK(evaluate_figures(disc{}, square{}) == 2);
+    CHECK(evaluate_figures(square{}, disc{}) == 3);
+    CHECK(evaluate_figures(std::monostate{}, square{}) == 4);
+    CHECK(evaluate_figures(square{}, std::monostate{}) == 5);
+
+    // Arms checked in order, the last one taken when no other matched
+    for (int x = -2; x <= 12; ++x)
+    {
+        const int expected = x < 0 ? 0 : x <= 9 ? 1 : 2;
+
+        CHECK(match_exhaustive(x)(pattern(_x < 0) = 0, pattern(range(0, 9)) = 1, pattern(_) = 2) == expected);
+        CHECK(match_exhaustive(branchless, x)(pattern(lit_range<std::numeric_limits<int>::min(), -1>) = 0, pattern(lit_range<0, 9>) = 1, pattern(_) = 2) == expected);
+    }
+
+    int calls = 0;
+    match_exhaustive(std::string("beta"))(pattern("alpha") = [&] { calls += 1; }, pattern(_) = [&] { calls += 10; });
+    CHECK(calls == 10);
+
+    const std::string text = "alpha";
+    CHECK(match_exhaustive(text)(pattern("alpha") = std::string("first"), pattern(_) = std::string("other")) == "first");
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_heat(int x)
+{
+    return match(outlined, x)
+    (
+        pattern(lit<0>).hot()   = [](int v) { return v + 100; },
+        pattern(range(1, 9))    = [](int v) { return v * 2; },
+        pattern(lit<10>)        = 3,
+        pattern(_x < 0).cold()  = [](int v) { return -v; },
+        pattern(_).cold()       = -1
+    ).value_or(0);
+}
+} // namespace
+
+TEST_CASE("Match outlined handlers", "[match][outlined]")
+{
+    constexpr auto handler = [](int v) { return v; };
+
+    using hot_matcher = std::remove_cvref_t<decltype(pattern(_).hot() = handler)>;
+    using cold_matcher = std::remove_cvref_t<decltype(pattern(_).cold() = handler)>;
+    using value_matcher = std::remove_cvref_t<decltype(pattern(_).cold() = 1)>;
+    using plain_matcher = std::remove_cvref_t<decltype(pattern(_) = handler)>;
+
+    static_assert(arm_heat_v<matcher_traits<hot_matcher>::result_type> == arm_heat::hot);
+    static_assert(arm_heat_v<matcher_traits<cold_matcher>::result_type> == arm_heat::cold);
+    static_assert(std::same_as<matcher_traits<value_matcher>::result_type, int>);
+    static_assert(arm_heat_v<matcher_traits<plain_matcher>::result_type> == arm_heat::automatic);
+
+    static_assert(outlined_arm_v<outlined_policy, plain_matcher>);
+    static_assert(not outlined_arm_v<outlined_policy, hot_matcher>);
+    static_assert(not outlined_arm_v<outlined_policy, cold_matcher>);
+    static_assert(not outlined_arm_v<outlined_policy, value_matcher>);
+    static_assert(not outlined_arm_v<default_policy, plain_matcher>);
+
+    static_assert(evaluate_heat(0) == 100);
+    static_assert(evaluate_heat(-4) == 4);
+
+    for (int x = -3; x <= 12; ++x)
+    {
+        const int expected = x == 0 ? 100 : x >= 1 && x <= 9 ? x * 2 : x == 10 ? 3 : x < 0 ? -x : -1;
+
+        CHECK(evaluate_heat(x) == expected);
+    }
+
+    // Handlers kept by reference, returning nothing, or reused by a compiled match
+    int calls = 0;
+    const auto count = [&] { ++calls; };
+
+    for (int x = 0; x < 4; ++x)
+        match(outlined, x)(pattern(lit<1>) = count, pattern(lit<2>).cold() = count, pattern(_).hot() = [&] { calls += 10; });
+
+    CHECK(calls == 22);
+
+    static const auto compiled = compile_match
+    (
+        outlined,
+        pattern("alpha")       = [](std::string_view s) { return s.size(); },
+        pattern(_).cold()      = [](std::string_view) { return std::size_t(0); }
+    );
+
+    CHECK(compiled(std::string_view("alpha")).value_or(99) == 5);
+    CHECK(compiled(std::string_view("beta")).value_or(99) == 0);
+
+    CHECK(match_exhaustive(outlined, 7)(pattern(lit<7>) = [] { return 1; }, pattern(_).cold() = [] { return 2; }) == 1);
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_literal_intervals(int x)
+{
+    return match(x)
+    (
+        pattern(lit_range<0, 9>)    = 1,
+        pattern(lit_range<5, 19>)   = 2,
+        pattern(lit<25>)            = 3,
+        pattern(lit_range<20, 99>)  = 4,
+        pattern(lit_range<-50, -1>) = 5,
+        pattern(_)                  = -1,
+        pattern(lit<200>)           = 6
+    ).value_or(0);
+}
+
+int evaluate_literal_intervals(unsigned char x)
+{
+    return match(x)
+    (
+        pattern(lit_range<0, 0>)     = 1,
+        pattern(lit_range<200, 255>) = 2,
+        pattern(lit<100>)            = 3
+    ).value_or(0);
+}
+
+int evaluate_literal_intervals(long long x)
+{
+    return match(x)
+    (
+        pattern(lit_range<std::numeric_limits<long long>::min(), -1LL>) = 1,
+        pattern(lit_range<1LL << 40, std::numeric_limits<long long>::max()>) = 2
+    ).value_or(0);
+}
+
+template <std::size_t... I>
+constexpr int evaluate_literal_many_intervals(int x, std::index_sequence<I...>)
+{
+    return match(x)(pattern(lit_range<static_cast<int>(I) * 10, static_cast<int>(I) * 10 + 9>) = static_cast<int>(I)...).value_or(-1);
+}
+} // namespace
+
+TEST_CASE("Simple matcher literal interval table", "[match][integral][literal]")
+{
+    static_assert(literal_interval_table<int, decltype(lit_range<0, 9>), decltype(lit<20>)>::applicable);
+    static_assert(not literal_interval_table<double, decltype(lit_range<0, 9>)>::applicable);
+    static_assert(literal_interval_table_impl<int, decltype(lit_range<0, 9>), decltype(lit_range<10, 19>), decltype(lit_range<30, 39>)>::segment_count == 6);
+
+    static_assert(evaluate_literal_intervals(7) == 1);
+    static_assert(evaluate_literal_intervals(12) == 2);
+    static_assert(evaluate_literal_intervals(200) == -1);
+    static_assert(evaluate_literal_many_intervals(4009, std::make_index_sequence<500>{}) == 400);
+    static_assert(evaluate_literal_many_intervals(5000, std::make_index_sequence<500>{}) == -1);
+
+    for (int x = -60; x <= 210; ++x)
+    {
+        const int expected = match(x)
+        (
+            pattern(range(0, 9))    = 1,
+            pattern(range(5, 19))   = 2,
+            pattern(25)             = 3,
+            pattern(range(20, 99))  = 4,
+            pattern(range(-50, -1)) = 5,
+            pattern(_)              = -1,
+            pattern(200)            = 6
+        ).value_or(0);
+
+        CHECK(evaluate_literal_intervals(x) == expected);
+    }
+
+    CHECK(evaluate_literal_intervals(std::numeric_limits<int>::min()) == -1);
+    CHECK(evaluate_literal_intervals(std::numeric_limits<int>::max()) == -1);
+
+    CHECK(evaluate_literal_intervals(static_cast<unsigned char>(0)) == 1);
+    CHECK(evaluate_literal_intervals(static_cast<unsigned char>(1)) == 0);
+    CHECK(evaluate_literal_intervals(static_cast<unsigned char>(100)) == 3);
+    CHECK(evaluate_literal_intervals(static_cast<unsigned char>(199)) == 0);
+    CHECK(evaluate_literal_intervals(static_cast<unsigned char>(255)) == 2);
+
+    CHECK(evaluate_literal_intervals(std::numeric_limits<long long>::min()) == 1);
+    CHECK(evaluate_literal_intervals(-1LL) == 1);
+    CHECK(evaluate_literal_intervals(0LL) == 0);
+    CHECK(evaluate_literal_intervals((1LL << 40) - 1) == 0);
+    CHECK(evaluate_literal_intervals(std::numeric_limits<long long>::max()) == 2);
+
+    for (int x : { -1, 0, 9, 10, 2345, 4999, 5000 })
+        CHECK(evaluate_literal_many_intervals(x, std::make_index_sequence<500>{}) == (x >= 0 && x < 5000 ? x / 10 : -1));
+
+    {
+        int x = 15;
+
+        auto matched_pattern = match(x)
+        (
+            pattern(lit_range<10, 20>) = [](int v) { return v * 2; },
+            pattern(_)                 = [] { return -1; }
+        );
+
+        CHECK(matched_pattern.value_or(0) == 30);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher string literal catch one", "[match][string]")
+{
+    int matched_pattern = 0;
+
+    match("12345")
+    (
+        pattern("1"sv)    = [&](auto&& v) { matched_pattern = 1; },
+        pattern("2")      = [&](auto&& v) { matched_pattern = 2; },
+        pattern("12345"s) = [&] { matched_pattern = 3; },
+        pattern(_)        = [&] { matched_pattern = 4; }
+    );
+
+    CHECK(matched_pattern == 3);
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher string catch one", "[match][string]")
+{
+    std::string x = "12345";
+    int matched_pattern = 0;
+
+    match(x)
+    (
+        pattern("1"sv)    = [&](auto&& v) { matched_pattern = 1; },
+        pattern("2"s)     = [&](auto&& v) { matched_pattern = 2; },
+        pattern("12345")  = [&] { matched_pattern = 3; },
+        pattern(_)        = [&] { matched_pattern = 4; }
+    );
+
+    CHECK(matched_pattern == 3);
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher const char pointer catch one", "[match][string]")
+{
+    std::string x = "12345";
+    int matched_pattern = 0;
+
+    match(x.c_str())
+    (
+        pattern("1"sv)    = [&](auto&& v) { matched_pattern = 1; },
+        pattern("2"s)     = [&](auto&& v) { matched_pattern = 2; },
+        pattern("12345")  = [&] { matched_pattern = 3; },
+        pattern(_)        = [&] { matched_pattern = 4; }
+    );
+
+    CHECK(matched_pattern == 3);
+}
+
+//=================================================================================================
+
+namespace {
+enum class channel : int
+{
+    red,
+    green,
+    blue,
+    alpha = 10
+};
+} // namespace
+
+template <>
+struct ptm::domain_range<channel>
+{
+    inline static constexpr channel first = channel::red;
+    inline static constexpr channel last = channel::alpha;
+};
+
+namespace {
+bool is_runtime_vowel(char c)
+{
+    return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u';
+}
+
+constexpr int evaluate_character_class(char x)
+{
+    return match(x)
+    (
+        pattern([](char c) { return c >= '0' && c <= '9'; }) = 1,
+        pattern(lit_range<'a', 'f'>)                          = 2,
+        pattern([](char c) { return c >= 'a' && c <= 'z'; }) = 3,
+        pattern(lit<' '>)                                     = 4,
+        pattern(lit<'0'>)                                     = 5,
+        pattern(_)                                            = 0
+    ).value_or(-1);
+}
+
+int evaluate_signed_bytes(std::int8_t x)
+{
+    return match(x)
+    (
+        pattern(lit<-128>)                           = 1,
+        pattern([](std::int8_t v) { return v < 0; }) = 2,
+        pattern(lit_range<0, 10>)                    = 3,
+        pattern(lit<127>)                            = 4
+    ).value_or(0);
+}
+
+int evaluate_channel(channel x)
+{
+    return match(x)
+    (
+        pattern(lit<channel::red>)                             = 1,
+        pattern([](channel c) { return c != channel::green; }) = 2,
+        pattern(_)                                             = 3
+    ).value_or(0);
+}
+} // namespace
+
+TEST_CASE("Simple matcher small domain table", "[match][domain]")
+{
+    using digit_pattern = decltype([](char c) { return c >= '0' && c <= '9'; });
+    using runtime_pattern = decltype([](char c) { return is_runtime_vowel(c); });
+    using wildcard_pattern = std::remove_cvref_t<decltype(_)>;
+
+    static_assert(literal_domain_table<char, digit_pattern, wildcard_pattern>::applicable);
+    static_assert(literal_domain_table<bool, std::remove_cvref_t<decltype(lit<true>)>>::applicable);
+    static_assert(not literal_domain_table<char, runtime_pattern, wildcard_pattern>::applicable);
+    static_assert(not literal_domain_table<int, std::remove_cvref_t<decltype(lit<1>)>>::applicable);
+    static_assert(literal_domain_table<channel, std::remove_cvref_t<decltype(lit<channel::red>)>>::applicable);
+
+    static_assert(evaluate_character_class('7') == 1);
+    static_assert(evaluate_character_class('c') == 2);
+    static_assert(evaluate_character_class('x') == 3);
+    static_assert(evaluate_character_class('0') == 1);
+    static_assert(evaluate_character_class('#') == 0);
+
+    for (int c = -128; c < 128; ++c)
+    {
+        const char x = static_cast<char>(c);
+        const int expected = (x >= '0' && x <= '9') ? 1 : (x >= 'a' && x <= 'f') ? 2 : (x >= 'a' && x <= 'z') ? 3 : x == ' ' ? 4 : 0;
+
+        CHECK(evaluate_character_class(x) == expected);
+    }
+
+    CHECK(evaluate_signed_bytes(-128) == 1);
+    CHECK(evaluate_signed_bytes(-1) == 2);
+    CHECK(evaluate_signed_bytes(0) == 3);
+    CHECK(evaluate_signed_bytes(11) == 0);
+    CHECK(evaluate_signed_bytes(127) == 4);
+
+    CHECK(evaluate_channel(channel::red) == 1);
+    CHECK(evaluate_channel(channel::green) == 3);
+    CHECK(evaluate_channel(channel::alpha) == 2);
+    CHECK(evaluate_channel(static_cast<channel>(5)) == 2);
+    CHECK(evaluate_channel(static_cast<channel>(-1)) == 2);
+    CHECK(evaluate_channel(static_cast<channel>(1000)) == 2);
+
+    for (char x : { 'a', 'b', 'e', 'z' })
+    {
+        auto matched_pattern = match(x)
+        (
+            pattern([](char c) { return is_runtime_vowel(c); }) = 1,
+            pattern(_)                                          = 2
+        );
+
+        CHECK(matched_pattern.value_or(0) == (is_runtime_vowel(x) ? 1 : 2));
+    }
+
+    {
+        bool x = false;
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(lit<true>)  = [&] { matched_pattern = 1; },
+            pattern(lit<false>) = [&](bool v) { matched_pattern = v ? 3 : 2; }
+        );
+
+        CHECK(matched_pattern == 2);
+    }
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_literal_strings(std::string_view x)
+{
+    return match(x)
+    (
+        pattern(lit_str<"GET">)     = 1,
+        pattern(lit_str<"POST">)    = 2,
+        pattern(lit_str<"PUT">)     = 3,
+        pattern(lit_str<"GET">)     = 4,
+        pattern(lit_str<"DELETE">)  = 5,
+        pattern(lit_str<"">)        = 6,
+        pattern(lit_str<"OPTIONS">) = 7,
+        pattern(sized(4))           = 8,
+        pattern(_)                  = -1,
+        pattern(lit_str<"PATCH">)   = 9
+    ).value_or(0);
+}
+
+template <std::size_t I>
+constexpr auto generated_keyword()
+{
+    fixed_string<4> result("___");
+    result.data[0] = static_cast<char>('a' + I % 26);
+    result.data[1] = static_cast<char>('a' + I / 26 % 26);
+    result.data[2] = static_cast<char>('a' + I / 676 % 26);
+    return result;
+}
+
+template <std::size_t... I>
+constexpr int evaluate_literal_many_strings(std::string_view x, std::index_sequence<I...>)
+{
+    return match(x)(pattern(lit_str<generated_keyword<I>()>) = static_cast<int>(I)...).value_or(-1);
+}
+} // namespace
+
+TEST_CASE("Simple matcher string literal perfect hash", "[match][string][literal]")
+{
+    static_assert(literal_string_table<std::string_view, decltype(lit_str<"a">), decltype(lit_str<"b">), decltype(lit_str<"c">), decltype(lit_str<"d">)>::applicable);
+    static_assert(not literal_string_table<std::string_view, decltype(lit_str<"a">), decltype(lit_str<"b">)>::applicable);
+    static_assert(not literal_string_table<int, decltype(lit<1>), decltype(lit<2>), decltype(lit<3>), decltype(lit<4>)>::applicable);
+
+    static_assert(evaluate_literal_strings("GET") == 1);
+    static_assert(evaluate_literal_strings("HEAD") == 8);
+    static_assert(evaluate_literal_strings("PATCH") == -1);
+    static_assert(evaluate_literal_many_strings("xyz", std::make_index_sequence<100>{}) == -1);
+    static_assert(evaluate_literal_many_strings("vcb", std::make_index_sequence<100>{}) == -1);
+    static_assert(evaluate_literal_many_strings("vda", std::make_index_sequence<100>{}) == 99);
+
+    for (std::string_view x : { "GET", "POST", "PUT", "DELETE", "", "OPTIONS", "HEAD", "PATCH", "GETS", "GE", "get", "CONNECT" })
+    {
+        const int expected = match(x)
+        (
+            pattern("GET")     = 1,
+            pattern("POST")    = 2,
+            pattern("PUT")     = 3,
+            pattern("GET")     = 4,
+            pattern("DELETE")  = 5,
+            pattern("")        = 6,
+            pattern("OPTIONS") = 7,
+            pattern(sized(4))  = 8,
+            pattern(_)         = -1,
+            pattern("PATCH")   = 9
+        ).value_or(0);
+
+        CHECK(evaluate_literal_strings(x) == expected);
+    }
+
+    for (std::size_t index = 0; index < 100; ++index)
+    {
+        const char key[] = { static_cast<char>('a' + index % 26), static_cast<char>('a' + index / 26 % 26), 'a', '\0' };
+
+        CHECK(evaluate_literal_many_strings(key, std::make_index_sequence<100>{}) == static_cast<int>(index));
+    }
+
+    {
+        std::string x = "store";
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(lit_str<"nop">)   = [&] { matched_pattern = 1; },
+            pattern(lit_str<"load">)  = [&] { matched_pattern = 2; },
+            pattern(lit_str<"store">) = [&](const std::string& v) { matched_pattern = v == "store" ? 3 : 5; },
+            pattern(lit_str<"jump">)  = [&] { matched_pattern = 4; }
+        );
+
+        CHECK(matched_pattern == 3);
+    }
+
+    {
+        const char* x = "jump";
+
+        auto matched_pattern = match(x)
+        (
+            pattern(lit_str<"nop">)   = 1,
+            pattern(lit_str<"load">)  = 2,
+            pattern(lit_str<"store">) = 3,
+            pattern(lit_str<"jump">)  = 4
+        );
+
+        CHECK(matched_pattern.value_or(0) == 4);
+    }
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_literal_short_strings(std::string_view x)
+{
+    return match(x)
+    (
+        pattern(lit_str<"a">)                = 1,
+        pattern(lit_str<"ab">)               = 2,
+        pattern(lit_str<"abc">)              = 3,
+        pattern(lit_str<"abcd">)             = 4,
+        pattern(lit_str<"abcdefg">)          = 5,
+        pattern(lit_str<"abcdefgh">)         = 6,
+        pattern(lit_str<"abcdefghi">)        = 7,
+        pattern(lit_str<"abcdefghijklmnop">) = 8,
+        pattern(lit_str<"bbcdefghijklmnop">) = 9,
+        pattern(lit_str<"abc">)              = 10,
+        pattern(lit_str<"">)                 = 11,
+        pattern(sized(5))                    = 12
+    ).value_or(0);
+}
+} // namespace
+
+TEST_CASE("Simple matcher string literal switch", "[match][string][literal]")
+{
+    static_assert(literal_string_switch<std::string_view, decltype(lit_str<"a">), decltype(lit_str<"b">)>::applicable);
+    static_assert(not literal_string_switch<std::string_view, decltype(lit_str<"a">), decltype(lit_str<"abcdefghijklmnopq">)>::applicable);
+    static_assert(literal_string_table<std::string_view, decltype(lit_str<"a">), decltype(lit_str<"b">), decltype(lit_str<"c">), decltype(lit_str<"abcdefghijklmnopq">)>::applicable);
+
+    static_assert(evaluate_literal_short_strings("abcdefghijklmnop") == 8);
+    static_assert(evaluate_literal_short_strings("abcdefghijklmnoq") == 0);
+    static_assert(evaluate_literal_short_strings("abc") == 3);
+
+    for (std::string_view x : { "a", "ab", "abc", "abcd", "abcde", "abcdefg", "abcdefgh", "abcdefghi", "abcdefghijklmnop",
+                                "bbcdefghijklmnop", "", "b", "ac", "abd", "abce", "abcdefh", "abcdefgi", "abcdefghj", "x",
+                                "abcdefghijklmnopq", "abcdefghijklmnoz", "zbcdefghijklmnop", "abcdeXghijklmnop" })
+    {
+        const int expected = match(x)
+        (
+            pattern("a")                = 1,
+            pattern("ab")               = 2,
+            pattern("abc")              = 3,
+            pattern("abcd")             = 4,
+            pattern("abcdefg")          = 5,
+            pattern("abcdefgh")         = 6,
+            pattern("abcdefghi")        = 7,
+            pattern("abcdefghijklmnop") = 8,
+            pattern("bbcdefghijklmnop") = 9,
+            pattern("abc")              = 10,
+            pattern("")                 = 11,
+            pattern(sized(5))           = 12
+        ).value_or(0);
+
+        CHECK(evaluate_literal_short_strings(x) == expected);
+    }
+
+    {
+        std::string x = "configuration-directory";
+
+        auto matched_pattern = match(x)
+        (
+            pattern(lit_str<"configuration-file">)      = 1,
+            pattern(lit_str<"configuration-directory">) = 2,
+            pattern(lit_str<"cache">)                   = 3,
+            pattern(lit_str<"c">)                       = 4
+        );
+
+        CHECK(matched_pattern.value_or(0) == 2);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Double matcher catch one from all same types", "[match][multi][integral]")
+{
+    int x = 42, y = 1337;
+
+    {
+        int matched_pattern = 0;
+
+        match(x, y)
+        (
+            pattern(42, 13370) = [&](auto&& x, auto&& y) { matched_pattern = 1; },
+            pattern(42, _)     = [&](auto&& x, auto&& y) { matched_pattern = 2; },
+            pattern(_, 1337)   = [&] { matched_pattern = 3; },
+            pattern(_, _)      = [&] { matched_pattern = 4; }
+        );
+
+        CHECK(matched_pattern == 2);
+
+        static_assert(match(42, 1337)
+        (
+            pattern(42, 13370) = [](auto&&, auto&&) { return 1; },
+            pattern(42, _)     = [](auto&&, auto&&) { return 2; },
+            pattern(_, 1337)   = [] { return 3; },
+            pattern(_, _)      = [] { return 4; }
+        ).value_or(0) == 2);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(x, y)
+        (
+            pattern(42, 1337)  = [&](auto&& x, auto&& y) { matched_pattern = 1; },
+            pattern(42, _)     = [&](auto&& v, auto&& y) { matched_pattern = 2; },
+            pattern(_, 1337)   = [&] { matched_pattern = 3; },
+            pattern(_, _)      = [&] { matched_pattern = 4; }
+        );
+
+        CHECK(matched_pattern == 1);
+
+        static_assert(match(42, 1337)
+        (
+            pattern(42, 1337) = [](auto&&, auto&&) { return 1; },
+            pattern(42, _)    = [](auto&&, auto&&) { return 2; },
+            pattern(_, 1337)  = [] { return 3; },
+            pattern(_, _)     = [] { return 4; }
+        ).value_or(0) == 1);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(x, y)
+        (
+            pattern(420, 1337) = [&](auto&& x, auto&& y) { matched_pattern = 1; },
+            pattern(420, _)    = [&](auto&& x, auto&& y) { matched_pattern = 2; },
+            pattern(_, 1337)   = [&] { matched_pattern = 3; },
+            pattern(_, _)      = [&] { matched_pattern = 4; }
+        );
+
+        CHECK(matched_pattern == 3);
+
+        static_assert(match(42, 1337)
+        (
+            pattern(420, 1337) = [](auto&&, auto&&) { return 1; },
+            pattern(420, _)    = [](auto&&, auto&&) { return 2; },
+            pattern(_, 1337)   = [] { return 3; },
+            pattern(_, _)      = [] { return 4; }
+        ).value_or(0) == 3);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(x, y)
+        (
+            pattern(420, 13370) = [&](auto&& x, auto&& y) { matched_pattern = 1; },
+            pattern(420, _)     = [&](auto&& x, auto&& y) { matched_pattern = 2; },
+            pattern(_, 13370)   = [&] { matched_pattern = 3; },
+            pattern(_, _)       = [&] { matched_pattern = 4; }
+        );
+
+        CHECK(matched_pattern == 4);
+
+        static_assert(match(42, 1337)
+        (
+            pattern(420, 13370) = [](auto&&, auto&&) { return 1; },
+            pattern(420, _)     = [](auto&&, auto&&) { return 2; },
+            pattern(_, 13370)   = [] { return 3; },
+            pattern(_, _)       = [] { return 4; }
+        ).value_or(0) == 4);
+    }
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_decision_tree(int state, int event, bool flag)
+{
+    return match(state, event, flag)
+    (
+        pattern(lit<0>, lit<1>, _)         = 1,
+        pattern(lit<0>, _, lit<true>)      = 2,
+        pattern(_, lit<2>, lit<false>)     = 3,
+        pattern(lit<1>, lit<2>, _)         = 4,
+        pattern(lit<1>, _, _)              = 5,
+        pattern(_, lit<3>, _)              = 6,
+        pattern(lit<2>, lit<3>, lit<true>) = 7
+    ).value_or(0);
+}
+} // namespace
+
+TEST_CASE("Multiple matcher literal decision tree", "[match][multi][literal]")
+{
+    using W = std::remove_cvref_t<decltype(_)>;
+
+    static_assert(decision_tree_impl<std::tuple<int, int>,
+        std::tuple<decltype(lit<1>), W>,
+        std::tuple<W, decltype(lit<2>)>>::applicable);
+
+    static_assert(not decision_tree_impl<std::tuple<int, int>,
+        std::tuple<W, W>>::applicable);
+
+    static_assert(evaluate_decision_tree(0, 1, false) == 1);
+    static_assert(evaluate_decision_tree(2, 3, true) == 6);
+    static_assert(evaluate_decision_tree(5, 5, true) == 0);
+
+    for (int state = -1; state <= 3; ++state)
+    {
+        for (int event = -1; event <= 4; ++event)
+        {
+            for (bool flag : { false, true })
+            {
+                const int expected = match(state, event, flag)
+                (
+                    pattern(0, 1, _)     = 1,
+                    pattern(0, _, true)  = 2,
+                    pattern(_, 2, false) = 3,
+                    pattern(1, 2, _)     = 4,
+                    pattern(1, _, _)     = 5,
+                    pattern(_, 3, _)     = 6,
+                    pattern(2, 3, true)  = 7
+                ).value_or(0);
+
+                CHECK(evaluate_decision_tree(state, event, flag) == expected);
+            }
+        }
+    }
+
+    {
+        int x = 2, y = 3;
+        int matched_pattern = 0;
+
+        match(x, y)
+        (
+            pattern(lit<2>, lit<2>) = [&] { matched_pattern = 1; },
+            pattern(lit<2>, _)      = [&](int a, int b) { matched_pattern = a + b; }
+        );
+
+        CHECK(matched_pattern == 5);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Multiple matcher column order", "[match][multi]")
+{
+    using wildcard_type = std::remove_cvref_t<decltype(_)>;
+    using regex_type = decltype(sregex("a+"));
+    using size_type = decltype(size(_x) > 1);
+
+    static_assert(column_check_order<column_order<>, regex_type, wildcard_type, int, size_type>::columns == std::array<std::size_t, 3>{ 2, 3, 0 });
+    static_assert(column_check_order<column_order<0>, regex_type, wildcard_type, int, size_type>::columns == std::array<std::size_t, 3>{ 0, 2, 3 });
+    static_assert(column_check_order<column_order<1, 3>, regex_type, wildcard_type, int, size_type>::columns == std::array<std::size_t, 4>{ 1, 3, 2, 0 });
+    static_assert(column_check_order<column_order<>, wildcard_type, wildcard_type>::columns.empty());
+
+    int lookups = 0;
+    const auto lookup = predicate([&](int x) { ++lookups; return x == 1; });
+
+    {
+        int matched_pattern = 0;
+
+        for (int x = 0; x < 10; ++x)
+        {
+            match(x, 0, 1)
+            (
+                pattern(lit<5>, _, lookup) = [&] { ++matched_pattern; },
+                pattern(_, _, _)           = [&] {}
+            );
+        }
+
+        CHECK(matched_pattern == 1);
+        CHECK(lookups == 1);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        for (int x = 0; x < 10; ++x)
+        {
+            match(x, 0, 1)
+            (
+                pattern(check_order<2>, lit<5>, _, lookup) = [&] { ++matched_pattern; },
+                pattern(_, _, _)                           = [&] {}
+            );
+        }
+
+        CHECK(matched_pattern == 1);
+        CHECK(lookups == 11);
+    }
+
+    {
+        std::string x = "aaa";
+        int y = 3;
+        int matched_pattern = 0;
+
+        match(x, y)
+        (
+            pattern(sregex("b+"), lit<3>)                = [&] { matched_pattern = 1; },
+            pattern(check_order<0, 1>, sregex("a+"), 3) = [&] { matched_pattern = 2; },
+            pattern(_, _)                                = [&] { matched_pattern = 3; }
+        );
+
+        CHECK(matched_pattern == 2);
+    }
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_branchless(int x)
+{
+    return match(branchless, x)
+    (
+        pattern(_x < 0)            = -1,
+        pattern(lit<0>)            = 0,
+        pattern(in(1, 2, 3))       = 1,
+        pattern(range(4, 10))      = 2,
+        pattern((_x & 1) == 0)     = 3,
+        pattern(_)                 = 4
+    ).value_or(100);
+}
+
+template <std::size_t... I>
+constexpr int evaluate_branchless_wide(std::size_t x, std::index_sequence<I...>)
+{
+    return match(branchless, x)(pattern(I) = static_cast<int>(I)...).value_or(-1);
+}
+
+template <class T>
+constexpr bool specifying_non_speculatable_branchless_valid_expression = requires
+{
+    { match(branchless, std::declval<T>())(pattern(some()) = 1) } -> std::same_as<std::optional<int>>;
+};
+} // namespace
+
+TEST_CASE("Simple matcher branchless", "[match][branchless]")
+{
+    static_assert(is_speculatable_v<decltype(_x < 1)>);
+    static_assert(is_speculatable_v<decltype(not (_x == 1) || _x > 3)>);
+    static_assert(is_speculatable_v<decltype(lit<1>)>);
+    static_assert(is_speculatable_v<decltype(_)>);
+    static_assert(not is_speculatable_v<decltype(_x / 2 == 1)>);
+    static_assert(not is_speculatable_v<decltype(some())>);
+    static_assert(not is_speculatable_v<decltype(predicate([](int x) { return x > 0; }))>);
+    static_assert(is_speculatable_v<decltype(speculative([](int x) { return x > 0; }))>);
+
+    static_assert(not specifying_non_speculatable_branchless_valid_expression<std::optional<int>>);
+
+    static_assert(evaluate_branchless(-5) == -1);
+    static_assert(evaluate_branchless(0) == 0);
+    static_assert(evaluate_branchless(8) == 2);
+    static_assert(evaluate_branchless(12) == 3);
+
+    for (int x = -3; x <= 16; ++x)
+    {
+        const int expected = match(x)
+        (
+            pattern(_x < 0)            = -1,
+            pattern(lit<0>)            = 0,
+            pattern(in(1, 2, 3))       = 1,
+            pattern(range(4, 10))      = 2,
+            pattern((_x & 1) == 0)     = 3,
+            pattern(_)                 = 4
+        ).value_or(100);
+
+        CHECK(evaluate_branchless(x) == expected);
+    }
+
+    CHECK(evaluate_branchless_wide(0, std::make_index_sequence<130>{}) == 0);
+    CHECK(evaluate_branchless_wide(63, std::make_index_sequence<130>{}) == 63);
+    CHECK(evaluate_branchless_wide(64, std::make_index_sequence<130>{}) == 64);
+    CHECK(evaluate_branchless_wide(129, std::make_index_sequence<130>{}) == 129);
+    CHECK(evaluate_branchless_wide(130, std::make_index_sequence<130>{}) == -1);
+
+    {
+        int x = 3, y = 7;
+        int matched_pattern = 0;
+
+        match(branchless, x, y)
+        (
+            pattern(_x > 5, _)  = [&] { matched_pattern = 1; },
+            pattern(_, _y > 5)  = [&](int a, int b) { matched_pattern = a + b; }
+        );
+
+        CHECK(matched_pattern == 10);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher predicate cost", "[match][branchless]")
+{
+    static_assert(predicate_cost_v<decltype(lit<1>)> == predicate_cost::literal);
+    static_assert(predicate_cost_v<decltype(_x < 1)> == predicate_cost::literal);
+    static_assert(predicate_cost_v<decltype(range(1, 2))> == predicate_cost::arithmetic);
+    static_assert(predicate_cost_v<decltype(size(_x) > 3)> == predicate_cost::arithmetic);
+    static_assert(predicate_cost_v<decltype(find(1) != end())> == predicate_cost::container);
+    static_assert(predicate_cost_v<decltype(sregex("a+"))> == predicate_cost::regex);
+    static_assert(predicate_cost_v<decltype(sregex("a+") && _x == "a"s)> == predicate_cost::regex);
+    static_assert(predicate_cost_v<decltype(predicate([](int x) { return x > 0; }))> == predicate_cost::call);
+    static_assert(predicate_cost_v<decltype(with_cost<predicate_cost::container>([](int x) { return x > 0; }))> == predicate_cost::container);
+
+    // Costs don't make the library predicates speculatable
+    static_assert(not is_speculatable_v<decltype(sregex("a+"))>);
+    static_assert(not is_speculatable_v<decltype(regex("a+"))>);
+    static_assert(not is_speculatable_v<decltype(size(_x) > 3)>);
+    static_assert(not is_speculatable_v<decltype(find(1, [](int x) { return x * 2; }))>);
+    static_assert(not is_speculatable_v<decltype(with_cost<predicate_cost::literal>([](int x) { return x > 0; }))>);
+    static_assert(is_speculatable_v<decltype(find(1))>);
+    static_assert(is_side_effect_free_v<decltype(find(1) != end())>);
+
+    using regex_arm = decltype(pattern(regex("a+")) = 1);
+    static_assert(not policy_accepts_v<branchless_policy, regex_arm>);
+    static_assert(policy_accepts_v<default_policy, regex_arm>);
+
+    static_assert(operands_order_v<decltype(_x > 1), decltype(_x < 3)> == operands_order::both);
+    static_assert(operands_order_v<decltype(sregex("a+")), decltype(_x != "a"s)> == operands_order::swapped);
+    static_assert(operands_order_v<decltype(sregex("a+")), decltype(size(_x) > 3)> == operands_order::written);
+    static_assert(operands_order_v<decltype(size(_x) > 3), decltype(sregex("a+"))> == operands_order::written);
+    static_assert(operands_order_v<decltype(ordered(sregex("a+"))), decltype(size(_x) > 3)> == operands_order::written);
+    static_assert(operands_order_v<decltype(predicate([](int x) { return x > 0; })), decltype(_x < 3)> == operands_order::written);
+
+    int expensive_calls = 0;
+    int cheap_calls = 0;
+
+    const auto expensive = speculative<predicate_cost::container>([&](int x) { ++expensive_calls; return x > 10; });
+    const auto cheap = speculative<predicate_cost::literal>([&](int x) { ++cheap_calls; return x % 2 == 0; });
+
+    {
+        int matched_pattern = 0;
+
+        match(3)
+        (
+            pattern(expensive && cheap) = [&] { matched_pattern = 1; },
+            pattern(_)                  = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 2);
+        CHECK(cheap_calls == 1);
+        CHECK(expensive_calls == 0);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(12)
+        (
+            pattern(expensive || cheap) = [&] { matched_pattern = 1; },
+            pattern(_)                  = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 1);
+        CHECK(cheap_calls == 2);
+        CHECK(expensive_calls == 0);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(3)
+        (
+            pattern(ordered(expensive) && cheap) = [&] { matched_pattern = 1; },
+            pattern(_)                           = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 2);
+        CHECK(cheap_calls == 2);
+        CHECK(expensive_calls == 1);
+    }
+
+    {
+        std::string x = "aaaa";
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(sregex("b+") && size(_x) > 3) = [&] { matched_pattern = 1; },
+            pattern(sregex("a+") && size(_x) > 3) = [&] { matched_pattern = 2; },
+            pattern(_)                            = [&] { matched_pattern = 3; }
+        );
+
+        CHECK(matched_pattern == 2);
+    }
+}
+
+//=================================================================================================
+
+namespace {
+constexpr int evaluate_adaptive(int x)
+{
+    return match(adaptive, x)
+    (
+        pattern(lit<0>)            = 0,
+        pattern(lit_range<1, 9>)   = 1,
+        pattern(lit<10>)           = 2,
+        pattern(lit_range<11, 99>) = 3,
+        pattern(lit<-1>)           = 4,
+        pattern(_)                 = 5
+    ).value_or(100);
+}
+
+int evaluate_adaptive_strings(std::string_view x)
+{
+    return match(adaptive, x)
+    (
+        pattern(lit_str<"alpha">) = 1,
+        pattern(lit_str<"beta">)  = 2,
+        pattern(lit_str<"gamma">) = 3,
+        pattern(lit_str<"delta">) = 4
+    ).value_or(0);
+}
+
+template <fixed_string Site>
+int evaluate_adaptive_site(int x)
+{
+    return match(adaptive_at<Site>, x)
+    (
+        pattern(lit<1>) = 1,
+        pattern(lit<2>) = 2,
+        pattern(lit<3>) = 3
+    ).value_or(0);
+}
+
+template <class T>
+constexpr bool specifying_overlapping_adaptive_valid_expression = requires
+{
+    { match(adaptive, std::declval<T>())(pattern(lit_range<0, 5>) = 1, pattern(lit<5>) = 2) } -> std::same_as<std::optional<int>>;
+};
+
+template <class T>
+constexpr bool specifying_disjoint_adaptive_valid_expression = requires
+{
+    { match(adaptive, std::declval<T>())(pattern(lit_range<0, 5>) = 1, pattern(lit<6>) = 2) } -> std::same_as<std::optional<int>>;
+};
+} // namespace
+
+TEST_CASE("Simple matcher adaptive", "[match][adaptive]")
+{
+    using rows = disjoint_arms<
+        std::tuple<std::remove_cvref_t<decltype(lit<1>)>>,
+        std::tuple<std::remove_cvref_t<decltype(lit_range<2, 4>)>>,
+        std::tuple<std::remove_cvref_t<decltype(_)>>>;
+
+    static_assert(rows::value && rows::count == 2);
+    static_assert(not disjoint_arms<std::tuple<std::remove_cvref_t<decltype(_)>>, std::tuple<std::remove_cvref_t<decltype(lit<1>)>>>::value);
+    static_assert(not disjoint_arms<std::tuple<std::remove_cvref_t<decltype(lit<1>)>>, std::tuple<std::remove_cvref_t<decltype(lit<1u>)>>>::value);
+    static_assert(not disjoint_arms<std::tuple<std::remove_cvref_t<decltype(_x > 1)>>, std::tuple<std::remove_cvref_t<decltype(lit<0>)>>>::value);
+    static_assert(disjoint_arms<
+        std::tuple<std::remove_cvref_t<decltype(lit<1>)>, std::remove_cvref_t<decltype(lit_str<"a">)>>,
+        std::tuple<std::remove_cvref_t<decltype(lit<1>)>, std::remove_cvref_t<decltype(lit_str<"b">)>>>::value);
+    static_assert(not disjoint_arms<
+        std::tuple<std::remove_cvref_t<decltype(lit<1>)>, std::remove_cvref_t<decltype(_)>>,
+        std::tuple<std::remove_cvref_t<decltype(_)>, std::remove_cvref_t<decltype(lit_str<"a">)>>>::value);
+
+    static_assert(not specifying_overlapping_adaptive_valid_expression<int>);
+    static_assert(specifying_disjoint_adaptive_valid_expression<int>);
+
+    static_assert(evaluate_adaptive(0) == 0);
+    static_assert(evaluate_adaptive(50) == 3);
+    static_assert(evaluate_adaptive(-7) == 5);
+
+    // Skewed subjects promote the later arms first, then shift to the earlier ones: results never change
+    int mismatches = 0;
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int iteration = 0; iteration < 5000; ++iteration)
+        {
+            const int x = iteration % 10 != 0 ? (round == 1 ? 5 : -1) : iteration % 120 - 10;
+
+            const int expected = match(x)
+            (
+                pattern(lit<0>)            = 0,
+                pattern(lit_range<1, 9>)   = 1,
+                pattern(lit<10>)           = 2,
+                pattern(lit_range<11, 99>) = 3,
+                pattern(lit<-1>)           = 4,
+                pattern(_)                 = 5
+            ).value_or(100);
+
+            mismatches += evaluate_adaptive(x) != expected ? 1 : 0;
+        }
+    }
+
+    CHECK(mismatches == 0);
+
+    for (int iteration = 0; iteration < 3000; ++iteration)
+    {
+        mismatches += evaluate_adaptive_strings("delta") != 4 ? 1 : 0;
+        mismatches += evaluate_adaptive_strings(iteration % 2 ? "alpha" : "omega") != (iteration % 2 ? 1 : 0) ? 1 : 0;
+    }
+
+    CHECK(mismatches == 0);
+
+    {
+        std::variant<int, std::string> x = "11223344"s;
+        int matched_pattern = 0;
+
+        for (int iteration = 0; iteration < 2000; ++iteration)
+        {
+            match(adaptive, x)
+            (
+                pattern(valued(1))          = [&] { matched_pattern = 1; },
+                pattern(typed<std::string>) = [&] { matched_pattern = 2; },
+                pattern(_)                  = [&] { matched_pattern = 3; }
+            );
+        }
+
+        CHECK(matched_pattern == 2);
+    }
+
+    // Sites of the same types count their hits apart once named
+    static_assert(is_match_policy_v<decltype(adaptive_at<"tests.adaptive.left">)>);
+
+    auto& left = adaptive_site_counters<adaptive_site_policy<"tests.adaptive.left">, 3>;
+    auto& right = adaptive_site_counters<adaptive_site_policy<"tests.adaptive.right">, 3>;
+
+    for (std::uint32_t iteration = 0; iteration < adaptive_period; ++iteration)
+    {
+        mismatches += evaluate_adaptive_site<"tests.adaptive.left">(3) != 3 ? 1 : 0;
+        mismatches += evaluate_adaptive_site<"tests.adaptive.right">(iteration % 2 + 1) != static_cast<int>(iteration % 2 + 1) ? 1 : 0;
+    }
+
+    CHECK(mismatches == 0);
+    CHECK((left.hot_arms.load() & 0xffff) == 2);
+    CHECK(left.hits[0].load() == 0);
+    CHECK(right.hits[2].load() == 0);
+    CHECK(right.hot_arms.load() == adaptive_counters<3>::no_hot_arms);
+}
+
+//=================================================================================================
+
+template <class... P>
+using profile_row = std::tuple<std::remove_cvref_t<P>...>;
+
+// As generated by an instrumented build, with the signatures spelled out instead of their values
+PATUM_SITE_PROFILE("tests.profiled.ints",
+    (site_signature_v<std::tuple<int>, profile_row<decltype(lit<0>)>, profile_row<decltype(lit_range<1, 9>)>,
+        profile_row<decltype(lit<10>)>, profile_row<decltype(lit_range<11, 99>)>, profile_row<decltype(lit<-1>)>,
+        profile_row<decltype(_)>>),
+    1, 2, 0, 3, 90, 4)
+
+PATUM_SITE_PROFILE("tests.profiled.strings",
+    (site_signature_v<std::tuple<std::string_view, std::string_view>,
+        profile_row<decltype(lit_str<"get">), decltype(lit_str<"user">)>, profile_row<decltype(lit_str<"get">), decltype(lit_str<"team">)>,
+        profile_row<decltype(lit_str<"put">), decltype(lit_str<"user">)>, profile_row<decltype(_), decltype(_)>>),
+    5, 10, 80, 5)
+
+PATUM_SITE_PROFILE("tests.profiled.overlapping",
+    (site_signature_v<std::tuple<int>, profile_row<decltype(_x < 6)>, profile_row<decltype(_x == 5)>, profile_row<decltype(_)>>),
+    1, 90, 9)
+
+PATUM_SITE_PROFILE("tests.profiled.stale", 0, 1, 90, 9)
+
+namespace {
+constexpr int evaluate_profiled(int x)
+{
+    return match(profiled<"tests.profiled.ints">, x)
+    (
+        pattern(lit<0>)            = 0,
+        pattern(lit_range<1, 9>)   = 1,
+        pattern(lit<10>)           = 2,
+        pattern(lit_range<11, 99>) = 3,
+        pattern(lit<-1>)           = 4,
+        pattern(_)                 = 5
+    ).value_or(100);
+}
+
+constexpr int evaluate_profiled_strings(std::string_view verb, std::string_view object)
+{
+    return match(profiled<"tests.profiled.strings">, verb, object)
+    (
+        pattern(lit_str<"get">, lit_str<"user">) = 1,
+        pattern(lit_str<"get">, lit_str<"team">) = 2,
+        pattern(lit_str<"put">, lit_str<"user">) = 3,
+        pattern(_, _)                            = 0
+    ).value_or(-1);
+}
+
+template <fixed_string Site>
+constexpr int evaluate_profiled_overlapping(int x)
+{
+    return match(profiled<Site>, x)
+    (
+        pattern(_x < 6)  = 1,
+        pattern(_x == 5) = 2,
+        pattern(_)       = 3
+    ).value_or(0);
+}
+} // namespace
+
+TEST_CASE("Simple matcher profiled", "[match][profile]")
+{
+    using ints = profile_plan<"tests.profiled.ints", std::tuple<int>, profile_row<decltype(lit<0>)>,
+        profile_row<decltype(lit_range<1, 9>)>, profile_row<decltype(lit<10>)>, profile_row<decltype(lit_range<11, 99>)>,
+        profile_row<decltype(lit<-1>)>, profile_row<decltype(_)>>;
+
+    static_assert(ints::valid && ints::hot_count == 1);
+    static_assert(ints::order == std::array<std::size_t, 6>{ 4, 3, 1, 0, 2, 5 });
+    static_assert(ints::select_dispatch(false) == profile_dispatch::hot_first);
+    static_assert(ints::select_dispatch(true) == profile_dispatch::ordered_chain);
+
+    // Stale and missing profiles leave the site as it is
+    static_assert(not profile_plan<"tests.profiled.stale", std::tuple<int>, profile_row<decltype(_x < 6)>,
+        profile_row<decltype(_x == 5)>, profile_row<decltype(_)>>::valid);
+    static_assert(not profile_plan<"tests.profiled.ints", std::tuple<long>, profile_row<decltype(lit<0>)>>::valid);
+    static_assert(not profile_plan<"tests.profiled.missing", std::tuple<int>, profile_row<decltype(lit<0>)>>::valid);
+
+    static_assert(evaluate_profiled(-1) == 4);
+    static_assert(evaluate_profiled(50) == 3);
+    static_assert(evaluate_profiled(100) == 5);
+    static_assert(evaluate_profiled_strings("put", "user") == 3);
+
+    for (int x = -5; x < 110; ++x)
+    {
+        const int expected = x == 0 ? 0 : x >= 1 && x <= 9 ? 1 : x == 10 ? 2 : x >= 11 && x <= 99 ? 3 : x == -1 ? 4 : 5;
+
+        CHECK(evaluate_profiled(x) == expected);
+    }
+
+    CHECK(evaluate_profiled_strings("get", "user") == 1);
+    CHECK(evaluate_profiled_strings("get", "team") == 2);
+    CHECK(evaluate_profiled_strings("put", "user") == 3);
+    CHECK(evaluate_profiled_strings("put", "team") == 0);
+
+    // Overlapping arms keep their order whatever the profile says, the hot arm is only hinted
+    CHECK(evaluate_profiled_overlapping<"tests.profiled.overlapping">(5) == 1);
+    CHECK(evaluate_profiled_overlapping<"tests.profiled.overlapping">(7) == 3);
+    CHECK(evaluate_profiled_overlapping<"tests.profiled.stale">(5) == 1);
+
+    {
+        auto& counters = profile_site_counters<"tests.profiled.recorded", 42, 3>;
+
+        counters.record("tests.profiled.recorded", 42, 1);
+        counters.record("tests.profiled.recorded", 42, 1);
+        counters.record("tests.profiled.recorded", 42, 2);
+
+        std::ostringstream stream;
+        profile_registry::instance().write(stream);
+
+        CHECK(stream.str().find("PATUM_SITE_PROFILE(\"tests.profiled.recorded\", 0x2aull, 0, 2, 1)\n") != std::string::npos);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher range", "[match][range]")
+{
+    int x = 12;
+
+    {
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(range(1, 124)) = [&] { matched_pattern = 1; },
+            pattern(_)             = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 1);
+
+        static_assert(match(12)
+        (
+            pattern(range(1, 124)) = 1,
+            pattern(_)             = 2
+        ).value_or(0) == 1);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(range(1, 11)) = [&] { matched_pattern = 1; },
+            pattern(_)            = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 2);
+
+        static_assert(match(12)
+        (
+            pattern(range(1, 11)) = 1,
+            pattern(_)            = 2
+        ).value_or(0) == 2);
+    }
+
+    {
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(range(13, 124)) = [&] { matched_pattern = 1; },
+            pattern(_)              = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 2);
+
+        static_assert(match(12)
+        (
+            pattern(range(13, 1124)) = 1,
+            pattern(_)               = 2
+        ).value_or(0) == 2);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher in", "[match][in]")
+{
+    int x = 4;
 
     {
         int matched_pattern = 0;
@@ -633,22 +2366,111 @@ TEST_CASE("Simple matcher in", "[match][in]")
     }
 
     {
-        int matched_pattern = 0;
+        int matched_pattern = 0;
+
+        match(x)
+        (
+            pattern(in(1, 2, 3, 5, 6, 7, 10, 12)) = [&] { matched_pattern = 1; },
+            pattern(_)                            = [&] { matched_pattern = 2; }
+        );
+
+        CHECK(matched_pattern == 2);
+
+        static_assert(match(4)
+        (
+            pattern(in(1, 2, 3, 5, 6, 7, 10, 12)) = 1,
+            pattern(_)                            = 2
+        ).value_or(0) == 2);
+    }
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher in hashed strings", "[match][in]")
+{
+    const auto evaluate_method = [](std::string_view method)
+    {
+        return match(method)
+        (
+            pattern(in("GET", "PUT", "POST", "HEAD", "PATCH", "TRACE", "DELETE", "OPTIONS", "CONNECT",
+                "PROPFIND", "PROPPATCH", "MKCOL", "COPY", "MOVE", "LOCK", "UNLOCK")) = 1,
+            pattern(_)                                                           = 2
+        ).value_or(0);
+    };
+
+    CHECK(evaluate_method("GET") == 1);
+    CHECK(evaluate_method("UNLOCK") == 1);
+    CHECK(evaluate_method("PROPFIND") == 1);
+    CHECK(evaluate_method("get") == 2);
+    CHECK(evaluate_method("") == 2);
+    CHECK(evaluate_method("PROPFINDS") == 2);
+
+    static_assert(match(std::string_view("LOCK"))
+    (
+        pattern(in("GET", "PUT", "POST", "HEAD", "PATCH", "TRACE", "DELETE", "OPTIONS", "CONNECT", "PROPFIND", "PROPPATCH", "MKCOL")) = 1,
+        pattern(in("COPY", "MOVE", "LOCK", "UNLOCK", "SEARCH", "BIND", "REBIND", "UNBIND", "ACL", "REPORT", "LINK", "UNLINK"))     = 2
+    ).value_or(0) == 2);
+
+    CHECK(match(std::string("MKCOL"))(pattern(in("GET", "PUT", "POST", "HEAD", "PATCH", "TRACE", "DELETE", "OPTIONS",
+        "CONNECT", "PROPFIND", "PROPPATCH", "MKCOL", "COPY", "MOVE", "LOCK", "UNLOCK")) = 1).value_or(0) == 1);
+}
+
+//=================================================================================================
+
+TEST_CASE("Simple matcher in runtime containers", "[match][in]")
+{
+    for (const std::size_t size : { std::size_t(0), std::size_t(3), ptm::value_set_min_sorted - 1, ptm::value_set_min_sorted,
+             ptm::value_set_max_sorted, ptm::value_set_max_sorted + 1, std::size_t(20000) })
+    {
+        std::vector<int> allowed;
+        for (std::size_t index = 0; index < size; ++index)
+            allowed.push_back(static_cast<int>((index * 7919) % 10007) - 500);
 
-        match(x)
-        (
-            pattern(in(1, 2, 3, 5, 6, 7, 10, 12)) = [&] { matched_pattern = 1; },
-            pattern(_)                            = [&] { matched_pattern = 2; }
-        );
+        const auto allowed_values = in_set(allowed);
 
-        CHECK(matched_pattern == 2);
+        for (int x = -600; x < 10000; x += 13)
+        {
+            const bool expected = std::ranges::find(allowed, x) != allowed.end();
 
-        static_assert(match(4)
-        (
-            pattern(in(1, 2, 3, 5, 6, 7, 10, 12)) = 1,
-            pattern(_)                            = 2
-        ).value_or(0) == 2);
+            CHECK(match(x)(pattern(allowed_values) = 1, pattern(_) = 2).value_or(0) == (expected ? 1 : 2));
+            CHECK(match(static_cast<long long>(x))(pattern(allowed_values) = 1).has_value() == expected);
+            CHECK(match(static_cast<double>(x))(pattern(allowed_values) = 1).has_value() == expected);
+        }
+
+        CHECK(not match(std::numeric_limits<unsigned>::max())(pattern(allowed_values) = 1).has_value());
+    }
+
+    for (const std::size_t size : { std::size_t(2), ptm::value_set_min_hashed - 1, ptm::value_set_min_hashed, std::size_t(1000) })
+    {
+        std::vector<std::string> hosts;
+        for (std::size_t index = 0; index < size; ++index)
+            hosts.push_back("host-" + std::to_string(index * 3) + ".example.com");
+
+        const auto allowed_hosts = in_set(hosts);
+
+        CHECK(match(std::string("host-0.example.com"))(pattern(allowed_hosts) = 1).value_or(0) == 1);
+        CHECK(match(std::string_view("host-3.example.com"))(pattern(allowed_hosts) = 1).value_or(0) == 1);
+        CHECK(match("host-1.example.com")(pattern(allowed_hosts) = 1).value_or(0) == 0);
+        CHECK(match(std::string(""))(pattern(allowed_hosts) = 1).value_or(0) == 0);
+        CHECK(match(hosts.back())(pattern(allowed_hosts) = 1).value_or(0) == 1);
+        CHECK(match(hosts.back() + "x")(pattern(allowed_hosts) = 1).value_or(0) == 0);
     }
+
+    using int_set = ptm::value_set<int>;
+    CHECK(int_set(std::vector<int>(ptm::value_set_min_sorted - 1)).representation() == int_set::layout::linear);
+    CHECK(int_set(std::vector<int>(ptm::value_set_max_sorted)).representation() == int_set::layout::sorted);
+    CHECK(int_set(std::vector<int>(ptm::value_set_max_sorted + 1)).representation() == int_set::layout::hashed);
+
+    const std::array<std::string_view, 3> names = { "alpha", "beta", "gamma" };
+    CHECK(match(std::string("beta"))(pattern(in_set(names)) = 1, pattern(_) = 2).value_or(0) == 1);
+    CHECK(match(std::string("delta"))(pattern(in_set(names) && sized(5)) = 1, pattern(_) = 2).value_or(0) == 2);
+
+    // A single container given to in() is a value the subject is compared with, not a set
+    const std::vector<int> pair = { 1, 2 };
+    CHECK(match(pair)(pattern(in(std::vector{ 1, 2 })) = 1, pattern(_) = 2).value_or(0) == 1);
+    CHECK(match(pair)(pattern(in(std::vector{ 2, 1 }, std::vector{ 1, 2 })) = 1, pattern(_) = 2).value_or(0) == 1);
+    CHECK(match(std::array{ 3, 4 })(pattern(in(std::array{ 3, 4 })) = 1, pattern(_) = 2).value_or(0) == 1);
+    CHECK(match(std::array{ 3, 4 })(pattern(in(std::array{ 4, 3 })) = 1, pattern(_) = 2).value_or(0) == 2);
 }
 
 //=================================================================================================
@@ -1190,6 +3012,175 @@ TEST_CASE("Simple matcher is type on variant", "[match][is]")
 
 //=================================================================================================
 
+namespace {
+struct throwing_alternative
+{
+    throwing_alternative() = default;
+    throwing_alternative(const throwing_alternative&) { throw 1; }
+};
+
+using message = std::variant<int, std::string, double, char, long, int, throwing_alternative>;
+
+int evaluate_message(const message& x)
+{
+    using namespace ptm;
+
+    return match(x)
+    (
+        pattern(typed<double>)        = 1,
+        pattern(valued(42))           = 2,
+        pattern(valued("ping"s))      = 3,
+        pattern(typed<int>)           = 4,
+        pattern(typed<std::string>)   = 5,
+        pattern(typed<char>)          = 6,
+        pattern([](const message& m) { return m.index() == 4; }) = 7,
+        pattern(_)                    = 0
+    ).value_or(-1);
+}
+} // namespace
+
+TEST_CASE("Simple matcher variant index dispatch", "[match][variant]")
+{
+    using variant_patterns = std::tuple<decltype(typed<double>), decltype(valued(42)), decltype(_)>;
+
+    static_assert(classify_variant_arm<message, 2, std::remove_cvref_t<std::tuple_element_t<0, variant_patterns>>>() == variant_arm_kind::always);
+    static_assert(classify_variant_arm<message, 1, std::remove_cvref_t<std::tuple_element_t<0, variant_patterns>>>() == variant_arm_kind::never);
+    static_assert(classify_variant_arm<message, 0, std::remove_cvref_t<std::tuple_element_t<1, variant_patterns>>>() == variant_arm_kind::check);
+    static_assert(classify_variant_arm<message, 3, std::remove_cvref_t<std::tuple_element_t<1, variant_patterns>>>() == variant_arm_kind::never);
+    static_assert(classify_variant_arm<message, 3, std::remove_cvref_t<std::tuple_element_t<2, variant_patterns>>>() == variant_arm_kind::always);
+
+    CHECK(evaluate_message(message{ 1.0 }) == 1);
+    CHECK(evaluate_message(message{ std::in_place_index<0>, 42 }) == 2);
+    CHECK(evaluate_message(message{ std::in_place_index<0>, 43 }) == 4);
+    CHECK(evaluate_message(message{ "ping"s }) == 3);
+    CHECK(evaluate_message(message{ "pong"s }) == 5);
+    CHECK(evaluate_message(message{ 'x' }) == 6);
+    CHECK(evaluate_message(message{ 1L }) == 7);
+
+    // An alternative type appearing more than once matches whichever of them is held
+    CHECK(evaluate_message(message{ std::in_place_index<5>, 42 }) == 2);
+    CHECK(evaluate_message(message{ std::in_place_index<5>, 43 }) == 4);
+    CHECK(evaluate_message(message{ std::in_place_index<6> }) == 0);
+
+    // Valueless by exception variants fall back to checking every arm
+    message valueless;
+    CHECK_THROWS_AS(valueless.emplace<6>(throwing_alternative{}), int);
+    REQUIRE(valueless.valueless_by_exception());
+    CHECK(evaluate_message(valueless) == 0);
+}
+
+namespace {
+struct circle { int radius = 0; constexpr bool operator==(const circle&) const = default; };
+struct box { int side = 0; constexpr bool operator==(const box&) const = default; };
+struct point { constexpr bool operator==(const point&) const = default; };
+
+using shape = std::variant<circle, box, point>;
+
+constexpr int evaluate_collision(const shape& a, const shape& b)
+{
+    using namespace ptm;
+
+    return match(a, b)
+    (
+        pattern(typed<circle>, typed<circle>) = 1,
+        pattern(typed<circle>, typed<box>)    = 2,
+        pattern(typed<box>, typed<circle>)    = 3,
+        pattern(typed<point>, _)              = 4,
+        pattern(_, typed<point>)              = 5
+    ).value_or(0);
+}
+
+constexpr int evaluate_collision_values(const shape& a, const shape& b)
+{
+    using namespace ptm;
+
+    return match(a, b)
+    (
+        pattern(valued(circle{ 1 }), typed<box>) = 1,
+        pattern(typed<circle>, typed<box>)       = 2,
+        pattern(typed<box>, valued(box{ 2 }))    = 3,
+        pattern(_, typed<circle>)                = 4,
+        pattern(_, _)                            = 0
+    ).value_or(-1);
+}
+} // namespace
+
+TEST_CASE("Simple matcher variant grid dispatch", "[match][variant]")
+{
+    using typed_table = variant_grid_table_impl<std::tuple<shape, shape>,
+        std::tuple<std::remove_cvref_t<decltype(typed<circle>)>, std::remove_cvref_t<decltype(typed<circle>)>>,
+        std::tuple<std::remove_cvref_t<decltype(typed<point>)>, std::remove_cvref_t<decltype(_)>>>;
+
+    static_assert(variant_grid_table<std::tuple<shape, shape>,
+        std::tuple<std::remove_cvref_t<decltype(typed<circle>)>, std::remove_cvref_t<decltype(typed<circle>)>>>::applicable);
+    static_assert(not variant_grid_table<std::tuple<shape, int>,
+        std::tuple<std::remove_cvref_t<decltype(typed<circle>)>, std::remove_cvref_t<decltype(_)>>>::applicable);
+
+    static_assert(typed_table::cell_count == 9);
+    static_assert(typed_table::table_size == 9);
+    static_assert(typed_table::resolved);
+    static_assert(typed_table::table[0] == 0);
+    static_assert(typed_table::table[1] == 2);
+    static_assert(typed_table::table[7] == 1);
+
+    static_assert(evaluate_collision(circle{}, box{}) == 2);
+
+    CHECK(evaluate_collision(circle{}, circle{}) == 1);
+    CHECK(evaluate_collision(circle{}, box{}) == 2);
+    CHECK(evaluate_collision(box{}, circle{}) == 3);
+    CHECK(evaluate_collision(box{}, box{}) == 0);
+    CHECK(evaluate_collision(point{}, circle{}) == 4);
+    CHECK(evaluate_collision(point{}, point{}) == 4);
+    CHECK(evaluate_collision(box{}, point{}) == 5);
+
+    CHECK(evaluate_collision_values(circle{ 1 }, box{}) == 1);
+    CHECK(evaluate_collision_values(circle{ 2 }, box{}) == 2);
+    CHECK(evaluate_collision_values(box{}, box{ 2 }) == 3);
+    CHECK(evaluate_collision_values(box{}, box{ 3 }) == 0);
+    CHECK(evaluate_collision_values(point{}, circle{}) == 4);
+    CHECK(evaluate_collision_values(point{}, point{}) == 0);
+
+    // A valueless by exception subject makes the grid check every arm in order, against every subject
+    message valueless;
+    CHECK_THROWS_AS(valueless.emplace<6>(throwing_alternative{}), int);
+    REQUIRE(valueless.valueless_by_exception());
+
+    const auto evaluate_valueless = [](const shape& a, const message& b)
+    {
+        return match(a, b)
+        (
+            pattern(typed<circle>, typed<double>) = 1,
+            pattern(typed<circle>, _)             = 2,
+            pattern(_, _)                         = 0
+        ).value_or(-1);
+    };
+
+    CHECK(evaluate_valueless(circle{}, message{ 1.0 }) == 1);
+    CHECK(evaluate_valueless(circle{}, valueless) == 2);
+    CHECK(evaluate_valueless(box{}, valueless) == 0);
+}
+
+TEST_CASE("Simple matcher typed checks the held alternative", "[match][typed]")
+{
+    std::variant<int, std::string> x = "11223344"s;
+
+    int matched_pattern = 0;
+
+    match(x)
+    (
+        pattern(typed<int>)         = [&] { matched_pattern = 1; },
+        pattern(typed<std::string>) = [&] { matched_pattern = 2; },
+        pattern(_)                  = [&] { matched_pattern = 3; }
+    );
+
+    CHECK(matched_pattern == 2);
+
+    CHECK(not evaluate_match(typed<int>, x));
+    CHECK(evaluate_match(typed<std::string>, x));
+}
+
+//=================================================================================================
+
 namespace {
 template <class T>
 auto stringize_type(T* x = nullptr)
@@ -1563,6 +3554,49 @@ TEST_CASE("Simple matcher destructure tuple", "[match][destructure]")
 
 //=================================================================================================
 
+TEST_CASE("Simple matcher destructure tuple decision tree", "[match][destructure][literal]")
+{
+    for (int a = 0; a <= 2; ++a)
+    {
+        for (char c : { 'a', 'b', 'c' })
+        {
+            auto x = std::make_tuple(a, "123"s, c);
+
+            auto matched_pattern = match(x)
+            (
+                pattern(ds(lit<1>, _, lit<'a'>)) = 1,
+                pattern(ds(lit<1>))              = 2,
+                pattern(ds(_, _, lit<'b'>))      = 3,
+                pattern(_)                       = 4
+            );
+
+            auto expected_pattern = match(x)
+            (
+                pattern(ds(1, _, 'a')) = 1,
+                pattern(ds(1))         = 2,
+                pattern(ds(_, _, 'b')) = 3,
+                pattern(_)             = 4
+            );
+
+            CHECK(matched_pattern == expected_pattern);
+        }
+    }
+
+    {
+        auto x = std::make_pair(3, 4L);
+
+        auto matched_pattern = match(x)
+        (
+            pattern(ds(lit<3>, lit<5L>)) = [] { return 1; },
+            pattern(ds(lit<3>, _))       = [](const auto& p) { return p.first + static_cast<int>(p.second); }
+        );
+
+        CHECK(matched_pattern.value_or(0) == 7);
+    }
+}
+
+//=================================================================================================
+
 namespace {
 struct aggregate
 {
@@ -1703,3 +3737,539 @@ TEST_CASE("Simple matcher regex_match", "[match][regex]")
     }
 #endif
 }
+
+//=================================================================================================
+
+TEST_CASE("Rule set", "[rules]")
+{
+    rule_set_builder<std::string, int, int> builder;
+
+    builder
+        .add(10, 1, "GET", _, rule_range(8000, 8999))
+        .add(10, 2, rule_in({ "PUT", "POST" }), 443, _)
+        .add(20, 3, "GET", 443, _)
+        .add(0, 4, _, _, _)
+        .add(10, 5, "GET", _, 8080);
+
+    const auto rules = builder.freeze();
+
+    CHECK(rules.size() == 5);
+    CHECK(rules.is_indexed(0));
+    CHECK(rules.is_indexed(1));
+    CHECK(rules.is_indexed(2));
+
+    // Higher priorities first, then insertion order
+    CHECK(rules.match("GET"sv, 443, 8080) == 3u);
+    CHECK(rules.match("GET"sv, 80, 8080) == 1u);
+    CHECK(rules.match("POST"sv, 443, 1) == 2u);
+    CHECK(rules.match("PUT"s, 443, 1) == 2u);
+    CHECK(rules.match("PUT"sv, 80, 1) == 4u);
+    CHECK(rules.match("DELETE"sv, 443, 8500) == 4u);
+
+    rule_set_builder<int> unindexed;
+    unindexed.add(0, 7, rule_range(1, 5)).add(1, 8, rule_range(4, 9));
+
+    const auto ranges = unindexed.freeze();
+
+    CHECK_FALSE(ranges.is_indexed(0));
+    CHECK(ranges.match(4) == 8u);
+    CHECK(ranges.match(2) == 7u);
+    CHECK_FALSE(ranges.match(10).has_value());
+}
+
+TEST_CASE("Rule set matches like a linear scan", "[rules]")
+{
+    rule_set_builder<int, int> builder;
+    std::vector<std::tuple<int, int, int, int>> reference;
+
+    // Same rules as a table scanned in priority order: equality, range and wildcard conditions on both columns
+    for (int index = 0; index < 300; ++index)
+    {
+        const int priority = index % 7;
+
+        if (index % 3 == 0)
+            builder.add(priority, static_cast<rule_action>(index), index % 17, _);
+        else if (index % 3 == 1)
+            builder.add(priority, static_cast<rule_action>(index), _, rule_range(index % 23, index % 23 + 4));
+        else
+            builder.add(priority, static_cast<rule_action>(index), rule_in({ index % 17, index % 13 }), index % 29);
+
+        reference.emplace_back(priority, index, index % 3, index);
+    }
+
+    const auto rules = builder.freeze();
+
+    const auto scan = [&](int a, int b) -> std::optional<rule_action>
+    {
+        std::optional<rule_action> best;
+        int best_priority = 0;
+
+        for (const auto& [priority, index, kind, action] : reference)
+        {
+            const bool matched = kind == 0 ? a == index % 17
+                : kind == 1 ? (b >= index % 23 && b <= index % 23 + 4)
+                : ((a == index % 17 || a == index % 13) && b == index % 29);
+
+            if (matched && (not best || priority > best_priority))
+            {
+                best = static_cast<rule_action>(action);
+                best_priority = priority;
+            }
+        }
+
+        return best;
+    };
+
+    for (int a = -1; a < 20; ++a)
+    {
+        for (int b = -1; b < 32; ++b)
+            CHECK(rules.match(a, b) == scan(a, b));
+    }
+}
+
+TEST_CASE("Rule image", "[rules]")
+{
+    enum class protocol : std::uint8_t { tcp, udp, quic };
+
+    rule_set_builder<std::string, int, protocol, std::uint64_t> builder;
+
+    builder
+        .add(10, 1, "GET", _, protocol::tcp, rule_range(std::uint64_t(8000), std::uint64_t(8999)))
+        .add(10, 2, rule_in({ "PUT", "POST" }), 443, _, _)
+        .add(20, 3, "GET", 443, rule_in({ protocol::tcp, protocol::quic }), _)
+        .add(0, 4, _, _, _, _)
+        .add(10, 5, "GET", rule_range(-5, 5), protocol::udp, std::uint64_t(1) << 40);
+
+    using image_type = rule_image<std::string, int, protocol, std::uint64_t>;
+    using mapped_type = mapped_rule_image<std::string, int, protocol, std::uint64_t>;
+    using other_type = rule_image<std::string, int, protocol, std::int64_t>;
+
+    const auto rules = builder.freeze();
+    const auto bytes = make_rule_image(rules);
+
+    rule_image_error error;
+    const auto image = image_type::open(bytes, &error);
+
+    REQUIRE(image.has_value());
+    CHECK(image->size() == rules.size());
+
+    for (std::size_t column = 0; column < 4; ++column)
+        CHECK(image->is_indexed(column) == rules.is_indexed(column));
+
+    for (const auto method : { "GET"sv, "PUT"sv, "POST"sv, "DELETE"sv, ""sv })
+    {
+        for (const int status : { -6, -5, 0, 5, 443, 500 })
+        {
+            for (const auto proto : { protocol::tcp, protocol::udp, protocol::quic })
+            {
+                for (const std::uint64_t port : { std::uint64_t(0), std::uint64_t(8000), std::uint64_t(8999), std::uint64_t(1) << 40 })
+                    CHECK(image->match(method, status, proto, port) == rules.match(method, status, proto, port));
+            }
+        }
+    }
+
+    // Same image read back through a mapping of its file
+    const auto path = std::filesystem::temp_directory_path() / "patum_rule_image_test.bin";
+
+    REQUIRE(save_rule_image(rules, path, &error));
+
+    {
+        const auto mapped = mapped_type::open(path, &error);
+
+        REQUIRE(mapped.has_value());
+        CHECK(std::ranges::equal(mapped->image().bytes(), bytes));
+        CHECK(mapped->match("GET"s, 443, protocol::quic, std::uint64_t(1)) == 3u);
+        CHECK(mapped->match("GET"sv, 3, protocol::udp, std::uint64_t(1) << 40) == 5u);
+        CHECK(mapped->match("DELETE"sv, 0, protocol::tcp, std::uint64_t(0)) == 4u);
+    }
+
+    std::filesystem::remove(path);
+
+    CHECK_FALSE(mapped_type::open(path, &error).has_value());
+
+    // Images are rejected when truncated, altered or read with other columns
+    CHECK_FALSE(image_type::open(std::span(bytes).first(bytes.size() - 1), &error).has_value());
+    CHECK(error.message == "Rule image is truncated");
+
+    CHECK_FALSE(other_type::open(bytes, &error).has_value());
+    CHECK(error.message == "Rule image columns differ from the rule set");
+
+    CHECK_FALSE((rule_image<std::string, int>::open(bytes, &error).has_value()));
+    CHECK(error.message == "Rule image columns differ from the rule set");
+
+    auto altered = bytes;
+    altered[0] = std::byte{ 'X' };
+
+    CHECK_FALSE(image_type::open(altered, &error).has_value());
+    CHECK(error.message == "Not a rule image");
+
+    // Images whose sections hold kinds or indices out of range are rejected, not matched out of bounds
+    const auto corrupted = [&](std::size_t column, auto&& alter)
+    {
+        auto copy = bytes;
+
+        rule_image_column_header h;
+        std::memcpy(&h, copy.data() + sizeof(rule_image_header) + column * sizeof(h), sizeof(h));
+        alter(copy.data(), h);
+
+        const auto result = image_type::open(copy, &error);
+        return not result.has_value() && error.message == "Rule image is corrupted";
+    };
+
+    const auto at = []<class E>(std::byte* data, const rule_image_section& section, std::type_identity<E>, std::size_t index)
+    {
+        return reinterpret_cast<E*>(data + section.offset) + index;
+    };
+
+    CHECK(corrupted(1, [&](std::byte* data, const auto& h) { at(data, h.conditions, std::type_identity<rule_image_condition>{}, 0)->kind = 7; }));
+    CHECK(corrupted(1, [&](std::byte* data, const auto& h) { at(data, h.conditions, std::type_identity<rule_image_condition>{}, 0)->offset = 1u << 30; }));
+    CHECK(corrupted(0, [&](std::byte* data, const auto& h) { at(data, h.conditions, std::type_identity<rule_image_condition>{}, 1)->count = 1000; }));
+    CHECK(corrupted(0, [&](std::byte* data, const auto& h) { at(data, h.values, std::type_identity<rule_image_string>{}, 0)->size = 1000; }));
+    CHECK(corrupted(0, [&](std::byte* data, const auto& h) { *at(data, h.postings, std::type_identity<std::uint32_t>{}, 0) = 5; }));
+    CHECK(corrupted(2, [&](std::byte* data, const auto& h) { *at(data, h.unindexed, std::type_identity<std::uint32_t>{}, 0) = 1000; }));
+
+    CHECK(corrupted(0, [&](std::byte* data, const auto& h)
+    {
+        for (std::size_t index = 0; index < h.slots.count; ++index)
+        {
+            if (auto* slot = at(data, h.slots, std::type_identity<rule_image_slot>{}, index); slot->value != rule_image_empty_slot)
+                slot->offset = 1000;
+        }
+    }));
+
+    CHECK(corrupted(0, [&](std::byte* data, const auto& h)
+    {
+        for (std::size_t index = 0; index < h.slots.count; ++index)
+        {
+            if (auto* slot = at(data, h.slots, std::type_identity<rule_image_slot>{}, index); slot->value != rule_image_empty_slot)
+                slot->value = static_cast<std::uint32_t>(h.values.count);
+        }
+    }));
+}
+
+TEST_CASE("Rule image matches like its rule set", "[rules]")
+{
+    rule_set_builder<int, int> builder;
+
+    for (int index = 0; index < 300; ++index)
+    {
+        const int priority = index % 7;
+
+        if (index % 3 == 0)
+            builder.add(priority, static_cast<rule_action>(index), index % 17, _);
+        else if (index % 3 == 1)
+            builder.add(priority, static_cast<rule_action>(index), _, rule_range(index % 23, index % 23 + 4));
+        else
+            builder.add(priority, static_cast<rule_action>(index), rule_in({ index % 17, index % 13 }), index % 29);
+    }
+
+    const auto rules = builder.freeze();
+    const auto bytes = make_rule_image(rules);
+    const auto image = rule_image<int, int>::open(bytes);
+
+    REQUIRE(image.has_value());
+
+    for (int a = -1; a < 20; ++a)
+    {
+        for (int b = -1; b < 32; ++b)
+            CHECK(image->match(a, b) == rules.match(a, b));
+    }
+
+    rule_set_builder<int> unindexed;
+    unindexed.add(0, 7, rule_range(1, 5)).add(1, 8, rule_range(4, 9));
+
+    const auto ranges_bytes = make_rule_image(unindexed.freeze());
+    const auto ranges = rule_image<int>::open(ranges_bytes);
+
+    REQUIRE(ranges.has_value());
+    CHECK_FALSE(ranges->is_indexed(0));
+    CHECK(ranges->match(4) == 8u);
+    CHECK(ranges->match(2) == 7u);
+    CHECK_FALSE(ranges->match(10).has_value());
+}
+
+TEST_CASE("Rule handle", "[rules]")
+{
+    const auto make_rules = [](rule_action action)
+    {
+        rule_set_builder<int> builder;
+        builder.add(0, action, rule_range(0, 9));
+        return builder.freeze();
+    };
+
+    rule_handle<rule_set<int>> handle(make_rules(1), 2);
+    auto reader = *handle.reader();
+
+    CHECK(handle.version() == 0);
+    CHECK(reader.match(5) == 1u);
+    CHECK_FALSE(reader.match(10).has_value());
+
+    handle.publish(make_rules(2));
+
+    CHECK(handle.version() == 1);
+    CHECK(handle.pending() == 0);
+    CHECK(reader.match(5) == 2u);
+
+    // A reader still matching holds its version, nested reads included, until the outermost read is over
+    reader.read([&](const rule_set<int>& rules)
+    {
+        handle.publish(make_rules(3));
+        handle.publish(make_rules(4));
+
+        CHECK(handle.pending() == 2);
+        CHECK(rules.match(5) == 2u);
+        CHECK(reader.match(5) == 4u);
+        CHECK(handle.reclaim() == 2);
+    });
+
+    CHECK(handle.reclaim() == 0);
+    CHECK(reader.match(5) == 4u);
+
+    // Readers started after a swap do not hold the versions retired before it
+    auto other = *handle.reader();
+
+    reader.read([&](const rule_set<int>&)
+    {
+        other.read([&](const rule_set<int>& rules)
+        {
+            handle.publish(make_rules(5));
+            CHECK(handle.pending() == 1);
+            CHECK(rules.match(5) == 4u);
+        });
+
+        CHECK(handle.reclaim() == 1);
+    });
+
+    CHECK(handle.reclaim() == 0);
+
+    // No reader is given once every slot is taken, until one of them is destroyed
+    CHECK_FALSE(handle.reader().has_value());
+
+    {
+        const auto released = std::move(other);
+    }
+
+    CHECK(handle.reader().has_value());
+}
+
+TEST_CASE("Rule handle swapped while matching", "[rules]")
+{
+    const auto make_rules = [](int version)
+    {
+        rule_set_builder<int, int> builder;
+
+        // Every rule of a version answers with the version, so a reader only ever sees whole versions
+        for (int index = 0; index < 64; ++index)
+            builder.add(index % 5, static_cast<rule_action>(version), index, rule_range(0, index));
+
+        return builder.freeze();
+    };
+
+    rule_handle<rule_set<int, int>> handle(make_rules(0), 4);
+
+    std::atomic<bool> stop = false;
+    std::atomic<int> mismatches = 0;
+    std::vector<std::thread> readers;
+
+    for (int thread = 0; thread < 3; ++thread)
+    {
+        readers.emplace_back([&, reader = *handle.reader()]
+        {
+            rule_action last = 0;
+
+            for (int index = 0; not stop.load(std::memory_order_relaxed); ++index)
+            {
+                const auto action = reader.match(index % 64, index % 64);
+
+                if (not action || *action < last)
+                    ++mismatches;
+
+                last = action.value_or(last);
+            }
+        });
+    }
+
+    for (int version = 1; version <= 200; ++version)
+        handle.publish(make_rules(version));
+
+    stop = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    CHECK(mismatches == 0);
+    CHECK(handle.reclaim() == 0);
+    CHECK(handle.reader()->match(3, 3) == 200u);
+}
+
+TEST_CASE("Rule script", "[rules]")
+{
+    struct request
+    {
+        std::string method;
+        int status = 0;
+        int port = 0;
+    };
+
+    rule_fields<request> fields;
+    fields.add("method", &request::method)
+          .add("status", &request::status)
+          .add("port", [](const request& r) { return r.port; });
+
+    rule_script_error error;
+    const auto program = compile_rules(fields, R"(
+        // Arms are tried in order
+        match(method, status, port)
+
+        pattern("GET", range(200, 299))                     = 1
+        pattern(in("PUT", "POST"), _x >= 500)               = 2;
+        pattern(_, !(_x == 404) && (_x < 100 || 599 < _x))  = 3
+        pattern(_, 404, _x != 8080)                         = 4
+        pattern(_, _, in(80, 443))                          = 5
+        pattern("HEAD")                                     = 6
+    )", &error);
+
+    REQUIRE(program.has_value());
+    CHECK(error.message.empty());
+
+    const auto reference = [](const request& r) -> std::optional<rule_action>
+    {
+        return match(r.method, r.status, r.port)(
+            pattern("GET", range(200, 299), _) = 1u,
+            pattern(in("PUT", "POST"), _x >= 500, _) = 2u,
+            pattern(_, !(_x == 404) && (_x < 100 || _x > 599), _) = 3u,
+            pattern(_, 404, _x != 8080) = 4u,
+            pattern(_, _, in(80, 443)) = 5u,
+            pattern("HEAD", _, _) = 6u);
+    };
+
+    for (const std::string method : { "GET", "PUT", "POST", "DELETE", "HEAD" })
+    {
+        for (const int status : { 0, 99, 100, 200, 250, 299, 404, 500, 599, 600 })
+        {
+            for (const int port : { 80, 443, 8080, 9000 })
+            {
+                const request r{ method, status, port };
+                CHECK(program->match(r) == reference(r));
+            }
+        }
+    }
+
+    const auto copy = *program;
+    CHECK(copy.match(request{ "GET", 200, 80 }) == 1u);
+    CHECK_FALSE(copy.match(request{ "DELETE", 404, 8080 }).has_value());
+
+    CHECK_FALSE(compile_rules(fields, "match(method)\npattern(42) = 1", &error).has_value());
+    CHECK(error.line == 2);
+    CHECK(error.column == 9);
+
+    CHECK_FALSE(compile_rules(fields, "match(verb)", &error).has_value());
+    CHECK(error.message == "Unknown field 'verb'");
+
+    CHECK_FALSE(compile_rules(fields, "match(status) pattern(range(5, 1)) = 1", &error).has_value());
+    CHECK_FALSE(compile_rules(fields, "match(status) pattern(_, _) = 1", &error).has_value());
+    CHECK_FALSE(compile_rules(fields, "match(status) pattern(_) = -1", &error).has_value());
+
+    // Nesting is bounded instead of overflowing the stack of the parser
+    CHECK_FALSE(compile_rules(fields, "match(status) pattern(" + std::string(1000000, '(') + "1", &error).has_value());
+    CHECK(error.message == "Patterns nest too deeply");
+
+    CHECK_FALSE(compile_rules(fields, "match(status) pattern(" + std::string(1000000, '!') + "1) = 1", &error).has_value());
+    CHECK(error.message == "Patterns nest too deeply");
+
+    std::string chain = "match(status) pattern(1";
+    for (std::size_t index = 0; index < rule_script_max_depth + 1; ++index)
+        chain += " || 1";
+
+    CHECK_FALSE(compile_rules(fields, chain + ") = 1", &error).has_value());
+    CHECK(error.message == "Patterns nest too deeply");
+
+    const std::string nested = std::string(rule_script_max_depth, '(') + "1" + std::string(rule_script_max_depth, ')');
+    CHECK(compile_rules(fields, "match(status) pattern(" + nested + ") = 1").has_value());
+
+    // Null strings read as empty ones
+    struct named
+    {
+        const char* name = nullptr;
+    };
+
+    rule_fields<named> names;
+    names.add("name", &named::name);
+
+    const auto by_name = compile_rules(names, R"(
+        match(name)
+        pattern("") = 1
+        pattern(_)  = 2
+    )");
+
+    REQUIRE(by_name.has_value());
+    CHECK(by_name->match(named{}) == 1u);
+    CHECK(by_name->match(named{ "x" }) == 2u);
+}
+
+TEST_CASE("Rule script destructuring", "[rules]")
+{
+    struct endpoint
+    {
+        std::string host;
+        int port = 0;
+    };
+
+    struct request
+    {
+        std::string method;
+        endpoint peer;
+    };
+
+    rule_fields<request> fields;
+    fields.add("method", &request::method)
+          .add("host", [](const request& r) -> const std::string& { return r.peer.host; })
+          .add("port", [](const request& r) { return r.peer.port; })
+          .add_group("peer", { "host", "port" });
+
+    rule_script_error error;
+    const auto program = compile_rules(fields, R"(
+        match(method, peer)
+
+        pattern("GET", ds("localhost", _x >= 1024))     = 1
+        pattern(_, ds(_, 80) || ds(_, 443))             = 2
+        pattern("PUT", !ds("localhost"))                = 3
+        pattern(_, _)                                   = 0
+    )", &error);
+
+    REQUIRE(program.has_value());
+    CHECK(error.message.empty());
+
+    const auto reference = [](const request& r) -> std::optional<rule_action>
+    {
+        return match(r.method, std::tie(r.peer.host, r.peer.port))(
+            pattern("GET", ds("localhost", _x >= 1024)) = 1u,
+            pattern(_, ds(_, 80) || ds(_, 443)) = 2u,
+            pattern("PUT", !ds("localhost", _)) = 3u,
+            pattern(_, _) = 0u);
+    };
+
+    for (const std::string method : { "GET", "PUT", "DELETE" })
+    {
+        for (const std::string host : { "localhost", "example.com" })
+        {
+            for (const int port : { 80, 443, 1023, 1024, 8080 })
+            {
+                const request r{ method, { host, port } };
+                CHECK(program->match(r) == reference(r));
+            }
+        }
+    }
+
+    CHECK_FALSE(compile_rules(fields, "match(peer) pattern(\"localhost\") = 1", &error).has_value());
+    CHECK(error.message == "Expected ds(...) or _ for the group 'peer'");
+
+    CHECK_FALSE(compile_rules(fields, "match(peer) pattern(ds(_, 80, 1)) = 1", &error).has_value());
+    CHECK_FALSE(compile_rules(fields, "match(port) pattern(ds(80)) = 1", &error).has_value());
+
+    rule_fields<request> broken;
+    broken.add_group("peer", { "host" });
+
+    CHECK_FALSE(compile_rules(broken, "match(peer)", &error).has_value());
+    CHECK(error.message == "Unknown field 'host'");
+}